@@ -95,7 +95,12 @@ ulong opt_binlog_rows_event_max_size;
 ulonglong test_flags = 0;
 ulong opt_binlog_rows_event_max_encoded_size= MAX_MAX_ALLOWED_PACKET;
 static uint opt_protocol= 0;
-static FILE *result_file;
+/*
+  With --parallel, each worker thread writes the output of its binlog file to
+  its own temporary file, so result_file and the other state of the binlog
+  being decoded is per thread.
+*/
+static thread_local FILE *result_file;
 static char *result_file_name= 0;
 static const char *output_prefix= "";
 static char **defaults_argv= 0;
@@ -148,7 +153,7 @@ static uint verbose= 0;
 static char *ignore_domain_ids_str, *do_domain_ids_str;
 static char *ignore_server_ids_str, *do_server_ids_str;
 static char *start_pos_str, *stop_pos_str;
-static ulonglong start_position= BIN_LOG_HEADER_SIZE,
+static thread_local ulonglong start_position= BIN_LOG_HEADER_SIZE,
                  stop_position= (longlong)(~(my_off_t)0) ;
 #define start_position_mot ((my_off_t)start_position)
 #define stop_position_mot  ((my_off_t)stop_position)
@@ -160,8 +165,10 @@ static Domain_gtid_event_filter *domain_id_gtid_filter= NULL;
 static Server_gtid_event_filter *server_id_gtid_filter= NULL;
 
 static char *start_datetime_str, *stop_datetime_str;
-static my_time_t start_datetime= 0, stop_datetime= MY_TIME_T_MAX;
-static ulonglong rec_count= 0;
+static thread_local my_time_t start_datetime= 0;
+static my_time_t stop_datetime= MY_TIME_T_MAX;
+static thread_local ulonglong rec_count= 0;
+static uint opt_parallel= 1;
 static MYSQL* mysql = NULL;
 static const char* dirname_for_local_load= 0;
 static bool opt_skip_annotate_row_events= 0;
@@ -179,7 +186,7 @@ static char *flashback_review_dbname, *flashback_review_tablename;
   This will be changed each time a new Format_description_log_event is
   found in the binlog. It is finally destroyed at program termination.
 */
-static Format_description_log_event* glob_description_event= NULL;
+static thread_local Format_description_log_event* glob_description_event= NULL;
 
 /**
   Exit status for functions in this file.
@@ -202,7 +209,7 @@ enum Exit_status {
   Also because of that when reading a remote Annotate event we have to keep
   its binary log representation in a separately allocated buffer.
 */
-static Annotate_rows_log_event *annotate_event= NULL;
+static thread_local Annotate_rows_log_event *annotate_event= NULL;
 
 static void free_annotate_event()
 {
@@ -551,7 +558,7 @@ Exit_status Load_log_processor::process(Append_block_log_event *ae)
 }
 
 
-static Load_log_processor load_processor;
+static thread_local Load_log_processor load_processor;
 
 
 /**
@@ -829,13 +836,61 @@ static bool print_row_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
 */
 static inline my_bool is_server_id_excluded(uint32 server_id)
 {
-  static rpl_gtid server_tester_gtid;
+  static thread_local rpl_gtid server_tester_gtid;
   server_tester_gtid.server_id= server_id;
   return server_id_gtid_filter == NULL
              ? FALSE // No server id filter exists
              : server_id_gtid_filter->exclude(&server_tester_gtid);
 }
 
+/*
+  We use Gtid_list_log_event information to determine if there is missing
+  data between where a user expects events to start/stop (i.e. the GTIDs
+  provided by --start-position and --stop-position), and the true start of
+  the specified binary logs. The first GLLE provides the initial state of the
+  binary logs.
+
+  If --start-position is provided as a file offset, we want to skip initial
+  GTID state verification. Set in main(), and for --parallel by the worker of
+  the first file.
+*/
+static thread_local my_bool was_first_glle_processed;
+
+
+/**
+  A binlog file decoded by a --parallel worker thread.
+*/
+struct Parallel_file
+{
+  const char *logname;
+  /* The output of the file, in a temporary file */
+  FILE *output;
+  Exit_status status;
+  bool done;
+  /*
+    The GTIDs that gtid_state_validator should see, which the main thread
+    feeds to it in the order of the files.
+  */
+  DYNAMIC_ARRAY gtids;
+  rpl_gtid *first_gtid_list;
+  uint32 first_gtid_list_count;
+};
+
+/* The file of a --parallel worker thread, NULL in the main thread. */
+static thread_local Parallel_file *parallel_file= NULL;
+
+static Parallel_file *parallel_files;
+static uint parallel_file_count;
+/* The next file to be decoded, and the number of files already output */
+static uint parallel_next_file, parallel_merged_files;
+static bool parallel_abort;
+static pthread_mutex_t parallel_lock;
+static pthread_cond_t parallel_cond;
+/* The values given by the user, that only apply to some of the files */
+static ulonglong parallel_start_position, parallel_stop_position;
+static my_time_t parallel_start_datetime;
+
+
 /**
   Print the given event, and either delete it or delegate the deletion
   to someone else.
@@ -867,18 +922,6 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
   Exit_status retval= OK_CONTINUE;
   IO_CACHE *const head= &print_event_info->head_cache;
 
-  /*
-    We use Gtid_list_log_event information to determine if there is missing
-    data between where a user expects events to start/stop (i.e. the GTIDs
-    provided by --start-position and --stop-position), and the true start of
-    the specified binary logs. The first GLLE provides the initial state of the
-    binary logs.
-
-    If --start-position is provided as a file offset, we want to skip initial
-    GTID state verification
-  */
-  static my_bool was_first_glle_processed= start_position > BIN_LOG_HEADER_SIZE;
-
   /* Bypass flashback settings to event */
   ev->is_flashback= opt_flashback;
 #ifdef WHEN_FLASHBACK_REVIEW_READY
@@ -901,8 +944,17 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
     */
     if (gtid_state_validator && !was_first_glle_processed && glev->count)
     {
-      if (gtid_state_validator->initialize_gtid_state(stderr, glev->list,
-                                                     glev->count))
+      if (parallel_file)
+      {
+        /* The main thread initializes the validator, in file order */
+        if (!(parallel_file->first_gtid_list= (rpl_gtid*)
+              my_memdup(PSI_NOT_INSTRUMENTED, glev->list,
+                        glev->count * sizeof(rpl_gtid), MYF(MY_WME))))
+          goto err;
+        parallel_file->first_gtid_list_count= glev->count;
+      }
+      else if (gtid_state_validator->initialize_gtid_state(stderr, glev->list,
+                                                          glev->count))
         goto err;
 
       if (position_gtid_filter &&
@@ -981,6 +1033,12 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
         */
         gtid_state_validator= NULL;
       }
+      else if (parallel_file)
+      {
+        /* Recorded by the main thread, in file order */
+        if (insert_dynamic(&parallel_file->gtids, (uchar*) &ev_gtid))
+          goto err;
+      }
       else
       {
         gtid_err= gtid_state_validator->record(&ev_gtid);
@@ -1016,7 +1074,8 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
         decreasing, we do this to avoid cutting the middle).
       */
       start_datetime= 0;
-      offset= 0; // print everything and protect against cycling rec_count
+      if (offset)
+        offset= 0; // print everything and protect against cycling rec_count
       /*
         Skip events according to the --server-id flag.  However, don't
         skip format_description or rotate events, because they they
@@ -1344,6 +1403,51 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
         destroy_evt= FALSE;
       break;
     }
+    case TRANSACTION_PAYLOAD_EVENT:
+    {
+      /*
+        Process the events inside the payload as if they were in the binlog
+        at the position of the Transaction_payload event.
+      */
+      static thread_local Transaction_payload_reader payload_reader;
+      if (ev->print(result_file, print_event_info) ||
+          payload_reader.init((Transaction_payload_log_event*) ev))
+        goto err;
+      for (;;)
+      {
+        uchar *event, *event_copy;
+        uint event_len;
+        const char *errmsg;
+        Log_event *inner_ev;
+
+        if (payload_reader.next(&event, &event_len))
+        {
+          error("Could not uncompress the Transaction_payload event at "
+                "position %s.", llstr(pos, ll_buff));
+          goto err;
+        }
+        if (!event)
+          break;
+        if (!(event_copy= (uchar*) my_memdup(PSI_NOT_INSTRUMENTED, event,
+                                             event_len, MYF(MY_WME))))
+          goto err;
+        if (!(inner_ev= Log_event::read_log_event(event_copy, event_len,
+                                                  &errmsg,
+                                                  glob_description_event,
+                                                  opt_verify_binlog_checksum)))
+        {
+          my_free(event_copy);
+          error("Could not read an event inside the Transaction_payload "
+                "event at position %s: %s", llstr(pos, ll_buff), errmsg);
+          goto err;
+        }
+        inner_ev->register_temp_buf(event_copy, TRUE);
+        if ((retval= process_event(print_event_info, inner_ev, pos,
+                                   logname)) != OK_CONTINUE)
+          goto end;
+      }
+      break;
+    }
     case START_ENCRYPTION_EVENT:
       glob_description_event->start_decryption((Start_encryption_log_event*)ev);
       /* fall through */
@@ -1491,6 +1595,11 @@ static struct my_option my_options[] =
    GET_STR_ALLOC, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
   {"offset", 'o', "Skip the first N entries.", &offset, &offset,
    0, GET_ULL, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
+  {"parallel", 0, "Decode up to N local binlog files at the same time, "
+   "each in its own thread; the output is the same as without it. "
+   "Ignored with --read-from-remote-server, --flashback, --offset, "
+   "the GTID filtering options, -vvv or when reading from stdin.",
+   &opt_parallel, &opt_parallel, 0, GET_UINT, REQUIRED_ARG, 1, 1, 256, 0, 1, 0},
   {"password", 'p', "Password to connect to remote server.",
    0, 0, 0, GET_STR, OPT_ARG, 0, 0, 0, 0, 0, 0},
   {"plugin_dir", 0, "Directory for client-side plugins.",
@@ -2400,19 +2509,6 @@ static Exit_status dump_log_entries(const char* logname)
   if (!opt_raw_mode)
     fprintf(result_file, "DELIMITER /*!*/;\n");
   strmov(print_event_info.delimiter, "/*!*/;");
-  
-  if (short_form)
-  {
-    if (!print_row_event_positions_used)
-      print_row_event_positions= 0;
-    if (!print_row_count_used)
-      print_row_count = 0;
-  }
-  if (opt_flashback)
-  {
-    if (!print_row_event_positions_used)
-      print_row_event_positions= 0;
-  }
 
   print_event_info.verbose= short_form ? 0 : verbose;
   print_event_info.short_form= short_form;
@@ -2433,6 +2529,250 @@ static Exit_status dump_log_entries(const char* logname)
 }
 
 
+/**
+  Decodes one binlog file in a --parallel worker thread, into a
+  temporary file.
+
+  @param[in,out] pf The file to decode.
+
+  @param[in] idx The index of the file in the files given by the user.
+
+  @retval ERROR_STOP An error occurred - the program should terminate.
+  @retval OK_CONTINUE No error, the program should continue.
+  @retval OK_STOP No error, but the end of the specified range of
+  events to process has been reached and the program should terminate.
+*/
+static Exit_status dump_parallel_file(Parallel_file *pf, uint idx)
+{
+  char path[FN_REFLEN];
+  File fd;
+  Exit_status retval;
+
+  /* --start-position applies to the first log, --stop-position to the last */
+  start_position= idx ? BIN_LOG_HEADER_SIZE : parallel_start_position;
+  stop_position= idx + 1 < parallel_file_count ? (ulonglong) ~(my_off_t) 0
+                                               : parallel_stop_position;
+  start_datetime= parallel_start_datetime;
+  was_first_glle_processed= idx ? TRUE
+                                : start_position > BIN_LOG_HEADER_SIZE;
+
+  if ((fd= create_temp_file(path, NullS, "mbl", O_BINARY,
+                            MYF(MY_WME | MY_TEMPORARY))) < 0)
+    return ERROR_STOP;
+  if (!(pf->output= my_fdopen(fd, path, O_RDWR | O_BINARY, MYF(MY_WME))))
+  {
+    my_close(fd, MYF(0));
+    return ERROR_STOP;
+  }
+  if (load_processor.init())
+    return ERROR_STOP;
+  if (dirname_for_local_load)
+    load_processor.init_by_dir_name(dirname_for_local_load);
+  else
+    load_processor.init_by_cur_dir();
+
+  parallel_file= pf;
+  result_file= pf->output;
+  retval= dump_log_entries(pf->logname);
+  fflush(result_file);
+  result_file= NULL;
+  parallel_file= NULL;
+
+  free_annotate_event();
+  delete glob_description_event;
+  glob_description_event= NULL;
+  load_processor.destroy();
+  return retval;
+}
+
+
+pthread_handler_t parallel_dump_thread(void *)
+{
+  my_thread_init();
+  for (;;)
+  {
+    uint idx;
+
+    /* Do not get too far ahead of the files being output */
+    pthread_mutex_lock(&parallel_lock);
+    while (!parallel_abort && parallel_next_file < parallel_file_count &&
+           parallel_next_file >= parallel_merged_files + 2 * opt_parallel)
+      pthread_cond_wait(&parallel_cond, &parallel_lock);
+    if (parallel_abort || parallel_next_file == parallel_file_count)
+    {
+      pthread_mutex_unlock(&parallel_lock);
+      break;
+    }
+    idx= parallel_next_file++;
+    pthread_mutex_unlock(&parallel_lock);
+
+    Exit_status status= dump_parallel_file(&parallel_files[idx], idx);
+
+    pthread_mutex_lock(&parallel_lock);
+    parallel_files[idx].status= status;
+    parallel_files[idx].done= true;
+    pthread_cond_broadcast(&parallel_cond);
+    pthread_mutex_unlock(&parallel_lock);
+  }
+  my_thread_end();
+  return 0;
+}
+
+
+/**
+  Outputs a file decoded by a --parallel worker thread, after feeding
+  its GTIDs to gtid_state_validator.
+
+  @retval ERROR_STOP An error occurred - the program should terminate.
+  @retval OK_CONTINUE No error, the program should continue.
+  @retval OK_STOP No error, but the end of the specified range of
+  events to process has been reached and the program should terminate.
+*/
+static Exit_status merge_parallel_file(Parallel_file *pf)
+{
+  uchar buff[IO_SIZE * 16];
+  size_t length;
+  Exit_status retval= pf->status;
+
+  if (retval == ERROR_STOP)
+    return retval;
+
+  if (gtid_state_validator)
+  {
+    if (pf->first_gtid_list &&
+        gtid_state_validator->initialize_gtid_state(stderr,
+                                                    pf->first_gtid_list,
+                                                    pf->first_gtid_list_count))
+      return ERROR_STOP;
+    for (size_t i= 0; i < pf->gtids.elements; i++)
+    {
+      if (gtid_state_validator->record(dynamic_element(&pf->gtids, i,
+                                                       rpl_gtid*)) &&
+          opt_gtid_strict_mode)
+      {
+        gtid_state_validator->report(stderr, opt_gtid_strict_mode);
+        return ERROR_STOP;
+      }
+    }
+  }
+
+  if (my_fseek(pf->output, 0, MY_SEEK_SET, MYF(MY_WME)) == MY_FILEPOS_ERROR)
+    return ERROR_STOP;
+  while ((length= fread(buff, 1, sizeof(buff), pf->output)))
+  {
+    if (my_fwrite(result_file, buff, length, MYF(MY_WME | MY_NABP)))
+      return ERROR_STOP;
+  }
+  if (ferror(pf->output))
+  {
+    error("Could not read the output of '%s' from its temporary file.",
+          pf->logname);
+    return ERROR_STOP;
+  }
+  return retval;
+}
+
+
+/**
+  Decodes the given local binlogs with --parallel worker threads, and
+  outputs them in order.
+
+  The per-log state (the Format_description event, the positions, the
+  output file...) is thread local; what process_event() does with the
+  global state that depends on the previous logs (the GTID state
+  validation) is deferred to the main thread, which outputs the logs.
+
+  @param[in] logs Names of input binlogs.
+
+  @param[in] count Number of input binlogs.
+
+  @retval ERROR_STOP An error occurred - the program should terminate.
+  @retval OK_CONTINUE No error, the program should continue.
+  @retval OK_STOP No error, but the end of the specified range of
+  events to process has been reached and the program should terminate.
+*/
+static Exit_status dump_log_files_parallel(char **logs, uint count)
+{
+  Exit_status retval= OK_CONTINUE;
+  pthread_t *threads;
+  uint thread_count= 0, i;
+
+  if (!(parallel_files= (Parallel_file*)
+        my_malloc(PSI_NOT_INSTRUMENTED, count * sizeof(Parallel_file),
+                  MYF(MY_WME | MY_ZEROFILL))) ||
+      !(threads= (pthread_t*)
+        my_malloc(PSI_NOT_INSTRUMENTED, opt_parallel * sizeof(pthread_t),
+                  MYF(MY_WME))))
+  {
+    my_free(parallel_files);
+    return ERROR_STOP;
+  }
+  for (i= 0; i < count; i++)
+  {
+    parallel_files[i].logname= logs[i];
+    my_init_dynamic_array(PSI_NOT_INSTRUMENTED, &parallel_files[i].gtids,
+                          sizeof(rpl_gtid), 16, 64, MYF(0));
+  }
+  parallel_file_count= count;
+  parallel_next_file= parallel_merged_files= 0;
+  parallel_abort= false;
+  pthread_mutex_init(&parallel_lock, NULL);
+  pthread_cond_init(&parallel_cond, NULL);
+
+  for (i= 0; i < opt_parallel && i < count; i++)
+  {
+    if (pthread_create(&threads[thread_count], NULL, parallel_dump_thread,
+                       NULL))
+      warning("Could not create a --parallel thread");
+    else
+      thread_count++;
+  }
+  if (!thread_count)
+  {
+    error("Could not create any --parallel thread");
+    retval= ERROR_STOP;
+  }
+
+  for (i= 0; thread_count && i < count; i++)
+  {
+    Parallel_file *pf= &parallel_files[i];
+
+    pthread_mutex_lock(&parallel_lock);
+    while (!pf->done)
+      pthread_cond_wait(&parallel_cond, &parallel_lock);
+    pthread_mutex_unlock(&parallel_lock);
+
+    retval= merge_parallel_file(pf);
+
+    pthread_mutex_lock(&parallel_lock);
+    parallel_merged_files= i + 1;
+    if (retval != OK_CONTINUE)
+      parallel_abort= true;
+    pthread_cond_broadcast(&parallel_cond);
+    pthread_mutex_unlock(&parallel_lock);
+    if (retval != OK_CONTINUE)
+      break;
+  }
+
+  for (i= 0; i < thread_count; i++)
+    pthread_join(threads[i], NULL);
+
+  for (i= 0; i < count; i++)
+  {
+    if (parallel_files[i].output)
+      my_fclose(parallel_files[i].output, MYF(0));
+    delete_dynamic(&parallel_files[i].gtids);
+    my_free(parallel_files[i].first_gtid_list);
+  }
+  pthread_cond_destroy(&parallel_cond);
+  pthread_mutex_destroy(&parallel_lock);
+  my_free(threads);
+  my_free(parallel_files);
+  parallel_files= NULL;
+  return retval;
+}
+
+
 /**
   When reading a remote binlog, this function is used to grab the
   Format_description_log_event in the beginning of the stream.
@@ -3058,6 +3398,106 @@ static Exit_status check_header(IO_CACHE* file,
 }
 
 
+/**
+  Skip an event of a local binlog without decoding it, when its header
+  alone shows that process_event() would print nothing for it.
+
+  This is the case for the events of an event group excluded by the GTID
+  filters, and for the row events (but the last one of the statement) of a
+  table excluded by --database or --table. The side effects process_event()
+  would have for such an event (the event count for --offset, the "# at"
+  line of --print-row-event-positions) are applied here.
+
+  With --verify-binlog-checksum every event is read and verified, so that
+  a corrupt event is reported even when it would not be printed.
+
+  @param[in,out] print_event_info Parameters and context state
+  determining how to print.
+
+  @param file The binlog, positioned at the start of the event.
+
+  @param pos The position of the event.
+
+  @retval true The event was skipped; the file is positioned after it.
+  @retval false The event must be read and processed (this includes read
+  errors, which are then reported by the caller); the file is positioned
+  back at its start.
+*/
+static bool skip_undecoded_event(PRINT_EVENT_INFO *print_event_info,
+                                IO_CACHE *file, my_off_t pos)
+{
+  uchar header[LOG_EVENT_HEADER_LEN + ROWS_HEADER_LEN_V1];
+  Log_event_type type;
+  ulong data_len;
+
+  if (opt_verify_binlog_checksum ||
+      glob_description_event->crypto_data.scheme ||
+      glob_description_event->common_header_len != LOG_EVENT_HEADER_LEN)
+    return false;
+  if (my_b_read(file, header, LOG_EVENT_HEADER_LEN))
+    goto read_event;
+  type= (Log_event_type) header[EVENT_TYPE_OFFSET];
+  data_len= uint4korr(header + EVENT_LEN_OFFSET);
+  if (data_len < LOG_EVENT_HEADER_LEN || pos + data_len > file->end_of_file)
+    goto read_event;
+
+  if (!print_event_info->is_event_group_active())
+  {
+    if (type == GTID_EVENT || !Log_event::is_group_event(type))
+      goto read_event;
+    goto skip;                                  // Not counted for --offset
+  }
+
+  if (!opt_flashback && print_event_info->m_table_map_ignored.count() &&
+      (LOG_EVENT_IS_WRITE_ROW(type) || LOG_EVENT_IS_UPDATE_ROW(type) ||
+       LOG_EVENT_IS_DELETE_ROW(type)) &&
+      glob_description_event->post_header_len[type - 1] >= ROWS_HEADER_LEN_V1 &&
+      data_len >= sizeof(header))
+  {
+    char ll_buff[21];
+    my_time_t when= uint4korr(header);
+    uchar *post_header= header + LOG_EVENT_HEADER_LEN;
+
+    if (my_b_read(file, post_header, ROWS_HEADER_LEN_V1))
+      goto read_event;
+    if ((uint2korr(post_header + RW_FLAGS_OFFSET) &
+         Rows_log_event::STMT_END_F) ||
+        !print_event_info->m_table_map_ignored.
+          get_table(uint6korr(post_header + RW_MAPID_OFFSET)) ||
+        when >= stop_datetime || pos >= stop_position_mot)
+      goto read_event;
+
+    if (rec_count >= offset && when >= start_datetime)
+    {
+      start_datetime= 0;
+      if (offset)
+        offset= 0;
+      if (!is_server_id_excluded(uint4korr(header + SERVER_ID_OFFSET)))
+      {
+        if (print_row_event_positions)
+          fprintf(result_file, "# at %s\n", llstr(pos, ll_buff));
+        if (!print_event_info->found_row_event)
+        {
+          print_event_info->found_row_event= 1;
+          print_event_info->row_events= 0;
+        }
+      }
+    }
+    rec_count++;
+    goto skip;
+  }
+
+read_event:
+  file->error= 0;
+  my_b_seek(file, pos);
+  return false;
+
+skip:
+  my_b_seek(file, pos + data_len);
+  return true;
+}
+
+
 /**
   Reads a local binlog and prints the events it sees.
 
@@ -3152,6 +3592,9 @@ static Exit_status dump_local_log_entries(PRINT_EVENT_INFO *print_event_info,
     char llbuff[21];
     my_off_t old_off = my_b_tell(file);
 
+    if (fd >= 0 && skip_undecoded_event(print_event_info, file, old_off))
+      continue;
+
     Log_event* ev = Log_event::read_log_event(file, glob_description_event,
                                               opt_verify_binlog_checksum);
     if (!ev)
@@ -3338,16 +3781,67 @@ int main(int argc, char** argv)
               "\n/*!40101 SET NAMES %s */;\n", charset);
   }
 
-  for (save_stop_position= stop_position, stop_position= ~(my_off_t)0 ;
-       (--argc >= 0) ; )
+  if (short_form)
   {
-    if (argc == 0) // last log, --stop-position applies
-      stop_position= save_stop_position;
-    if ((retval= dump_log_entries(*argv++)) != OK_CONTINUE)
-      break;
+    if (!print_row_event_positions_used)
+      print_row_event_positions= 0;
+    if (!print_row_count_used)
+      print_row_count = 0;
+  }
+  if (opt_flashback)
+  {
+    if (!print_row_event_positions_used)
+      print_row_event_positions= 0;
+  }
 
-    // For next log, --start-position does not apply
-    start_position= BIN_LOG_HEADER_SIZE;
+  was_first_glle_processed= start_position > BIN_LOG_HEADER_SIZE;
+
+  if (opt_parallel > 1 && argc > 1)
+  {
+    bool from_stdin= false;
+    for (int i= 0; i < argc; i++)
+      from_stdin|= !strcmp(argv[i], "-");
+    if (remote_opt || opt_flashback || offset || gtid_event_filter ||
+        verbose >= 3 || from_stdin)
+    {
+      warning("The --parallel option is ignored with "
+              "--read-from-remote-server, --flashback, --offset, the GTID "
+              "filtering options, -vvv or when reading from stdin");
+      opt_parallel= 1;
+    }
+  }
+  else
+    opt_parallel= 1;
+
+  if (opt_parallel > 1)
+  {
+    /*
+      The GTID state is only validated past the first Gtid_list event in
+      --gtid-strict-mode; process_event() deletes the validator otherwise.
+    */
+    if (gtid_state_validator && !opt_gtid_strict_mode)
+    {
+      delete gtid_state_validator;
+      gtid_state_validator= NULL;
+    }
+    parallel_start_position= start_position;
+    parallel_stop_position= stop_position;
+    parallel_start_datetime= start_datetime;
+    retval= dump_log_files_parallel(argv, (uint) argc);
+  }
+  else
+  {
+    for (save_stop_position= stop_position, stop_position= ~(my_off_t)0 ;
+         (--argc >= 0) ; )
+    {
+      if (argc == 0) // last log, --stop-position applies
+        stop_position= save_stop_position;
+      if ((retval= dump_log_entries(*argv++)) != OK_CONTINUE)
+        break;
+
+      // For next log, --start-position does not apply
+      start_position= BIN_LOG_HEADER_SIZE;
+    }
   }
 
   /*
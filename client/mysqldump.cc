@@ -62,6 +62,9 @@
 
 #include <welcome_copyright_notice.h> /* ORACLE_WELCOME_COPYRIGHT_NOTICE */
 #include "connection_pool.h"
+#include <string>
+#include <vector>
+
 /* Exit codes */
 
 #define EX_USAGE 1
@@ -194,6 +197,7 @@ FILE *stderror_file=0;
 static uint opt_protocol= 0;
 static char *opt_plugin_dir= 0, *opt_default_auth= 0;
 static uint opt_parallel= 0;
+static ulonglong opt_chunk_rows= 0;
 /*
   Dynamic_string wrapper functions. In this file use these
   wrappers, they will terminate the process if there is
@@ -283,6 +287,15 @@ static struct my_option my_long_options[] =
   {"character-sets-dir", 0,
    "Directory for character set files.", (char **)&charsets_dir,
    (char **)&charsets_dir, 0, GET_STR, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
+  {"chunk-rows", 0,
+   "With --tab, split the data of each table that has a single-column "
+   "primary key into files table.1.txt, table.2.txt, ... of approximately "
+   "this many rows each. Together with --parallel, the chunks are dumped "
+   "concurrently, and mariadb-import can load them in parallel. "
+   "With --single-transaction, all connections share one snapshot, "
+   "which requires FLUSH TABLES WITH READ LOCK. 0 disables splitting.",
+   &opt_chunk_rows, &opt_chunk_rows, 0, GET_ULL, REQUIRED_ARG,
+   0, 0, ULONGLONG_MAX, 0, 0, 0},
   {"comments", 'i', "Write additional information.",
    &opt_comments, &opt_comments, 0, GET_BOOL, NO_ARG,
    1, 0, 0, 0, 0, 0},
@@ -4052,6 +4065,133 @@ static void send_query_completion_func(MYSQL* mysql, const char* query,
       mysql_error(mysql));
 }
 
+/*
+  Find the primary key values that split a table into chunks
+
+  SYNOPSIS
+    get_chunk_bounds()
+    qdatabase     quoted database name
+    result_table  quoted table name
+    quoted_pk     OUT: the quoted primary key column,
+                  a buffer of NAME_LEN * 2 + 3 bytes
+    bounds        OUT: SQL literals of the smallest primary key value
+                  of each chunk, except the first chunk
+
+  DESCRIPTION
+    Only a single-column PRIMARY KEY is used, because it cannot contain
+    NULL values.  Each bound is read by an index range scan that starts
+    at the previous bound and skips --chunk-rows keys, so that the key
+    is traversed only once.
+
+  RETURN
+    0 on success (bounds is empty if the table will not be split)
+    1 on error
+*/
+
+static int get_chunk_bounds(const char *qdatabase, const char *result_table,
+                            char *quoted_pk, std::vector<std::string> *bounds)
+{
+  MYSQL_RES *res;
+  MYSQL_ROW row;
+  char buff[NAME_LEN * 4 + 20];
+  char offset[22];
+  DYNAMIC_STRING query;
+  int error= 0;
+  DBUG_ENTER("get_chunk_bounds");
+
+  my_snprintf(buff, sizeof(buff), "SHOW KEYS FROM %s.%s",
+              qdatabase, result_table);
+  if (mysql_query_with_error_report(mysql, &res, buff))
+    DBUG_RETURN(1);
+
+  /* SHOW KEYS returns the PRIMARY KEY first */
+  if (!(row= mysql_fetch_row(res)) || strcmp(row[2], "PRIMARY"))
+  {
+    mysql_free_result(res);
+    DBUG_RETURN(0);
+  }
+  strmov(quoted_pk, quote_name(row[4], buff, 1));
+  if ((row= mysql_fetch_row(res)) && !strcmp(row[2], "PRIMARY"))
+  {
+    mysql_free_result(res);
+    DBUG_RETURN(0);
+  }
+  mysql_free_result(res);
+
+  longlong10_to_str(opt_chunk_rows, offset, 10);
+  init_dynamic_string_checked(&query, "", 256, 256);
+
+  for (;;)
+  {
+    MYSQL_FIELD *field;
+    ulong *lengths;
+    std::string bound;
+
+    dynstr_set_checked(&query, "SELECT /*!40001 SQL_NO_CACHE */ ");
+    dynstr_append_checked(&query, quoted_pk);
+    dynstr_append_checked(&query, " FROM ");
+    dynstr_append_checked(&query, qdatabase);
+    dynstr_append_checked(&query, ".");
+    dynstr_append_checked(&query, result_table);
+    if (where || !bounds->empty())
+      dynstr_append_checked(&query, " WHERE ");
+    if (where)
+    {
+      dynstr_append_checked(&query, "(");
+      dynstr_append_checked(&query, where);
+      dynstr_append_checked(&query, ")");
+      if (!bounds->empty())
+        dynstr_append_checked(&query, " AND ");
+    }
+    if (!bounds->empty())
+    {
+      dynstr_append_checked(&query, quoted_pk);
+      dynstr_append_checked(&query, ">=");
+      dynstr_append_checked(&query, bounds->back().c_str());
+    }
+    dynstr_append_checked(&query, " ORDER BY ");
+    dynstr_append_checked(&query, quoted_pk);
+    dynstr_append_checked(&query, " LIMIT 1 OFFSET ");
+    dynstr_append_checked(&query, offset);
+
+    if (mysql_query_with_error_report(mysql, &res, query.str))
+    {
+      error= 1;
+      break;
+    }
+    if (!(row= mysql_fetch_row(res)))
+    {
+      mysql_free_result(res);
+      break;
+    }
+
+    field= mysql_fetch_field(res);
+    lengths= mysql_fetch_lengths(res);
+    if (IS_NUM(field->type))
+      bound.assign(row[0], lengths[0]);
+    else
+    {
+      std::vector<char> escaped(lengths[0] * 2 + 1);
+      ulong escaped_length= mysql_real_escape_string(mysql, escaped.data(),
+                                                     row[0], lengths[0]);
+      bound.assign("'");
+      bound.append(escaped.data(), escaped_length);
+      bound.append("'");
+    }
+    mysql_free_result(res);
+
+    /* Guard against values that are not distinguishable as literals */
+    if (!bounds->empty() && bounds->back() == bound)
+      break;
+    bounds->push_back(std::move(bound));
+  }
+
+  dynstr_free(&query);
+  if (error)
+    bounds->clear();
+  DBUG_RETURN(error);
+}
+
 /*
 
  SYNOPSIS
@@ -4157,6 +4297,11 @@ static void dump_table(const char *table, const char *db, const uchar *hash_key,
   if (path)
   {
     char filename[FN_REFLEN], tmp_path[FN_REFLEN];
+    char chunk_name[NAME_LEN + 24];
+    char quoted_pk[NAME_LEN * 2 + 3];
+    char quoted_db_buf[NAME_LEN * 2 + 3];
+    char *qdatabase= quote_name(db, quoted_db_buf, opt_quoted);
+    std::vector<std::string> chunk_bounds;
     /*
       Convert the path to native os format
       and resolve to the full filepath.
@@ -4165,89 +4310,139 @@ static void dump_table(const char *table, const char *db, const uchar *hash_key,
     my_load_path(tmp_path, tmp_path, NULL);
     fn_format(filename, table, tmp_path, ".txt", MYF(MY_UNPACK_FILENAME));
 
-    /* Must delete the file that 'INTO OUTFILE' will write to */
-    my_delete(filename, MYF(0));
+    if (opt_chunk_rows && !versioned &&
+        !get_chunk_bounds(qdatabase, result_table, quoted_pk, &chunk_bounds) &&
+        !chunk_bounds.empty())
+    {
+      verbose_msg("-- Splitting table '%s' into %zu chunks by %s\n",
+                  table, chunk_bounds.size() + 1, quoted_pk);
+      /* Do not leave behind a file that mariadb-import would load, too */
+      my_delete(filename, MYF(0));
+    }
 
-    /* convert to a unix path name to stick into the query */
-    to_unix_path(filename);
+    for (size_t chunk= 0; chunk <= chunk_bounds.size(); chunk++)
+    {
+      if (!chunk_bounds.empty())
+      {
+        snprintf(chunk_name, sizeof chunk_name, "%s.%zu", table, chunk + 1);
+        fn_format(filename, chunk_name, tmp_path, ".txt",
+                  MYF(MY_UNPACK_FILENAME | MY_APPEND_EXT));
+      }
 
-    /* now build the query string */
+      /* Must delete the file that 'INTO OUTFILE' will write to */
+      my_delete(filename, MYF(0));
 
-    dynstr_append_checked(&query_string, "SELECT /*!40001 SQL_NO_CACHE */ ");
-    dynstr_append_checked(&query_string, select_field_names.str);
-    dynstr_append_checked(&query_string, " INTO OUTFILE '");
-    dynstr_append_checked(&query_string, filename);
-    dynstr_append_checked(&query_string, "'");
+      /* convert to a unix path name to stick into the query */
+      to_unix_path(filename);
 
-    dynstr_append_checked(&query_string, " /*!50138 CHARACTER SET ");
-    dynstr_append_checked(&query_string, default_charset == mysql_universal_client_charset ?
-                                         my_charset_bin.coll_name.str : /* backward compatibility */
-                                         default_charset);
-    dynstr_append_checked(&query_string, " */");
+      /* now build the query string */
 
-    if (fields_terminated || enclosed || opt_enclosed || escaped)
-      dynstr_append_checked(&query_string, " FIELDS");
+      dynstr_set_checked(&query_string, "SELECT /*!40001 SQL_NO_CACHE */ ");
+      dynstr_append_checked(&query_string, select_field_names.str);
+      dynstr_append_checked(&query_string, " INTO OUTFILE '");
+      dynstr_append_checked(&query_string, filename);
+      dynstr_append_checked(&query_string, "'");
 
-    add_load_option(&query_string, " TERMINATED BY ", fields_terminated);
-    add_load_option(&query_string, " ENCLOSED BY ", enclosed);
-    add_load_option(&query_string, " OPTIONALLY ENCLOSED BY ", opt_enclosed);
-    add_load_option(&query_string, " ESCAPED BY ", escaped);
-    add_load_option(&query_string, " LINES TERMINATED BY ", lines_terminated);
+      dynstr_append_checked(&query_string, " /*!50138 CHARACTER SET ");
+      dynstr_append_checked(&query_string, default_charset == mysql_universal_client_charset ?
+                                           my_charset_bin.coll_name.str : /* backward compatibility */
+                                           default_charset);
+      dynstr_append_checked(&query_string, " */");
 
-    if (opt_header)
-    {
-      dynstr_append_checked(&query_string, " FROM ( SELECT ");
-      if (order_by)
-        dynstr_append_checked(&query_string, " 0 AS `_$is_data_row$_`,");
-      dynstr_append_checked(&query_string, select_field_names_for_header.str);
-      dynstr_append_checked(&query_string, " UNION ALL SELECT ");
-      if (order_by)
-        dynstr_append_checked(&query_string, "1 AS `_$is_data_row$_`,");
-      dynstr_append_checked(&query_string, select_field_names.str);
-    }
-    dynstr_append_checked(&query_string, " FROM ");
-    char quoted_db_buf[NAME_LEN * 2 + 3];
-    char *qdatabase= quote_name(db, quoted_db_buf, opt_quoted);
-    dynstr_append_checked(&query_string, qdatabase);
-    dynstr_append_checked(&query_string, ".");
-    dynstr_append_checked(&query_string, result_table);
+      if (fields_terminated || enclosed || opt_enclosed || escaped)
+        dynstr_append_checked(&query_string, " FIELDS");
 
-    if (versioned)
-      vers_append_system_time(&query_string);
+      add_load_option(&query_string, " TERMINATED BY ", fields_terminated);
+      add_load_option(&query_string, " ENCLOSED BY ", enclosed);
+      add_load_option(&query_string, " OPTIONALLY ENCLOSED BY ", opt_enclosed);
+      add_load_option(&query_string, " ESCAPED BY ", escaped);
+      add_load_option(&query_string, " LINES TERMINATED BY ", lines_terminated);
 
-    if (where)
-    {
-      dynstr_append_checked(&query_string, " WHERE ");
-      dynstr_append_checked(&query_string, where);
-    }
-    if (opt_header)
-      dynstr_append_checked(&query_string, ") s");
+      if (opt_header)
+      {
+        dynstr_append_checked(&query_string, " FROM ( SELECT ");
+        if (order_by)
+          dynstr_append_checked(&query_string, " 0 AS `_$is_data_row$_`,");
+        dynstr_append_checked(&query_string, select_field_names_for_header.str);
+        dynstr_append_checked(&query_string, " UNION ALL SELECT ");
+        if (order_by)
+          dynstr_append_checked(&query_string, "1 AS `_$is_data_row$_`,");
+        dynstr_append_checked(&query_string, select_field_names.str);
+      }
+      dynstr_append_checked(&query_string, " FROM ");
+      dynstr_append_checked(&query_string, qdatabase);
+      dynstr_append_checked(&query_string, ".");
+      dynstr_append_checked(&query_string, result_table);
 
-    if (order_by)
-    {
+      if (versioned)
+        vers_append_system_time(&query_string);
+
+      if (where && chunk_bounds.empty())
+      {
+        dynstr_append_checked(&query_string, " WHERE ");
+        dynstr_append_checked(&query_string, where);
+      }
+      else if (!chunk_bounds.empty())
+      {
+        dynstr_append_checked(&query_string, " WHERE ");
+        if (where)
+        {
+          dynstr_append_checked(&query_string, "(");
+          dynstr_append_checked(&query_string, where);
+          dynstr_append_checked(&query_string, ") AND ");
+        }
+        /*
+          The chunks are delimited by the same literals on both sides,
+          so that every row belongs to exactly one chunk.
+        */
+        if (chunk > 0)
+        {
+          dynstr_append_checked(&query_string, quoted_pk);
+          dynstr_append_checked(&query_string, ">=");
+          dynstr_append_checked(&query_string, chunk_bounds[chunk - 1].c_str());
+          if (chunk < chunk_bounds.size())
+            dynstr_append_checked(&query_string, " AND ");
+        }
+        if (chunk < chunk_bounds.size())
+        {
+          dynstr_append_checked(&query_string, quoted_pk);
+          dynstr_append_checked(&query_string, "<");
+          dynstr_append_checked(&query_string, chunk_bounds[chunk].c_str());
+        }
+      }
       if (opt_header)
-        dynstr_append_checked(&query_string, " ORDER BY `_$is_data_row$_`,");
-      else
-        dynstr_append_checked(&query_string, " ORDER BY ");
-      dynstr_append_checked(&query_string, order_by);
-      my_free(order_by);
-      order_by= 0;
-    }
-    if (opt_parallel)
-    {
-      if (connection_pool.execute_async(query_string.str,send_query_completion_func,nullptr,true))
+        dynstr_append_checked(&query_string, ") s");
+
+      if (order_by)
+      {
+        if (opt_header)
+          dynstr_append_checked(&query_string, " ORDER BY `_$is_data_row$_`,");
+        else
+          dynstr_append_checked(&query_string, " ORDER BY ");
+        dynstr_append_checked(&query_string, order_by);
+      }
+      if (opt_parallel)
+      {
+        if (connection_pool.execute_async(query_string.str,send_query_completion_func,nullptr,true))
+        {
+          dynstr_free(&query_string);
+          my_free(order_by);
+          order_by= 0;
+          DB_error(mysql, "when executing send_query 'SELECT INTO OUTFILE'");
+          DBUG_VOID_RETURN;
+        }
+      }
+      else if (mysql_real_query(mysql, query_string.str, (ulong)query_string.length))
       {
         dynstr_free(&query_string);
-        DB_error(mysql, "when executing send_query 'SELECT INTO OUTFILE'");
+        my_free(order_by);
+        order_by= 0;
+        DB_error(mysql, "when executing 'SELECT INTO OUTFILE'");
         DBUG_VOID_RETURN;
       }
     }
-    else if (mysql_real_query(mysql, query_string.str, (ulong)query_string.length))
-    {
-      dynstr_free(&query_string);
-      DB_error(mysql, "when executing 'SELECT INTO OUTFILE'");
-      DBUG_VOID_RETURN;
-    }
+    my_free(order_by);
+    order_by= 0;
   }
   else
   {
@@ -7172,6 +7367,12 @@ int main(int argc, char **argv)
                   "works together with --tab\n");
       opt_parallel= 0;
     }
+    if (opt_chunk_rows)
+    {
+      verbose_msg("-- Warning: ignoring --chunk-rows setting, it only "
+                  "works together with --tab\n");
+      opt_chunk_rows= 0;
+    }
   }
   else if (opt_parallel)
     init_connection_pool(opt_parallel);
@@ -7192,8 +7393,14 @@ int main(int argc, char **argv)
     consistent_binlog_pos= check_consistent_binlog_pos(NULL, NULL);
   }
 
+  /*
+    With --chunk-rows, the chunks of a table are dumped over different
+    connections. Block all writes while their transactions are being
+    started, so that they will read the same snapshot.
+  */
   if ((opt_lock_all_tables || (opt_master_data && !consistent_binlog_pos) ||
-       (opt_single_transaction && flush_logs)) &&
+       (opt_single_transaction && (flush_logs ||
+                                   (opt_parallel && opt_chunk_rows)))) &&
       do_flush_tables_read_lock(mysql))
     goto err;
 
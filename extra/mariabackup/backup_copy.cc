@@ -60,6 +60,7 @@ Street, Fifth Floor, Boston, MA 02110-1335 USA
 #include "backup_copy.h"
 #include "backup_debug.h"
 #include "backup_mysql.h"
+#include "ds_compress_frame.h"
 #include <btr0btr.h>
 #ifdef _WIN32
 #include <direct.h> /* rmdir */
@@ -1809,7 +1810,7 @@ copy_back()
 			MB_METADATA_FILENAME,
 			XTRABACKUP_BINLOG_INFO,
 			XTRABACKUP_METADATA_FILENAME,
-			".qp", ".pmap", ".tmp",
+			".qp", ".zst", ".lz4", ".pmap", ".tmp",
 			NULL};
 		const char *filename;
 		char c_tmp;
@@ -1856,7 +1857,7 @@ copy_back()
 
 		filename = base_name(node.filepath);
 
-		/* skip .qp files */
+		/* skip compressed files */
 		if (filename_matches(filename, ext_list)) {
 			continue;
 		}
@@ -1922,6 +1923,27 @@ copy_back()
 bool
 decrypt_decompress_file(const char *filepath, uint thread_n)
 {
+	if (size_t ext_len = opt_decompress
+	    ? compress_frame_ext_len(filepath) : 0) {
+		std::string dest_filepath(filepath,
+					  strlen(filepath) - ext_len);
+
+		msg(thread_n, "decompressing %s", filepath);
+
+		if (!decompress_frame_file(filepath, dest_filepath.c_str())) {
+			return(false);
+		}
+
+		if (opt_remove_original) {
+			msg(thread_n, "Removing %s", filepath);
+			if (my_delete(filepath, MYF(MY_WME)) != 0) {
+				return(false);
+			}
+		}
+
+		return(true);
+	}
+
 	std::stringstream cmd, message;
 	char *dest_filepath = strdup(filepath);
 	bool needs_action = false;
@@ -1977,7 +1999,8 @@ static void decrypt_decompress_thread_func(datadir_thread_ctxt_t *ctxt)
 			continue;
 		}
 
-		if (!ends_with(node.filepath, ".qp")) {
+		if (!ends_with(node.filepath, ".qp")
+		    && !compress_frame_ext_len(node.filepath)) {
 			continue;
 		}
 
@@ -2016,9 +2039,13 @@ decrypt_decompress()
 
 	it = datadir_iter_new(".", false);
 
+	decompress_frame_init(xtrabackup_compress_threads);
+
 	ret = run_data_threads(it, decrypt_decompress_thread_func,
 		xtrabackup_parallel ? xtrabackup_parallel : 1);
 
+	decompress_frame_end();
+
 	if (it != NULL) {
 		datadir_iter_free(it);
 	}
@@ -2069,3 +2069,15 @@ ulonglong get_current_lsn(MYSQL *connection)
 	}
 	return lsn;
 }
+
+/** @return whether the server is running with innodb_track_changed_pages=ON */
+bool have_changed_page_tracking(MYSQL *connection)
+{
+	char *value = read_mysql_one_value(
+		connection,
+		"SHOW GLOBAL VARIABLES LIKE 'innodb_track_changed_pages'",
+		1, 2);
+	const bool ret = value && !strcmp(value, "ON");
+	free(value);
+	return ret;
+}
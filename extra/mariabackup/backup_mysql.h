@@ -101,4 +101,6 @@ write_slave_info(ds_ctxt *datasink, MYSQL *connection);
 
 ulonglong get_current_lsn(MYSQL *connection);
 
+bool have_changed_page_tracking(MYSQL *connection);
+
 #endif
@@ -23,6 +23,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1335  USA
 #include "common.h"
 #include "datasink.h"
 #include "ds_compress.h"
+#include "ds_compress_frame.h"
 #include "ds_xbstream.h"
 #include "ds_local.h"
 #include "ds_stdout.h"
@@ -50,6 +51,12 @@ ds_create(const char *root, ds_type_t type)
 	case DS_TYPE_COMPRESS:
 		ds = &datasink_compress;
 		break;
+	case DS_TYPE_COMPRESS_ZSTD:
+		ds = &datasink_compress_zstd;
+		break;
+	case DS_TYPE_COMPRESS_LZ4:
+		ds = &datasink_compress_lz4;
+		break;
 	case DS_TYPE_ENCRYPT:
   case DS_TYPE_DECRYPT:
 		die("mariabackup does not support encrypted backups.");
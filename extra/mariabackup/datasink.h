@@ -103,7 +103,9 @@ typedef enum {
 	DS_TYPE_ENCRYPT,
 	DS_TYPE_DECRYPT,
 	DS_TYPE_TMPFILE,
-	DS_TYPE_BUFFER
+	DS_TYPE_BUFFER,
+	DS_TYPE_COMPRESS_ZSTD,
+	DS_TYPE_COMPRESS_LZ4
 } ds_type_t;
 
 /************************************************************************
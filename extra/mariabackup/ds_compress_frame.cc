@@ -0,0 +1,734 @@
+/******************************************************
+Copyright (c) 2024, MariaDB Corporation.
+
+Compressing datasinks for mariabackup using the zstd and lz4 frame formats.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1335  USA
+
+*******************************************************/
+
+/* The input is split into chunks of --compress-chunk-size bytes, which
+are compressed by --compress-threads threads into independent frames
+that carry a checksum of their contents. Each frame is preceded by a
+skippable frame that contains the compressed and uncompressed length
+of the chunk, so that the chunks can be located and decompressed in
+parallel. The zstd and lz4 command line tools ignore skippable frames,
+so that they can decompress the files as well.
+
+Chunk header (all integers little-endian):
+magic(4), payload length(4) = 16,
+compressed length(8), uncompressed length(8) */
+
+#include <my_global.h>
+#include <my_base.h>
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+#ifdef HAVE_ZSTD
+# include <zstd.h>
+#endif
+#ifdef HAVE_LZ4
+# include <lz4frame.h>
+#endif
+#include "common.h"
+#include "datasink.h"
+#include "ds_compress_frame.h"
+#include "thread_pool.h"
+
+/** A skippable frame magic number of the zstd and lz4 frame formats */
+#define FRAME_CHUNK_MAGIC		0x184D2A5BU
+#define FRAME_CHUNK_PAYLOAD		16
+#define FRAME_CHUNK_HEADER_SIZE		(8 + FRAME_CHUNK_PAYLOAD)
+/** Maximum size of an uncompressed chunk */
+#define FRAME_CHUNK_MAX			(1ULL << 30)
+
+/* Compression options */
+extern uint		xtrabackup_compress_threads;
+extern ulonglong	xtrabackup_compress_chunk_size;
+
+/** Compression algorithm */
+struct frame_codec_t {
+	const char	*name;
+	/** file name extension */
+	const char	*ext;
+	/** @return upper bound of the size of a compressed chunk */
+	size_t		(*bound)(size_t len);
+	void		*(*create_cctx)();
+	void		(*free_cctx)(void *cctx);
+	/** @return the compressed length, or 0 on error */
+	size_t		(*compress)(void *cctx, uchar *dst, size_t dst_len,
+				    const uchar *src, size_t len);
+	void		*(*create_dctx)();
+	void		(*free_dctx)(void *dctx);
+	/** @return whether src was a valid frame of exactly len bytes */
+	bool		(*decompress)(void *dctx, uchar *dst, size_t len,
+				      const uchar *src, size_t src_len);
+};
+
+#ifdef HAVE_ZSTD
+static size_t zstd_bound(size_t len)
+{
+	return ZSTD_compressBound(len);
+}
+
+static void *zstd_create_cctx()
+{
+	ZSTD_CCtx *cctx = ZSTD_createCCtx();
+	if (cctx && ZSTD_isError(ZSTD_CCtx_setParameter(
+					 cctx, ZSTD_c_checksumFlag, 1))) {
+		ZSTD_freeCCtx(cctx);
+		return NULL;
+	}
+	return cctx;
+}
+
+static void zstd_free_cctx(void *cctx)
+{
+	ZSTD_freeCCtx(static_cast<ZSTD_CCtx*>(cctx));
+}
+
+static size_t zstd_compress(void *cctx, uchar *dst, size_t dst_len,
+			    const uchar *src, size_t len)
+{
+	size_t ret = ZSTD_compress2(static_cast<ZSTD_CCtx*>(cctx),
+				    dst, dst_len, src, len);
+	if (ZSTD_isError(ret)) {
+		msg("compress: zstd: %s", ZSTD_getErrorName(ret));
+		return 0;
+	}
+	return ret;
+}
+
+static void *zstd_create_dctx()
+{
+	return ZSTD_createDCtx();
+}
+
+static void zstd_free_dctx(void *dctx)
+{
+	ZSTD_freeDCtx(static_cast<ZSTD_DCtx*>(dctx));
+}
+
+static bool zstd_decompress(void *dctx, uchar *dst, size_t len,
+			    const uchar *src, size_t src_len)
+{
+	size_t ret = ZSTD_decompressDCtx(static_cast<ZSTD_DCtx*>(dctx),
+					 dst, len, src, src_len);
+	if (ZSTD_isError(ret)) {
+		msg("decompress: zstd: %s", ZSTD_getErrorName(ret));
+		return false;
+	}
+	return ret == len;
+}
+#endif
+
+#ifdef HAVE_LZ4
+static void lz4_preferences(LZ4F_preferences_t *prefs, size_t len)
+{
+	memset(prefs, 0, sizeof *prefs);
+	prefs->frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+	prefs->frameInfo.contentSize = len;
+}
+
+static size_t lz4_bound(size_t len)
+{
+	LZ4F_preferences_t prefs;
+	lz4_preferences(&prefs, len);
+	return LZ4F_compressFrameBound(len, &prefs);
+}
+
+static size_t lz4_compress(void *, uchar *dst, size_t dst_len,
+			   const uchar *src, size_t len)
+{
+	LZ4F_preferences_t prefs;
+	lz4_preferences(&prefs, len);
+	size_t ret = LZ4F_compressFrame(dst, dst_len, src, len, &prefs);
+	if (LZ4F_isError(ret)) {
+		msg("compress: lz4: %s", LZ4F_getErrorName(ret));
+		return 0;
+	}
+	return ret;
+}
+
+static void *lz4_create_dctx()
+{
+	LZ4F_dctx *dctx;
+	if (LZ4F_isError(LZ4F_createDecompressionContext(&dctx,
+							 LZ4F_VERSION))) {
+		return NULL;
+	}
+	return dctx;
+}
+
+static void lz4_free_dctx(void *dctx)
+{
+	LZ4F_freeDecompressionContext(static_cast<LZ4F_dctx*>(dctx));
+}
+
+static bool lz4_decompress(void *dctx, uchar *dst, size_t len,
+			   const uchar *src, size_t src_len)
+{
+	for (;;) {
+		size_t in = src_len, out = len;
+		size_t ret = LZ4F_decompress(static_cast<LZ4F_dctx*>(dctx),
+					     dst, &out, src, &in, NULL);
+		if (LZ4F_isError(ret)) {
+			msg("decompress: lz4: %s", LZ4F_getErrorName(ret));
+			return false;
+		}
+		src += in;
+		src_len -= in;
+		dst += out;
+		len -= out;
+		if (!ret) {
+			/* The end of the frame was reached and
+			the content checksum matched. */
+			return !src_len && !len;
+		}
+		if (!in && !out) {
+			return false;
+		}
+	}
+}
+#endif
+
+enum frame_codec_id { FRAME_ZSTD, FRAME_LZ4, FRAME_N };
+
+/** The algorithms; the function pointers are NULL if the algorithm
+is not available in this build */
+static const frame_codec_t frame_codecs[FRAME_N] = {
+#ifdef HAVE_ZSTD
+	{"zstd", ".zst", zstd_bound, zstd_create_cctx, zstd_free_cctx,
+	 zstd_compress, zstd_create_dctx, zstd_free_dctx, zstd_decompress},
+#else
+	{"zstd", ".zst", NULL, NULL, NULL, NULL, NULL, NULL, NULL},
+#endif
+#ifdef HAVE_LZ4
+	{"lz4", ".lz4", lz4_bound, NULL, NULL,
+	 lz4_compress, lz4_create_dctx, lz4_free_dctx, lz4_decompress},
+#else
+	{"lz4", ".lz4", NULL, NULL, NULL, NULL, NULL, NULL, NULL},
+#endif
+};
+
+/** Worker threads with a compression or decompression context
+for each thread and algorithm */
+class frame_pool_t {
+	ThreadPool	m_pool;
+	const bool	m_compress;
+	/** contexts, indexed by thread number * FRAME_N + algorithm */
+	std::vector<void*> m_ctxt;
+
+	/** Create the context for a thread if needed.
+	@return the context, or NULL on error */
+	void *get_ctxt(void *&ctxt, const frame_codec_t &codec)
+	{
+		if (!ctxt) {
+			if (void *(*create)() = m_compress
+			    ? codec.create_cctx : codec.create_dctx) {
+				ctxt = create();
+			} else {
+				/* No context is needed; use a dummy. */
+				ctxt = this;
+			}
+		}
+		return ctxt;
+	}
+
+	void free_ctxt(void *ctxt, const frame_codec_t &codec)
+	{
+		if (void (*free_func)(void*) = m_compress
+		    ? codec.free_cctx : codec.free_dctx) {
+			free_func(ctxt);
+		}
+	}
+
+public:
+	frame_pool_t(uint n_threads, bool compress)
+		: m_compress(compress), m_ctxt(n_threads * FRAME_N)
+	{
+		m_pool.start(n_threads);
+	}
+
+	~frame_pool_t()
+	{
+		m_pool.stop();
+		for (size_t i = 0; i < m_ctxt.size(); i++) {
+			if (m_ctxt[i] && m_ctxt[i] != this) {
+				free_ctxt(m_ctxt[i], frame_codecs[i % FRAME_N]);
+			}
+		}
+	}
+
+	size_t threads() const { return m_pool.threads_count(); }
+
+	/** Invoke job(ctxt, i) for i=0..n-1 in the worker threads and
+	wait for the completion.
+	@return whether all invocations returned true */
+	bool run(const frame_codec_t &codec, size_t n,
+		 const std::function<bool(void*, size_t)> &job)
+	{
+		std::mutex mutex;
+		std::condition_variable cond;
+		size_t pending = n;
+		bool ok = true;
+
+		for (size_t i = 0; i < n; i++) {
+			m_pool.push([&, i](unsigned thread_num) {
+				void *&ctxt = m_ctxt[thread_num * FRAME_N
+						     + (&codec - frame_codecs)];
+				bool success = get_ctxt(ctxt, codec)
+					&& job(ctxt, i);
+				if (!success && ctxt) {
+					/* The state of a context is
+					undefined after a failure. */
+					if (ctxt != this) {
+						free_ctxt(ctxt, codec);
+					}
+					ctxt = NULL;
+				}
+				std::lock_guard<std::mutex> lock(mutex);
+				ok &= success;
+				if (!--pending) {
+					cond.notify_one();
+				}
+			});
+		}
+
+		std::unique_lock<std::mutex> lock(mutex);
+		cond.wait(lock, [&] { return !pending; });
+		return ok;
+	}
+};
+
+typedef struct {
+	const frame_codec_t	*codec;
+	frame_pool_t		*pool;
+} ds_frame_ctxt_t;
+
+typedef struct {
+	ds_file_t		*dest_file;
+	ds_frame_ctxt_t		*frame_ctxt;
+	size_t			chunk_size;
+	/** size of a buffer in out */
+	size_t			out_size;
+	/** a buffer for each thread */
+	uchar			*out;
+	/** length of each buffer in out */
+	size_t			*out_len;
+	/** whether nothing has been written yet */
+	bool			empty;
+} ds_frame_file_t;
+
+static ds_ctxt_t *zstd_init(const char *root);
+static ds_ctxt_t *lz4_init(const char *root);
+static ds_file_t *frame_open(ds_ctxt_t *ctxt, const char *path,
+			     const MY_STAT *mystat, bool rewrite);
+static int frame_write(ds_file_t *file, const uchar *buf, size_t len);
+static int frame_close(ds_file_t *file);
+static void frame_deinit(ds_ctxt_t *ctxt);
+
+datasink_t datasink_compress_zstd = {
+	&zstd_init,
+	&frame_open,
+	&frame_write,
+	nullptr,
+	&frame_close,
+	&dummy_remove,
+	nullptr,
+	nullptr,
+	&frame_deinit
+};
+
+datasink_t datasink_compress_lz4 = {
+	&lz4_init,
+	&frame_open,
+	&frame_write,
+	nullptr,
+	&frame_close,
+	&dummy_remove,
+	nullptr,
+	nullptr,
+	&frame_deinit
+};
+
+static
+ds_ctxt_t *
+frame_init(const frame_codec_t &codec, const char *root)
+{
+	ds_ctxt_t	*ctxt;
+	ds_frame_ctxt_t	*frame_ctxt;
+
+	if (!codec.compress) {
+		msg("compress: %s is not supported by this build.",
+		    codec.name);
+		return NULL;
+	}
+
+	ctxt = (ds_ctxt_t *) my_malloc(PSI_NOT_INSTRUMENTED,
+		sizeof(ds_ctxt_t) + sizeof(ds_frame_ctxt_t), MYF(MY_FAE));
+
+	frame_ctxt = (ds_frame_ctxt_t *) (ctxt + 1);
+	frame_ctxt->codec = &codec;
+	frame_ctxt->pool = new frame_pool_t(xtrabackup_compress_threads,
+					    true);
+
+	ctxt->ptr = frame_ctxt;
+	ctxt->root = my_strdup(PSI_NOT_INSTRUMENTED, root, MYF(MY_FAE));
+
+	return ctxt;
+}
+
+static
+ds_ctxt_t *
+zstd_init(const char *root)
+{
+	return frame_init(frame_codecs[FRAME_ZSTD], root);
+}
+
+static
+ds_ctxt_t *
+lz4_init(const char *root)
+{
+	return frame_init(frame_codecs[FRAME_LZ4], root);
+}
+
+static
+ds_file_t *
+frame_open(ds_ctxt_t *ctxt, const char *path,
+	   const MY_STAT *mystat, bool rewrite)
+{
+	DBUG_ASSERT(rewrite == false);
+	ds_frame_ctxt_t		*frame_ctxt;
+	ds_file_t		*dest_file;
+	char			new_name[FN_REFLEN];
+	ds_file_t		*file;
+	ds_frame_file_t		*frame_file;
+	size_t			n_threads;
+
+	xb_ad(ctxt->pipe_ctxt != NULL);
+	frame_ctxt = (ds_frame_ctxt_t *) ctxt->ptr;
+
+	/* Append the .zst or .lz4 extension to the filename */
+	fn_format(new_name, path, "", frame_ctxt->codec->ext,
+		  MYF(MY_APPEND_EXT));
+
+	dest_file = ds_open(ctxt->pipe_ctxt, new_name, mystat);
+	if (dest_file == NULL) {
+		return NULL;
+	}
+
+	n_threads = frame_ctxt->pool->threads();
+
+	file = (ds_file_t *) my_malloc(PSI_NOT_INSTRUMENTED,
+		sizeof(ds_file_t) + sizeof(ds_frame_file_t)
+		+ n_threads * sizeof(size_t), MYF(MY_FAE));
+	frame_file = (ds_frame_file_t *) (file + 1);
+	frame_file->dest_file = dest_file;
+	frame_file->frame_ctxt = frame_ctxt;
+	frame_file->chunk_size = (size_t) std::min<ulonglong>(
+		xtrabackup_compress_chunk_size, FRAME_CHUNK_MAX);
+	frame_file->out_size = FRAME_CHUNK_HEADER_SIZE
+		+ frame_ctxt->codec->bound(frame_file->chunk_size);
+	frame_file->out = (uchar *) my_malloc(PSI_NOT_INSTRUMENTED,
+		n_threads * frame_file->out_size, MYF(MY_FAE));
+	frame_file->out_len = (size_t *) (frame_file + 1);
+	frame_file->empty = true;
+
+	file->ptr = frame_file;
+	file->path = dest_file->path;
+
+	return file;
+}
+
+static
+int
+frame_write_low(ds_frame_file_t *frame_file, const uchar *buf, size_t len)
+{
+	const frame_codec_t	&codec = *frame_file->frame_ctxt->codec;
+	frame_pool_t		*pool = frame_file->frame_ctxt->pool;
+	const size_t		chunk_size = frame_file->chunk_size;
+
+	frame_file->empty = false;
+
+	do {
+		/* An empty file consists of one empty frame. */
+		const size_t n = len
+			? std::min(pool->threads(),
+				   (len + chunk_size - 1) / chunk_size)
+			: 1;
+
+		if (!pool->run(codec, n, [&](void *cctx, size_t i) {
+			const size_t offset = i * chunk_size;
+			const size_t chunk_len
+				= std::min(chunk_size, len - offset);
+			uchar *out = frame_file->out
+				+ i * frame_file->out_size;
+			size_t out_len = codec.compress(
+				cctx, out + FRAME_CHUNK_HEADER_SIZE,
+				frame_file->out_size
+				- FRAME_CHUNK_HEADER_SIZE,
+				buf + offset, chunk_len);
+			if (!out_len) {
+				return false;
+			}
+			int4store(out, FRAME_CHUNK_MAGIC);
+			int4store(out + 4, FRAME_CHUNK_PAYLOAD);
+			int8store(out + 8, out_len);
+			int8store(out + 16, chunk_len);
+			frame_file->out_len[i]
+				= FRAME_CHUNK_HEADER_SIZE + out_len;
+			return true;
+		})) {
+			msg("compress: %s compression failed.", codec.name);
+			return 1;
+		}
+
+		for (size_t i = 0; i < n; i++) {
+			if (ds_write(frame_file->dest_file,
+				     frame_file->out
+				     + i * frame_file->out_size,
+				     frame_file->out_len[i])) {
+				msg("compress: write to the destination stream "
+				    "failed.");
+				return 1;
+			}
+		}
+
+		const size_t done = std::min(len, n * chunk_size);
+		buf += done;
+		len -= done;
+	} while (len > 0);
+
+	return 0;
+}
+
+static
+int
+frame_write(ds_file_t *file, const uchar *buf, size_t len)
+{
+	return frame_write_low((ds_frame_file_t *) file->ptr, buf, len);
+}
+
+static
+int
+frame_close(ds_file_t *file)
+{
+	ds_frame_file_t		*frame_file;
+	int			rc = 0;
+
+	frame_file = (ds_frame_file_t *) file->ptr;
+
+	/* Let the zstd and lz4 utilities accept empty files. */
+	if (frame_file->empty) {
+		rc = frame_write_low(frame_file, NULL, 0);
+	}
+
+	if (ds_close(frame_file->dest_file)) {
+		rc = 1;
+	}
+
+	my_free(frame_file->out);
+	my_free(file);
+
+	return rc;
+}
+
+static
+void
+frame_deinit(ds_ctxt_t *ctxt)
+{
+	ds_frame_ctxt_t	*frame_ctxt;
+
+	xb_ad(ctxt->pipe_ctxt != NULL);
+
+	frame_ctxt = (ds_frame_ctxt_t *) ctxt->ptr;
+
+	delete frame_ctxt->pool;
+
+	my_free(ctxt->root);
+	my_free(ctxt);
+}
+
+ds_type_t compress_frame_ds_type(const char *alg)
+{
+	if (!strcasecmp(alg, frame_codecs[FRAME_ZSTD].name)
+	    && frame_codecs[FRAME_ZSTD].compress) {
+		return DS_TYPE_COMPRESS_ZSTD;
+	}
+	if (!strcasecmp(alg, frame_codecs[FRAME_LZ4].name)
+	    && frame_codecs[FRAME_LZ4].compress) {
+		return DS_TYPE_COMPRESS_LZ4;
+	}
+	return DS_TYPE_COMPRESS;
+}
+
+static const frame_codec_t *frame_codec_for(const char *path)
+{
+	size_t len = strlen(path);
+
+	for (const frame_codec_t &codec : frame_codecs) {
+		size_t ext_len = strlen(codec.ext);
+		if (len > ext_len && !strcmp(path + len - ext_len, codec.ext)) {
+			return &codec;
+		}
+	}
+
+	return NULL;
+}
+
+size_t compress_frame_ext_len(const char *path)
+{
+	const frame_codec_t *codec = frame_codec_for(path);
+	return codec ? strlen(codec->ext) : 0;
+}
+
+/** Threads for decompress_frame_file() */
+static frame_pool_t *decompress_pool;
+
+void decompress_frame_init(uint n_threads)
+{
+	xb_ad(!decompress_pool);
+	decompress_pool = new frame_pool_t(n_threads, false);
+}
+
+void decompress_frame_end()
+{
+	delete decompress_pool;
+	decompress_pool = NULL;
+}
+
+/** A chunk that is being decompressed */
+struct frame_chunk_t {
+	std::vector<uchar> in;
+	std::vector<uchar> out;
+};
+
+bool decompress_frame_file(const char *src, const char *dst)
+{
+	const frame_codec_t	*codec = frame_codec_for(src);
+	File			in, out;
+	bool			ok = true;
+	bool			eof = false;
+	my_off_t		offset = 0;
+
+	xb_ad(decompress_pool);
+	xb_ad(codec);
+
+	if (!codec->decompress) {
+		msg("decompress: %s: %s is not supported by this build.",
+		    src, codec->name);
+		return false;
+	}
+
+	in = my_open(src, O_RDONLY | O_BINARY, MYF(MY_WME));
+	if (in < 0) {
+		return false;
+	}
+
+	out = my_create(dst, 0, O_WRONLY | O_BINARY | O_TRUNC, MYF(MY_WME));
+	if (out < 0) {
+		my_close(in, MYF(MY_WME));
+		return false;
+	}
+
+	std::vector<frame_chunk_t> chunks(decompress_pool->threads());
+
+	while (ok && !eof) {
+		size_t n;
+
+		/* Read a chunk for each thread. */
+		for (n = 0; n < chunks.size(); n++) {
+			uchar		header[FRAME_CHUNK_HEADER_SIZE];
+			ulonglong	in_len, out_len;
+			size_t		len;
+
+			len = my_read(in, header, sizeof header, MYF(MY_WME));
+			if (len == 0) {
+				eof = true;
+				break;
+			}
+
+			if (len == MY_FILE_ERROR) {
+				ok = false;
+				break;
+			}
+
+			in_len = uint8korr(header + 8);
+			out_len = uint8korr(header + 16);
+
+			if (len != sizeof header
+			    || uint4korr(header) != FRAME_CHUNK_MAGIC
+			    || uint4korr(header + 4) != FRAME_CHUNK_PAYLOAD
+			    || out_len > FRAME_CHUNK_MAX
+			    || in_len > codec->bound(size_t(out_len))) {
+				msg("decompress: %s: invalid chunk header "
+				    "at offset %llu.", src, offset);
+				ok = false;
+				break;
+			}
+
+			chunks[n].in.resize(size_t(in_len));
+			chunks[n].out.resize(size_t(out_len));
+
+			if (my_read(in, chunks[n].in.data(), size_t(in_len),
+				    MYF(MY_WME | MY_NABP))) {
+				msg("decompress: %s: truncated chunk "
+				    "at offset %llu.", src, offset);
+				ok = false;
+				break;
+			}
+
+			offset += sizeof header + in_len;
+		}
+
+		if (!ok || !n) {
+			break;
+		}
+
+		if (!decompress_pool->run(*codec, n, [&](void *dctx, size_t i) {
+			return codec->decompress(dctx, chunks[i].out.data(),
+						 chunks[i].out.size(),
+						 chunks[i].in.data(),
+						 chunks[i].in.size());
+		})) {
+			msg("decompress: %s: corrupted data before "
+			    "offset %llu.", src, offset);
+			ok = false;
+			break;
+		}
+
+		for (size_t i = 0; i < n; i++) {
+			if (my_write(out, chunks[i].out.data(),
+				     chunks[i].out.size(),
+				     MYF(MY_WME | MY_NABP))) {
+				ok = false;
+				break;
+			}
+		}
+	}
+
+	my_close(in, MYF(MY_WME));
+	if (my_close(out, MYF(MY_WME))) {
+		ok = false;
+	}
+
+	if (!ok) {
+		my_delete(dst, MYF(0));
+	}
+
+	return ok;
+}
@@ -0,0 +1,56 @@
+/******************************************************
+Copyright (c) 2024, MariaDB Corporation.
+
+Compression interface for mariabackup using the zstd and lz4 frame formats.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1335  USA
+
+*******************************************************/
+
+#ifndef DS_COMPRESS_FRAME_H
+#define DS_COMPRESS_FRAME_H
+
+#include "datasink.h"
+
+extern datasink_t datasink_compress_zstd;
+extern datasink_t datasink_compress_lz4;
+
+/************************************************************************
+Check whether a --compress algorithm is implemented by this module.
+@return the datasink type, or DS_TYPE_COMPRESS if not */
+ds_type_t compress_frame_ds_type(const char *alg);
+
+/************************************************************************
+Check whether a file was written by datasink_compress_zstd or
+datasink_compress_lz4.
+@return the length of the file name extension, or 0 */
+size_t compress_frame_ext_len(const char *path);
+
+/************************************************************************
+Start the threads that decompress_frame_file() uses. */
+void decompress_frame_init(uint n_threads);
+
+/************************************************************************
+Stop the threads that were started by decompress_frame_init(). */
+void decompress_frame_end();
+
+/************************************************************************
+Decompress a file that was written by datasink_compress_zstd or
+datasink_compress_lz4, verifying the checksum of each chunk.
+@param src	the compressed file
+@param dst	the file to create
+@return whether the operation succeeded */
+bool decompress_frame_file(const char *src, const char *dst);
+
+#endif
@@ -61,6 +61,7 @@ Street, Fifth Floor, Boston, MA 02110-1335 USA
 #include "fil_cur.h"
 #include "write_filt.h"
 #include "backup_copy.h"
+#include "ds_compress_frame.h"
 
 using std::min;
 using std::max;
@@ -326,8 +327,8 @@ static struct my_option ibx_long_options[] =
 	 (uchar *) 0, (uchar*) 0,
 	 0, GET_BOOL, NO_ARG, 0, 0, 0, 0, 0, 0},
 
-	{"decompress", OPT_DECOMPRESS, "Decompresses all files with the .qp "
-	 "extension in a backup previously made with the --compress option.",
+	{"decompress", OPT_DECOMPRESS, "Decompresses all files with the .qp, "
+	 ".zst or .lz4 extension in a backup previously made with the --compress option.",
 	 (uchar *) &opt_ibx_decompress,
 	 (uchar *) &opt_ibx_decompress,
 	 0, GET_BOOL, NO_ARG, 0, 0, 0, 0, 0, 0},
@@ -479,7 +480,8 @@ static struct my_option ibx_long_options[] =
 	 GET_BOOL, NO_ARG, 0, 0, 0, 0, 0, 0},
 
 	{"compress", OPT_COMPRESS, "This option instructs backup to "
-	 "compress backup copies of InnoDB data files."
+	 "compress backup copies of InnoDB data files using the specified "
+	 "algorithm: zstd, lz4 or quicklz (default)."
 	 , (uchar*) &ibx_xtrabackup_compress_alg,
 	 (uchar*) &ibx_xtrabackup_compress_alg, 0,
 	 GET_STR, OPT_ARG, 0, 0, 0, 0, 0, 0},
@@ -554,7 +556,10 @@ static struct my_option ibx_long_options[] =
 
 	{"parallel", OPT_PARALLEL, "On backup, this option specifies the "
 	 "number of threads to use to back "
-	 "up files concurrently.  The option accepts an integer argument.",
+	 "up files concurrently. On --apply-log, it specifies the number "
+	 "of read I/O threads that apply the redo log, if larger than "
+	 "--innodb-read-io-threads; at most 64. The option accepts an "
+	 "integer argument.",
 	 (uchar*) &ibx_xtrabackup_parallel, (uchar*) &ibx_xtrabackup_parallel,
 	 0, GET_INT, REQUIRED_ARG, 1, 1, INT_MAX, 0, 0, 0},
 
@@ -695,7 +700,9 @@ cases when there is not enough free disk space to copy files.\n\
 The --decompress command will decompress a backup made\n\
 with the --compress option. The\n\
 --parallel option will allow multiple files to be decompressed\n\
-simultaneously. In order to decompress, the qpress utility MUST be installed\n\
+simultaneously, and the --compress-threads option will allow each zstd or\n\
+lz4 compressed file to be decompressed by multiple threads. In order to\n\
+decompress .qp files, the qpress utility MUST be installed\n\
 and accessible within the path. This process will remove the original\n\
 compressed files and leave the results in the same location.\n\
 \n\
@@ -742,7 +749,8 @@ ibx_get_one_option(const struct my_option *opt,
 	case OPT_COMPRESS:
 		if (argument == NULL)
 			xtrabackup_compress_alg = "quicklz";
-		else if (strcasecmp(argument, "quicklz"))
+		else if (strcasecmp(argument, "quicklz") &&
+			 compress_frame_ds_type(argument) == DS_TYPE_COMPRESS)
 		{
 			ibx_msg("Invalid --compress argument: %s\n", argument);
 			return 1;
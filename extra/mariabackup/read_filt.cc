@@ -26,6 +26,19 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1335  USA
 #include "common.h"
 #include "fil_cur.h"
 #include "xtrabackup.h"
+#include "buf0track.h"
+#include <my_dir.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+/** Numbers of the changed pages of each tablespace, sorted; FIL_NULL as
+the last element means that the entire tablespace must be read */
+static std::map<uint32_t, std::vector<uint32_t>> changed_pages;
+
+/** Maximum number of unchanged pages to read between two changed pages,
+so that nearby pages are read with one system call */
+static constexpr uint32_t CHANGED_PAGES_MAX_GAP = 8;
 
 /****************************************************************//**
 Perform read filter context initialization that is common to all read
@@ -71,3 +84,255 @@ xb_read_filt_t rf_pass_through = {
 	&rf_pass_through_init,
 	&rf_pass_through_get_next_batch,
 };
+
+/****************************************************************//**
+Initialize the changed page read filter.  */
+static
+void
+rf_changed_pages_init(
+	xb_read_filt_ctxt_t*	ctxt,	/*!<in/out: read filter context */
+	const xb_fil_cur_t*	cursor)	/*!<in: file cursor */
+{
+	rf_pass_through_init(ctxt, cursor);
+	ctxt->page_size = cursor->page_size;
+	ctxt->next_changed = 0;
+
+	auto i = changed_pages.find(cursor->space_id);
+	if (i == changed_pages.end()) {
+		/* No page was written after the incremental LSN. */
+		static const uint32_t	no_pages[1] = {FIL_NULL};
+		ctxt->changed_pages = no_pages;
+		ctxt->n_changed_pages = 0;
+	} else if (i->second.back() == FIL_NULL) {
+		ctxt->changed_pages = NULL;
+		ctxt->n_changed_pages = 0;
+	} else {
+		ctxt->changed_pages = i->second.data();
+		ctxt->n_changed_pages = i->second.size();
+	}
+}
+
+/****************************************************************//**
+Get the next batch of pages for the changed page read filter.  */
+static
+void
+rf_changed_pages_get_next_batch(
+/*============================*/
+	xb_read_filt_ctxt_t*	ctxt,			/*!<in/out: read filter
+							context */
+	int64_t*		read_batch_start,	/*!<out: starting read
+							offset in bytes for the
+							next batch of pages */
+	int64_t*		read_batch_len)		/*!<out: length in
+							bytes of the next batch
+							of pages */
+{
+	if (!ctxt->changed_pages) {
+		rf_pass_through_get_next_batch(ctxt, read_batch_start,
+					       read_batch_len);
+		return;
+	}
+
+	const int64_t	page_size = int64_t(ctxt->page_size);
+	const int64_t	n_pages = ctxt->data_file_size / page_size;
+	const int64_t	max_batch = int64_t(ctxt->buffer_capacity) / page_size;
+
+	*read_batch_start = 0;
+	*read_batch_len = 0;
+
+	if (ctxt->next_changed >= ctxt->n_changed_pages
+	    || ctxt->changed_pages[ctxt->next_changed] >= n_pages) {
+		ctxt->next_changed = ctxt->n_changed_pages;
+		return;
+	}
+
+	const uint32_t	first = ctxt->changed_pages[ctxt->next_changed++];
+	int64_t		end = int64_t(first) + 1;
+
+	while (ctxt->next_changed < ctxt->n_changed_pages) {
+		const int64_t next = ctxt->changed_pages[ctxt->next_changed];
+		if (next >= n_pages
+		    || next - end > CHANGED_PAGES_MAX_GAP
+		    || next + 1 - first > max_batch) {
+			break;
+		}
+		end = next + 1;
+		ctxt->next_changed++;
+	}
+
+	*read_batch_start = int64_t(first) * page_size;
+	*read_batch_len = (end - first) * page_size;
+	ctxt->offset = end * page_size;
+}
+
+/* The changed page read filter */
+xb_read_filt_t rf_changed_pages = {
+	&rf_changed_pages_init,
+	&rf_changed_pages_get_next_batch,
+};
+
+/** A changed page tracking file */
+struct changed_pages_file {
+	std::string	path;		/*!< path name */
+	lsn_t		start_lsn;	/*!< start LSN, from the file name */
+	lsn_t		end_lsn;	/*!< LSN of the close record,
+					or 0 if the file is not closed */
+};
+
+/****************************************************************//**
+Read a changed page tracking file, and note the pages of the intervals
+that end after from_lsn.
+@return whether the file header is valid */
+static
+bool
+changed_pages_read(
+	changed_pages_file&	file,		/*!<in/out: tracking file */
+	lsn_t			from_lsn)	/*!<in: start LSN of the
+						incremental backup */
+{
+	std::vector<byte>	buf;
+	MY_STAT			stat_info;
+	File			fd = my_open(file.path.c_str(),
+					     O_RDONLY | O_BINARY, MYF(MY_WME));
+
+	if (fd < 0) {
+		return false;
+	}
+
+	/* The server may be appending to the file. Any record that
+	is incomplete or fails the checksum will be ignored. */
+	bool	ok = !my_fstat(fd, &stat_info, MYF(MY_WME));
+	if (ok) {
+		buf.resize(size_t(stat_info.st_size));
+		ok = !my_read(fd, buf.data(), buf.size(), MYF(MY_WME | MY_NABP));
+	}
+	my_close(fd, MYF(MY_WME));
+
+	if (!ok || buf.size() < CHANGED_PAGES_HEADER_SIZE
+	    || mach_read_from_4(&buf[0]) != CHANGED_PAGES_MAGIC
+	    || mach_read_from_4(&buf[4]) != CHANGED_PAGES_VERSION
+	    || mach_read_from_8(&buf[8]) != file.start_lsn
+	    || mach_read_from_4(&buf[16]) != my_crc32c(0, &buf[0], 16)) {
+		msg("Warning: %s is not a valid changed page tracking file",
+		    file.path.c_str());
+		return false;
+	}
+
+	const byte*		b = &buf[CHANGED_PAGES_HEADER_SIZE];
+	const byte* const	end = buf.data() + buf.size();
+
+	while (size_t(end - b) >= CHANGED_PAGES_RECORD_SIZE + 4) {
+		const uint32_t	type = mach_read_from_4(b);
+		const size_t	n = mach_read_from_4(b + 4);
+		const lsn_t	lsn = mach_read_from_8(b + 8);
+		const size_t	len = CHANGED_PAGES_RECORD_SIZE + n * 8;
+
+		if (size_t(end - b) < len + 4
+		    || mach_read_from_4(b + len) != my_crc32c(0, b, len)) {
+			break;
+		}
+
+		if (type == CHANGED_PAGES_CLOSE) {
+			file.end_lsn = lsn;
+			break;
+		} else if (type != CHANGED_PAGES_INTERVAL) {
+			break;
+		}
+
+		if (lsn > from_lsn) {
+			for (const byte* p = b + CHANGED_PAGES_RECORD_SIZE;
+			     p != b + len; p += 8) {
+				changed_pages[mach_read_from_4(p)].push_back(
+					mach_read_from_4(p + 4));
+			}
+		}
+
+		b += len + 4;
+	}
+
+	return true;
+}
+
+/** Load the innodb_track_changed_pages files of the server.
+@param dir       the data directory
+@param from_lsn  start LSN of the incremental backup
+@return whether the files cover all pages that were changed after from_lsn
+and that were written before the latest checkpoint */
+bool xb_changed_pages_load(const char *dir, uint64_t from_lsn)
+{
+	std::vector<changed_pages_file>	files;
+	static const size_t	prefix_len = sizeof CHANGED_PAGES_FILE_PREFIX - 1;
+
+	ut_ad(changed_pages.empty());
+
+	MY_DIR*	d = my_dir(dir, MYF(0));
+	if (!d) {
+		return false;
+	}
+
+	for (size_t i = 0; i < d->number_of_files; i++) {
+		const char*	name = d->dir_entry[i].name;
+		char*		end;
+
+		if (strncmp(name, CHANGED_PAGES_FILE_PREFIX, prefix_len)) {
+			continue;
+		}
+
+		const lsn_t lsn = strtoull(name + prefix_len, &end, 10);
+		if (*end || end == name + prefix_len) {
+			continue;
+		}
+
+		files.push_back({std::string(dir) + '/' + name, lsn, 0});
+	}
+
+	my_dirend(d);
+
+	std::sort(files.begin(), files.end(),
+		  [](const changed_pages_file &a, const changed_pages_file &b)
+		  { return a.start_lsn < b.start_lsn; });
+
+	/* Find the last file that starts at or before from_lsn. Every
+	later file must start where the previous one was closed, and the
+	last file must still be open. */
+	auto	first = std::upper_bound(
+		files.begin(), files.end(), from_lsn,
+		[](lsn_t lsn, const changed_pages_file &f)
+		{ return lsn < f.start_lsn; });
+
+	if (first == files.begin()) {
+		msg("mariabackup: no changed page tracking data"
+		    " since LSN " LSN_PF, lsn_t(from_lsn));
+		return false;
+	}
+
+	for (auto i = --first; i != files.end(); i++) {
+		if (!changed_pages_read(*i, from_lsn)) {
+			goto fail;
+		}
+
+		if (i + 1 == files.end()
+		    ? i->end_lsn != 0 : i->end_lsn != (i + 1)->start_lsn) {
+			msg("mariabackup: changed page tracking data is"
+			    " incomplete after %s", i->path.c_str());
+			goto fail;
+		}
+	}
+
+	for (auto &s : changed_pages) {
+		std::sort(s.second.begin(), s.second.end());
+		s.second.erase(std::unique(s.second.begin(), s.second.end()),
+			       s.second.end());
+	}
+
+	return true;
+fail:
+	xb_changed_pages_free();
+	return false;
+}
+
+/** Free the memory allocated by xb_changed_pages_load(). */
+void xb_changed_pages_free()
+{
+	changed_pages.clear();
+}
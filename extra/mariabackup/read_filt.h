@@ -35,6 +35,11 @@ struct xb_read_filt_ctxt_t {
 	int64_t		offset;		/*!< current file offset */
 	int64_t		data_file_size;	/*!< data file size */
 	size_t		buffer_capacity;/*!< read buffer capacity */
+	size_t		page_size;	/*!< physical page size */
+	const uint32_t*	changed_pages;	/*!< sorted numbers of the pages
+					to read, or NULL to read all pages */
+	size_t		n_changed_pages;/*!< number of changed_pages */
+	size_t		next_changed;	/*!< next element of changed_pages */
 };
 
 /* The read filter */
@@ -47,5 +52,16 @@ struct xb_read_filt_t {
 };
 
 extern xb_read_filt_t rf_pass_through;
+extern xb_read_filt_t rf_changed_pages;
+
+/** Load the innodb_track_changed_pages files of the server.
+@param dir       the data directory
+@param from_lsn  start LSN of the incremental backup
+@return whether the files cover all pages that were changed after from_lsn
+and that were written before the latest checkpoint */
+bool xb_changed_pages_load(const char *dir, uint64_t from_lsn);
+
+/** Free the memory allocated by xb_changed_pages_load(). */
+void xb_changed_pages_free();
 
 #endif
@@ -44,6 +44,8 @@ dependencies */
 datasink_t datasink_archive;
 datasink_t datasink_xbstream;
 datasink_t datasink_compress;
+datasink_t datasink_compress_zstd;
+datasink_t datasink_compress_lz4;
 datasink_t datasink_tmpfile;
 
 static run_mode_t	opt_mode;
@@ -98,6 +98,7 @@ Street, Fifth Floor, Boston, MA 02110-1335 USA
 #include "xb_regex.h"
 #include "fil_cur.h"
 #include "write_filt.h"
+#include "ds_compress_frame.h"
 #include "ds_buffer.h"
 #include "ds_tmpfile.h"
 #include "xbstream.h"
@@ -274,6 +275,9 @@ char*	innobase_data_file_path;
 char *aria_log_dir_path;
 
 my_bool xtrabackup_incremental_force_scan = FALSE;
+/** whether --incremental reads only the pages that are listed in the
+innodb_track_changed_pages files */
+static bool xb_use_changed_pages;
 
 /*
  * Ignore corrupt pages (disabled by default; used
@@ -1495,32 +1499,31 @@ struct my_option xb_client_options[]= {
 
     {"compress", OPT_XTRA_COMPRESS,
      "Compress individual backup files using the "
-     "specified compression algorithm. It uses no longer maintained QuickLZ "
-     "library hence this option was deprecated with MariaDB 10.1.31 and 10.2.13.",
+     "specified compression algorithm: zstd, lz4 or quicklz (default). "
+     "The quicklz algorithm uses the no longer maintained QuickLZ "
+     "library and was deprecated with MariaDB 10.1.31 and 10.2.13.",
      (G_PTR *) &xtrabackup_compress_alg, (G_PTR *) &xtrabackup_compress_alg, 0,
      GET_STR, OPT_ARG, 0, 0, 0, 0, 0, 0},
 
     {"compress-threads", OPT_XTRA_COMPRESS_THREADS,
-     "Number of threads for parallel data compression. The default value is "
-     "1. "
-     "This option was deprecated as it relies on the no longer "
-     "maintained QuickLZ library.",
+     "Number of threads for parallel data compression, and for "
+     "parallel decompression of each zstd or lz4 compressed file. "
+     "The default value is 1.",
      (G_PTR *) &xtrabackup_compress_threads,
      (G_PTR *) &xtrabackup_compress_threads, 0, GET_UINT, REQUIRED_ARG, 1, 1,
      UINT_MAX, 0, 0, 0},
 
     {"compress-chunk-size", OPT_XTRA_COMPRESS_CHUNK_SIZE,
      "Size of working buffer(s) for compression threads in bytes. The default "
-     "value is 64K. "
-     "This option was deprecated as it relies on the no longer "
-     "maintained QuickLZ library.",
+     "value is 64K. For zstd and lz4, this is the size of the chunks that "
+     "are compressed independently of each other.",
      (G_PTR *) &xtrabackup_compress_chunk_size,
      (G_PTR *) &xtrabackup_compress_chunk_size, 0, GET_ULL, REQUIRED_ARG,
      (1 << 16), 1024, ULONGLONG_MAX, 0, 0, 0},
 
     {"incremental-force-scan", OPT_XTRA_INCREMENTAL_FORCE_SCAN,
      "Perform a full-scan incremental backup even in the presence of changed "
-     "page bitmap data",
+     "page tracking data (innodb_track_changed_pages)",
      (G_PTR *) &xtrabackup_incremental_force_scan,
      (G_PTR *) &xtrabackup_incremental_force_scan, 0, GET_BOOL, NO_ARG, 0, 0,
      0, 0, 0, 0},
@@ -1624,10 +1627,9 @@ struct my_option xb_client_options[]= {
      NO_ARG, 0, 0, 0, 0, 0, 0},
 
     {"decompress", OPT_DECOMPRESS,
-     "Decompresses all files with the .qp "
+     "Decompresses all files with the .qp, .zst or .lz4 "
      "extension in a backup previously made with the --compress option. "
-     "This option was deprecated as it relies on the no longer "
-     "maintained QuickLZ library.",
+     "Decompressing .qp files requires the qpress utility.",
      (uchar *) &opt_decompress, (uchar *) &opt_decompress, 0, GET_BOOL, NO_ARG,
      0, 0, 0, 0, 0, 0},
 
@@ -1695,7 +1697,7 @@ struct my_option xb_client_options[]= {
      0, 0, 0, 0},
 
     {"remove-original", OPT_REMOVE_ORIGINAL,
-     "Remove .qp files after decompression.", (uchar *) &opt_remove_original,
+     "Remove compressed files after decompression.", (uchar *) &opt_remove_original,
      (uchar *) &opt_remove_original, 0, GET_BOOL, NO_ARG, 0, 0, 0, 0, 0, 0},
 
     {"ftwrl-wait-query-type", OPT_LOCK_WAIT_QUERY_TYPE,
@@ -1808,6 +1810,9 @@ struct my_option xb_server_options[] =
    (G_PTR*) &opt_mysql_tmpdir, 0, GET_STR, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
   {"parallel", OPT_XTRA_PARALLEL,
    "Number of threads to use for parallel datafiles transfer. "
+   "On --prepare, the number of read I/O threads that apply the redo log "
+   "to the pages they read, if it is larger than innodb_read_io_threads; "
+   "at most 64. "
    "The default value is 1.",
    (G_PTR*) &xtrabackup_parallel, (G_PTR*) &xtrabackup_parallel, 0, GET_UINT,
    REQUIRED_ARG, 1, 1, INT_MAX, 0, 0, 0},
@@ -2306,7 +2311,8 @@ xb_get_one_option(const struct my_option *opt,
   case OPT_XTRA_COMPRESS:
     if (argument == NULL)
       xtrabackup_compress_alg = "quicklz";
-    else if (strcasecmp(argument, "quicklz"))
+    else if (strcasecmp(argument, "quicklz") &&
+             compress_frame_ds_type(argument) == DS_TYPE_COMPRESS)
     {
       msg("Invalid --compress argument: %s", argument);
       return 1;
@@ -2489,6 +2495,14 @@ static bool innodb_init_param()
 	srv_n_read_io_threads = (uint) innobase_read_io_threads;
 	srv_n_write_io_threads = (uint) innobase_write_io_threads;
 
+	/* On --prepare, the redo log is applied to the pages in the
+	read completion callbacks, for up to srv_n_read_io_threads pages
+	of any tablespaces concurrently. This is only a tuning knob for
+	that concurrency; the limit is that of innodb_read_io_threads. */
+	if (xtrabackup_prepare && xtrabackup_parallel > srv_n_read_io_threads) {
+		srv_n_read_io_threads = std::min(xtrabackup_parallel, 64U);
+	}
+
 	srv_max_n_open_files = ULINT_UNDEFINED - 5;
 
 	srv_print_verbose_log = verbose ? 2 : 1;
@@ -3272,7 +3286,11 @@ static my_bool xtrabackup_copy_datafile(ds_ctxt *ds_data,
 		goto skip;
 	}
 
-	read_filter = &rf_pass_through;
+	/* The page numbers in changed_pages are relative to the start
+	of the tablespace, not to the start of each file. */
+	read_filter = xb_use_changed_pages
+		&& UT_LIST_GET_LEN(node->space->chain) == 1
+		? &rf_changed_pages : &rf_pass_through;
 
 	res = xb_fil_cur_open(&cursor, read_filter, node, thread_n, ULLONG_MAX);
 	if (res == XB_FIL_CUR_SKIP) {
@@ -3673,12 +3691,14 @@ void Backup_datasinks::init()
 			m_redo = m_data = ds;
 		}
 
-		ds = ds_create(xtrabackup_target_dir, DS_TYPE_COMPRESS);
+		const ds_type_t compress_type =
+			compress_frame_ds_type(xtrabackup_compress_alg);
+		ds = ds_create(xtrabackup_target_dir, compress_type);
 		add_datasink_to_destroy(ds);
 		ds_set_pipe(ds, m_data);
 		if (m_data != m_redo) {
 			m_data = ds;
-			ds = ds_create(xtrabackup_target_dir, DS_TYPE_COMPRESS);
+			ds = ds_create(xtrabackup_target_dir, compress_type);
 			add_datasink_to_destroy(ds);
 			ds_set_pipe(ds, m_redo);
 			m_redo = ds;
@@ -5439,6 +5459,26 @@ static bool xtrabackup_backup_func()
 				"Waiting for table metadata lock", 0, 0););
 	}
 
+	/* The checkpoint that we will apply the redo log from has been
+	written, and therefore any older changes are covered by the
+	tracking files. Because a server that fails to write the files
+	will set innodb_track_changed_pages=OFF, check the variable again
+	after reading the files. */
+	if (xtrabackup_incremental && !xtrabackup_incremental_force_scan
+	    && have_changed_page_tracking(mysql_connection)) {
+		xb_use_changed_pages = xb_changed_pages_load(
+			fil_path_to_mysql_datadir, incremental_lsn)
+			&& have_changed_page_tracking(mysql_connection);
+		if (xb_use_changed_pages) {
+			msg("mariabackup: using changed page tracking"
+			    " since LSN " LSN_PF, incremental_lsn);
+		} else {
+			xb_changed_pages_free();
+			msg("mariabackup: scanning all pages for the"
+			    " incremental backup");
+		}
+	}
+
 	BackupStages stages(backup_datasinks.m_data);
 
 	if (!stages.init())
@@ -5469,6 +5509,7 @@ static bool xtrabackup_backup_func()
 	msg("Redo log (from LSN " LSN_PF " to " LSN_PF ") was copied.",
 	    log_sys.next_checkpoint_lsn, recv_sys.lsn);
 	xb_filters_free();
+	xb_changed_pages_free();
 
 	xb_data_files_close();
 
@@ -6717,6 +6758,8 @@ static bool xtrabackup_prepare_func(char** argv)
 
 	msg("mariabackup: Using %lld bytes for buffer pool "
 	    "(set by --use-memory parameter)", xtrabackup_use_memory);
+	msg("mariabackup: Applying the log with up to %u threads",
+	    srv_n_read_io_threads);
 
 	srv_max_buf_pool_modified_pct = (double)max_buf_pool_modified_pct;
 
@@ -6728,6 +6771,11 @@ static bool xtrabackup_prepare_func(char** argv)
 		goto error;
 	}
 
+	if (recv_sys.max_applying) {
+		msg("mariabackup: The log was applied by up to %u threads"
+		    " concurrently", uint32_t{recv_sys.max_applying});
+	}
+
 	ut_ad(!fil_system.freeze_space_list);
 
         corrupted_pages.read_from_file(MB_CORRUPTED_PAGES_FILE);
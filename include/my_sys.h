@@ -785,6 +785,9 @@ extern my_bool radixsort_is_applicable(uint n_items, size_t size_of_element);
 extern void my_string_ptr_sort(uchar *base,uint items,size_t size);
 extern void radixsort_for_str_ptr(uchar* base[], uint number_of_elements,
 				  size_t size_of_element,uchar *buffer[]);
+extern void radixsort_msd_for_str_ptr(uchar* base[], uint number_of_elements,
+                                      size_t size_of_element, size_t offset,
+                                      uchar *buffer[]);
 extern qsort_t my_qsort(void *base_ptr, size_t total_elems, size_t size,
                         qsort_cmp cmp);
 extern qsort_t my_qsort2(void *base_ptr, size_t total_elems, size_t size,
@@ -937,6 +940,15 @@ extern void *my_az_allocator(void *dummy, unsigned int items, unsigned int size)
 extern void my_az_free(void *dummy, void *address);
 extern int my_compress_buffer(uchar *dest, size_t *destLen,
                               const uchar *source, size_t sourceLen);
+typedef struct st_my_compress_stream MY_COMPRESS_STREAM;
+extern MY_COMPRESS_STREAM *my_compress_stream_alloc(void);
+extern void my_compress_stream_free(MY_COMPRESS_STREAM *stream);
+extern my_bool my_compress_stream(MY_COMPRESS_STREAM *stream, int level,
+                                  uchar *to, const uchar *packet,
+                                  size_t *len, size_t *complen);
+extern my_bool my_uncompress_stream(MY_COMPRESS_STREAM *stream,
+                                    uchar *packet, size_t len,
+                                    size_t *complen);
 extern int packfrm(const uchar *, size_t, uchar **, size_t *);
 extern int unpackfrm(uchar **, size_t *, const uchar *);
 
@@ -11,10 +11,16 @@ return "No mariabackup" unless $ENV{XTRABACKUP};
 
 my $have_qpress = index(`qpress 2>&1`,"Compression") > 0;
 
+# --compress only accepts the algorithms that mariabackup was built with
+sub have_compress {
+  system("$ENV{XTRABACKUP} --compress=$_[0] --help >/dev/null 2>&1") == 0;
+}
+
 sub skip_combinations {
   my %skip;
   $skip{'include/have_file_key_management.inc'} = 'needs file_key_management plugin'  unless $ENV{FILE_KEY_MANAGEMENT_SO};
   $skip{'compress_qpress.test'}= 'needs qpress executable in PATH' unless $have_qpress;
+  $skip{'compress_frame.combinations'}= [ grep { !have_compress($_) } qw(zstd lz4) ];
   %skip;
 }
 
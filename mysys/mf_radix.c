@@ -58,3 +58,127 @@ void radixsort_for_str_ptr(uchar **base, uint number_of_elements, size_t size_of
   next:;
   }
 }
+
+
+/*
+  MSD (most significant byte first) radixsort for pointers to fixed length
+  strings, ordering them as memcmp() does.
+
+  Unlike radixsort_for_str_ptr() it only looks at as many bytes as are
+  needed to tell the strings apart, so it works for long strings too:
+  - bytes that are equal in all strings of a bucket are skipped in one
+    sequential scan of each string instead of one pass over all pointers
+    per byte,
+  - small buckets are finished with an insertion sort on the remaining
+    bytes.
+  Recursion only goes into the buckets that are not the largest one, which
+  have at most half of the elements, so its depth is below 32.
+
+  'buffer' must have room for number_of_elements pointers.
+*/
+
+#define RADIX_MSD_INSERTION_SORT_LIMIT 32
+
+static void insertion_sort_str_ptr(uchar **base, uint number_of_elements,
+                                   size_t offset, size_t size_of_element)
+{
+  uchar **end= base + number_of_elements, **ptr, **prev;
+  size_t length= size_of_element - offset;
+
+  for (ptr= base + 1; ptr < end; ptr++)
+  {
+    uchar *key= *ptr;
+    for (prev= ptr; prev > base && memcmp(prev[-1] + offset, key + offset,
+                                          length) > 0; prev--)
+      *prev= prev[-1];
+    *prev= key;
+  }
+}
+
+
+/* Length of the prefix, starting at offset, that all strings share */
+
+static size_t common_prefix_str_ptr(uchar **base, uint number_of_elements,
+                                    size_t offset, size_t size_of_element)
+{
+  uchar **end= base + number_of_elements, **ptr;
+  const uchar *first= base[0] + offset;
+  size_t prefix= size_of_element - offset;
+
+  for (ptr= base + 1; ptr < end && prefix; ptr++)
+  {
+    const uchar *key= *ptr + offset;
+    size_t i;
+    for (i= 0; i < prefix && key[i] == first[i]; i++)
+    {}
+    prefix= i;
+  }
+  return prefix;
+}
+
+
+void radixsort_msd_for_str_ptr(uchar **base, uint number_of_elements,
+                               size_t size_of_element, size_t offset,
+                               uchar **buffer)
+{
+  uint32 count[256];
+
+  for (;;)
+  {
+    uchar **ptr, **end;
+    uint32 start, largest_start, largest_size;
+    uint i;
+
+    if (number_of_elements <= RADIX_MSD_INSERTION_SORT_LIMIT)
+    {
+      if (number_of_elements > 1 && offset < size_of_element)
+        insertion_sort_str_ptr(base, number_of_elements, offset,
+                               size_of_element);
+      return;
+    }
+    offset+= common_prefix_str_ptr(base, number_of_elements, offset,
+                                   size_of_element);
+    if (offset == size_of_element)
+      return;                                   /* All strings are equal */
+
+    /* Distribute on the byte at 'offset' */
+    end= base + number_of_elements;
+    bzero((uchar*) count, sizeof(count));
+    for (ptr= base; ptr < end; ptr++)
+      count[ptr[0][offset]]++;
+    for (i= 0, start= 0; i < 256; i++)
+    {
+      uint32 size= count[i];
+      count[i]= start;
+      start+= size;
+    }
+    for (ptr= base; ptr < end; ptr++)
+      buffer[count[ptr[0][offset]]++]= *ptr;
+    memcpy(base, buffer, number_of_elements * sizeof(uchar*));
+
+    /*
+      Now count[i] is the end of bucket i. Sort all buckets but the largest
+      one recursively, and continue with the largest one in this loop.
+    */
+    offset++;
+    largest_start= largest_size= 0;
+    for (i= 0, start= 0; i < 256; start= count[i++])
+    {
+      uint32 size= count[i] - start;
+      if (size <= largest_size)
+      {
+        if (size > 1)
+          radixsort_msd_for_str_ptr(base + start, size, size_of_element,
+                                    offset, buffer);
+        continue;
+      }
+      if (largest_size > 1)
+        radixsort_msd_for_str_ptr(base + largest_start, largest_size,
+                                  size_of_element, offset, buffer);
+      largest_start= start;
+      largest_size= size;
+    }
+    base+= largest_start;
+    number_of_elements= largest_size;
+  }
+}
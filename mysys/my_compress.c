@@ -183,4 +183,197 @@ my_bool my_uncompress(uchar *packet, size_t len, size_t *complen)
   DBUG_RETURN(0);
 }
 
+
+/*
+  Compression state of a connection.
+
+  my_compress() and my_uncompress() initialize a zlib stream for every
+  packet, and deflateInit() alone allocates more than 256K. A
+  MY_COMPRESS_STREAM keeps the deflate and inflate streams between the
+  packets and only resets them. Every packet is still a complete zlib
+  stream of its own, so the peer can uncompress it with uncompress().
+*/
+
+/* Larger inflate buffers are freed after each packet */
+#define COMPRESS_STREAM_MAX_BUFFER (1024*1024)
+
+struct st_my_compress_stream
+{
+  z_stream deflate_stream, inflate_stream;
+  my_bool deflate_ready, inflate_ready;
+  int level;
+  uchar *buf;                                   /* For my_uncompress_stream */
+  size_t buf_size;
+};
+
+
+MY_COMPRESS_STREAM *my_compress_stream_alloc(void)
+{
+  return (MY_COMPRESS_STREAM*) my_malloc(key_memory_my_compress_alloc,
+                                         sizeof(MY_COMPRESS_STREAM),
+                                         MYF(MY_ZEROFILL));
+}
+
+
+void my_compress_stream_free(MY_COMPRESS_STREAM *stream)
+{
+  if (!stream)
+    return;
+  if (stream->deflate_ready)
+    deflateEnd(&stream->deflate_stream);
+  if (stream->inflate_ready)
+    inflateEnd(&stream->inflate_stream);
+  my_free(stream->buf);
+  my_free(stream);
+}
+
+
+/*
+  Compress a packet with the deflate stream of a connection
+
+  SYNOPSIS
+    my_compress_stream()
+    stream	Compression state of the connection
+    level	zlib compression level
+    to		Buffer of at least 'len' bytes for the compressed data
+    packet	Data to compress
+    len		Length of data to compress at 'packet'
+    complen	out: 0 if packet was not compressed
+
+  NOTES
+    Unlike my_compress(), the packet is not modified. If the packet is
+    not compressed, the contents of 'to' is undefined.
+
+  RETURN
+    1   error. 'len' is not changed
+    0   ok.  In this case 'len' contains the size of the compressed packet
+*/
+
+my_bool my_compress_stream(MY_COMPRESS_STREAM *stream, int level, uchar *to,
+                           const uchar *packet, size_t *len, size_t *complen)
+{
+  z_stream *z= &stream->deflate_stream;
+  int err;
+  DBUG_ENTER("my_compress_stream");
+
+  *complen= 0;
+  if (*len < MIN_COMPRESS_LENGTH)
+  {
+    DBUG_PRINT("note",("Packet too short: Not compressed"));
+    DBUG_RETURN(0);
+  }
+
+  if (stream->deflate_ready && stream->level == level)
+    err= deflateReset(z);
+  else
+  {
+    if (stream->deflate_ready)
+      deflateEnd(z);
+    z->zalloc= (alloc_func) my_az_allocator;
+    z->zfree= (free_func) my_az_free;
+    z->opaque= (voidpf) 0;
+    err= deflateInit(z, level);
+    stream->deflate_ready= err == Z_OK;
+    stream->level= level;
+  }
+  if (err != Z_OK)
+    DBUG_RETURN(1);
+
+  /* The output must be shorter than the input to be of any use */
+  z->next_in= (Bytef*) packet;
+  z->avail_in= (uInt) *len;
+  z->next_out= (Bytef*) to;
+  z->avail_out= (uInt) *len - 1;
+  if ((size_t) z->avail_in != *len)
+    DBUG_RETURN(1);
+
+  if (deflate(z, Z_FINISH) != Z_STREAM_END)
+  {
+    DBUG_PRINT("note",("Packet got longer on compression; Not compressed"));
+    DBUG_RETURN(0);
+  }
+  *complen= *len;
+  *len= (size_t) z->total_out;
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Uncompress a packet with the inflate stream of a connection
+
+  SYNOPSIS
+    my_uncompress_stream()
+    stream	Compression state of the connection
+    packet	Compressed data. This is is replaced with the original data.
+    len		Length of compressed data
+    complen	Length of the packet buffer (must be enough for the original
+	        data)
+
+  RETURN
+    1   error
+    0   ok.  In this case 'complen' contains the updated size of the
+             real data.
+*/
+
+my_bool my_uncompress_stream(MY_COMPRESS_STREAM *stream, uchar *packet,
+                             size_t len, size_t *complen)
+{
+  z_stream *z= &stream->inflate_stream;
+  uchar *buf= stream->buf;
+  my_bool error;
+  DBUG_ENTER("my_uncompress_stream");
+
+  if (!*complen)                                /* Not compressed */
+  {
+    *complen= len;
+    DBUG_RETURN(0);
+  }
+
+  if (stream->inflate_ready)
+  {
+    if (inflateReset(z) != Z_OK)
+      DBUG_RETURN(1);
+  }
+  else
+  {
+    z->zalloc= (alloc_func) my_az_allocator;
+    z->zfree= (free_func) my_az_free;
+    z->opaque= (voidpf) 0;
+    z->next_in= Z_NULL;
+    z->avail_in= 0;
+    if (inflateInit(z) != Z_OK)
+      DBUG_RETURN(1);
+    stream->inflate_ready= 1;
+  }
+
+  if (*complen > stream->buf_size)
+  {
+    if (!(buf= (uchar*) my_malloc(key_memory_my_compress_alloc, *complen,
+                                  MYF(MY_WME))))
+      DBUG_RETURN(1);                           /* Not enough memory */
+    if (*complen <= COMPRESS_STREAM_MAX_BUFFER)
+    {
+      my_free(stream->buf);
+      stream->buf= buf;
+      stream->buf_size= *complen;
+    }
+  }
+
+  z->next_in= (Bytef*) packet;
+  z->avail_in= (uInt) len;
+  z->next_out= (Bytef*) buf;
+  z->avail_out= (uInt) *complen;
+  error= inflate(z, Z_FINISH) != Z_STREAM_END;
+  if (error)
+    DBUG_PRINT("error",("Can't uncompress packet"));     /* Wrong packet */
+  else
+  {
+    *complen= (size_t) z->total_out;
+    memcpy(packet, buf, *complen);
+  }
+  if (buf != stream->buf)
+    my_free(buf);
+  DBUG_RETURN(error);
+}
+
 #endif /* HAVE_COMPRESS */
@@ -35,6 +35,7 @@
 #include "filesort_utils.h"
 #include "sql_select.h"
 #include "debug_sync.h"
+#include <atomic>
 
 	/* functions defined in this file */
 
@@ -1548,14 +1549,262 @@ static bool save_index(Sort_param *param, uint count,
 }
 
 
+/*
+  Parallel intermediate merge passes.
+
+  The groups of chunks that one pass of merge_many_buff() merges are
+  independent of each other, so they can be merged by several threads.
+  Each thread gets an equal slice of the sort buffer, which keeps the
+  memory used by the sort within sort_buffer_size. The output of a group
+  is never longer than its input, so every group is written to the same
+  offset in the output file as its first chunk has in the input file.
+  The threads write with pwrite() through their own IO_CACHE, and read
+  the input with my_b_pread(), so the file offset is never shared.
+*/
+
+/**
+  A parallel merge must be able to read at least this many keys for
+  every chunk it merges, otherwise it is not worth splitting the buffer.
+*/
+#define MIN_MERGE_KEYS_PER_CHUNK 64
+
+struct Merge_job
+{
+  Merge_chunk *first, *last;
+  my_off_t to_start_filepos;
+  Merge_chunk result;
+};
+
+struct Merge_pass
+{
+  Sort_param *param;
+  IO_CACHE *from_file;
+  File to_file;
+  Merge_job *jobs;
+  uint job_count;
+  std::atomic<uint> next_job;
+  std::atomic<bool> error;
+};
+
+struct Merge_worker
+{
+  Merge_pass *pass;
+  Sort_buffer buffer;
+  uint jobs_done;
+  my_off_t end_of_file;
+  pthread_t thread_id;
+};
+
+
+/**
+  IO_CACHE write function of a merge worker: like _my_b_cache_write(),
+  but with a positioned write so that the file offset is not used.
+*/
+
+static int merge_pwrite(IO_CACHE *info, const uchar *buffer, size_t count)
+{
+  if (buffer != info->write_buffer)
+  {
+    count&= ~((size_t) IO_SIZE - 1);
+    if (!count)
+      return 0;
+  }
+  if (mysql_file_pwrite(info->file, buffer, count, info->pos_in_file,
+                        info->myflags | MY_NABP))
+    return info->error= -1;
+  info->pos_in_file+= count;
+  return 0;
+}
+
+
+static void merge_worker_run(Merge_worker *worker)
+{
+  Merge_pass *pass= worker->pass;
+  uint job_no;
+
+  while ((job_no= pass->next_job++) < pass->job_count && !pass->error)
+  {
+    Merge_job *job= pass->jobs + job_no;
+    IO_CACHE to_cache;
+    bool error;
+
+    if (init_io_cache(&to_cache, pass->to_file, DISK_CHUNK_SIZE, WRITE_CACHE,
+                      job->to_start_filepos, 0, MYF(0)))
+    {
+      pass->error= true;
+      break;
+    }
+    to_cache.write_function= merge_pwrite;
+    error= merge_buffers(pass->param, pass->from_file, &to_cache,
+                         worker->buffer, &job->result, job->first, job->last,
+                         0) ||
+           flush_io_cache(&to_cache);
+    set_if_bigger(worker->end_of_file, my_b_tell(&to_cache));
+    end_io_cache(&to_cache);
+    if (error)
+    {
+      pass->error= true;
+      break;
+    }
+    worker->jobs_done++;
+  }
+}
+
+
+static void *merge_worker_thread(void *arg)
+{
+  my_thread_init();
+  merge_worker_run((Merge_worker*) arg);
+  my_thread_end();
+  return 0;
+}
+
+
+/**
+  Number of threads to use for a merge pass of 'job_count' merges.
+
+  @retval 1  The pass should be done by the connection thread alone
+*/
+
+static uint merge_pass_threads(THD *thd, Sort_param *param,
+                               IO_CACHE *from_file, IO_CACHE *to_file,
+                               uint job_count)
+{
+  uint threads= thd->variables.sort_merge_threads;
+
+  /*
+    Unique::get() keeps its state in param->unique_buff, and encrypted
+    temporary files can only be read and written sequentially.
+  */
+  if (threads <= 1 || param->unique_buff ||
+      ((from_file->myflags | to_file->myflags) & MY_ENCRYPT))
+    return 1;
+  set_if_smaller(threads, job_count);
+  set_if_smaller(threads, param->max_keys_per_buffer /
+                          (MERGEBUFF2 * MIN_MERGE_KEYS_PER_CHUNK));
+  return MY_MAX(threads, 1);
+}
+
+
+/**
+  Do one pass of merge_many_buff() with 'threads' threads.
+
+  The connection thread takes part in the merge, so the pass is completed
+  even if no worker thread could be started.
+
+  @param[out] lastbuff  The chunk after the last merged chunk
+
+  @retval 0  OK
+  @retval 1  Error
+*/
+
+static bool merge_pass_parallel(THD *thd, Sort_param *param,
+                                Sort_buffer sort_buffer,
+                                Merge_chunk *buffpek, uint maxbuffer,
+                                IO_CACHE *from_file, IO_CACHE *to_file,
+                                uint threads, Merge_chunk **lastbuff)
+{
+  Merge_pass pass;
+  Merge_worker *workers;
+  uint i, job_count= 0;
+  uint max_keys_per_buffer= param->max_keys_per_buffer;
+  size_t slice_size= sort_buffer.size() / threads;
+  my_off_t end_of_file= 0;
+  bool error;
+  DBUG_ENTER("merge_pass_parallel");
+
+  if (to_file->file < 0 && real_open_cached_file(to_file))
+    DBUG_RETURN(1);
+
+  if (!(pass.jobs= (Merge_job*) my_malloc(PSI_INSTRUMENT_ME,
+                                          sizeof(Merge_job) *
+                                          (maxbuffer / MERGEBUFF + 1),
+                                          MYF(MY_WME | MY_ZEROFILL))) ||
+      !(workers= (Merge_worker*) my_malloc(PSI_INSTRUMENT_ME,
+                                           sizeof(Merge_worker) * threads,
+                                           MYF(MY_WME | MY_ZEROFILL))))
+  {
+    my_free(pass.jobs);
+    DBUG_RETURN(1);
+  }
+
+  /* Same grouping of chunks as in merge_many_buff() */
+  for (i= 0; i <= maxbuffer - MERGEBUFF * 3 / 2 ; i+= MERGEBUFF)
+  {
+    pass.jobs[job_count].first= buffpek + i;
+    pass.jobs[job_count++].last= buffpek + i + MERGEBUFF - 1;
+  }
+  pass.jobs[job_count].first= buffpek + i;
+  pass.jobs[job_count++].last= buffpek + maxbuffer;
+  for (i= 0; i < job_count; i++)
+    pass.jobs[i].to_start_filepos= pass.jobs[i].first->file_position();
+
+  pass.param= param;
+  pass.from_file= from_file;
+  pass.to_file= to_file->file;
+  pass.job_count= job_count;
+  pass.next_job= 0;
+  pass.error= false;
+
+  /* The threads share the sort buffer, see merge_buffers() */
+  param->max_keys_per_buffer= max_keys_per_buffer / threads;
+  param->merge_owner= thd;
+
+  for (i= 0; i < threads; i++)
+  {
+    workers[i].pass= &pass;
+    workers[i].buffer= Sort_buffer(sort_buffer.array() + i * slice_size,
+                                   slice_size);
+  }
+  for (i= 1; i < threads; i++)
+  {
+    if (mysql_thread_create(key_thread_filesort_merge, &workers[i].thread_id,
+                            NULL, merge_worker_thread, workers + i))
+      break;
+  }
+  threads= i;
+
+  merge_worker_run(workers);
+
+  for (i= 1; i < threads; i++)
+  {
+    pthread_join(workers[i].thread_id, NULL);
+    /* merge_buffers() counts only the passes of the connection thread */
+    for (uint job= 0; job < workers[i].jobs_done; job++)
+    {
+      thd->inc_status_sort_merge_passes();
+      thd->query_plan_fsort_passes++;
+    }
+  }
+  for (i= 0; i < threads; i++)
+    set_if_bigger(end_of_file, workers[i].end_of_file);
+
+  param->max_keys_per_buffer= max_keys_per_buffer;
+  param->merge_owner= NULL;
+
+  if (!(error= pass.error))
+  {
+    for (i= 0; i < job_count; i++)
+      buffpek[i]= pass.jobs[i].result;
+    *lastbuff= buffpek + job_count;
+    /* Make my_b_tell(to_file) return the end of the merged data */
+    error= reinit_io_cache(to_file, WRITE_CACHE, end_of_file, 0, 1);
+  }
+  my_free(workers);
+  my_free(pass.jobs);
+  DBUG_RETURN(error);
+}
+
+
 /** Merge buffers to make < MERGEBUFF2 buffers. */
 
 int merge_many_buff(Sort_param *param, Sort_buffer sort_buffer,
                     Merge_chunk *buffpek, uint *maxbuffer, IO_CACHE *t_file)
 {
-  uint i;
+  uint i, threads;
   IO_CACHE t_file2,*from_file,*to_file,*temp;
   Merge_chunk *lastbuff;
+  THD *thd= current_thd;
   DBUG_ENTER("merge_many_buff");
 
   if (*maxbuffer < MERGEBUFF2)
@@ -1573,15 +1822,26 @@ int merge_many_buff(Sort_param *param, Sort_buffer sort_buffer,
     if (reinit_io_cache(to_file, WRITE_CACHE,0L, 0, 0))
       goto cleanup;
     lastbuff=buffpek;
-    for (i= 0; i <= *maxbuffer - MERGEBUFF * 3 / 2 ; i+= MERGEBUFF)
+    threads= merge_pass_threads(thd, param, from_file, to_file,
+                                (*maxbuffer - MERGEBUFF * 3 / 2) / MERGEBUFF + 2);
+    if (threads > 1)
+    {
+      if (merge_pass_parallel(thd, param, sort_buffer, buffpek, *maxbuffer,
+                              from_file, to_file, threads, &lastbuff))
+        break;
+    }
+    else
     {
+      for (i= 0; i <= *maxbuffer - MERGEBUFF * 3 / 2 ; i+= MERGEBUFF)
+      {
+        if (merge_buffers(param, from_file, to_file, sort_buffer, lastbuff++,
+                          buffpek + i, buffpek + i + MERGEBUFF - 1, 0))
+        goto cleanup;
+      }
       if (merge_buffers(param, from_file, to_file, sort_buffer, lastbuff++,
-                        buffpek + i, buffpek + i + MERGEBUFF - 1, 0))
-      goto cleanup;
+                        buffpek + i, buffpek + *maxbuffer, 0))
+        break;					/* purecov: inspected */
     }
-    if (merge_buffers(param, from_file, to_file, sort_buffer, lastbuff++,
-                      buffpek + i, buffpek + *maxbuffer, 0))
-      break;					/* purecov: inspected */
     if (flush_io_cache(to_file))
       break;					/* purecov: inspected */
     temp=from_file; from_file=to_file; to_file=temp;
@@ -1753,11 +2013,15 @@ bool merge_buffers(Sort_param *param, IO_CACHE *from_file,
   uchar *src;
   uchar *unique_buff= param->unique_buff;
   const bool killable= !param->not_killable;
+  /* NULL in a merge worker thread, see merge_pass_parallel() */
   THD* const thd=current_thd;
   DBUG_ENTER("merge_buffers");
 
-  thd->inc_status_sort_merge_passes();
-  thd->query_plan_fsort_passes++;
+  if (thd)
+  {
+    thd->inc_status_sort_merge_passes();
+    thd->query_plan_fsort_passes++;
+  }
 
   rec_length= param->rec_length;
   res_length= param->res_length;
@@ -1841,7 +2105,8 @@ bool merge_buffers(Sort_param *param, IO_CACHE *from_file,
 
   while (queue.elements > 1)
   {
-    if (killable && unlikely(thd->check_killed()))
+    if (killable && unlikely(thd ? thd->check_killed() :
+                             param->merge_owner->killed != NOT_KILLED))
       goto err;                               /* purecov: inspected */
 
     for (;;)
@@ -23,6 +23,9 @@
 
 PSI_memory_key key_memory_Filesort_buffer_sort_keys;
 
+/* Don't use radix sort for fewer rows than this */
+#define MIN_RADIX_SORT_ROWS 1000
+
 const LEX_CSTRING filesort_names[]=
 {
   { STRING_WITH_LEN("priority_queue with addon fields")},
@@ -70,6 +73,33 @@ double get_qsort_sort_cost(ha_rows num_rows, bool with_addon_fields)
 }
 
 
+/**
+  Compute the cost of sorting fixed length, memcmp-comparable keys with
+  radixsort_msd_for_str_ptr().
+  @param num_rows           How many rows will be sorted.
+  @param key_length         Length of the sort keys.
+
+  Every distribution pass reads one byte of each key and moves each pointer
+  twice. The keys are usually told apart after log256(num_rows) bytes.
+  Prefixes shared by all keys of a bucket are skipped with one sequential
+  read per key and are not counted.
+
+  @retval
+    Cost of the operation.
+*/
+
+double get_radix_sort_cost(ha_rows num_rows, size_t key_length)
+{
+  const double pass_cost= RADIX_SORT_SLOWNESS_CORRECTION_FACTOR *
+                          (2 * DEFAULT_KEY_COPY_COST +
+                           DEFAULT_KEY_COMPARE_COST);
+  const double passes= MY_MIN((double) key_length,
+                              log2(1.0 + num_rows) / 8 + 1);
+
+  return pass_cost * num_rows * passes;
+}
+
+
 /**
   Compute the cost of sorting num_rows and only retrieving queue_size rows.
   @param num_rows           How many rows will be sorted.
@@ -395,13 +425,19 @@ void Filesort_buffer::sort_buffer(const Sort_param *param, uint count)
   if (!param->using_pq)
     reverse_record_pointers();
 
+  /*
+    Keys that are not packed are compared with memcmp() over sort_length
+    bytes, which allows a radix sort. For small buffers the comparison sort
+    is good enough and saves the extra pointer array.
+  */
   uchar **buffer= NULL;
   if (!param->using_packed_sortkeys() &&
-      radixsort_is_applicable(count, param->sort_length) &&
+      count >= MIN_RADIX_SORT_ROWS &&
+      get_radix_sort_cost(count, size) < get_qsort_sort_cost(count, false) &&
       (buffer= (uchar**) my_malloc(PSI_INSTRUMENT_ME, count*sizeof(char*),
                                    MYF(MY_THREAD_SPECIFIC))))
   {
-    radixsort_for_str_ptr(m_sort_keys, count, param->sort_length, buffer);
+    radixsort_msd_for_str_ptr(m_sort_keys, count, size, 0, buffer);
     my_free(buffer);
     return;
   }
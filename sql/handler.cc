@@ -7362,12 +7362,14 @@ static int binlog_log_row_to_binlog(TABLE* table,
   if (thd->variables.option_bits & OPTION_GTID_BEGIN)
     has_trans= 1;
 
-  auto *cache= binlog_get_cache_data(cache_mngr,
-                                     use_trans_cache(thd, has_trans));
+  bool trans_cache= use_trans_cache(thd, has_trans);
+  auto *cache= binlog_get_cache_data(cache_mngr, trans_cache);
 
     error= (*log_func)(thd, table, mysql_bin_log.as_event_log(), cache,
                        has_trans, thd->variables.binlog_row_image,
                        before_record, after_record);
+  if (!error && opt_binlog_writeset_size && trans_cache)
+    binlog_add_writeset(cache, table, before_record, after_record);
   DBUG_RETURN(error ? HA_ERR_RBR_LOGGING_FAILED : 0);
 }
 
@@ -4315,6 +4315,15 @@ class handler :public Sql_alloc
   virtual int pre_ft_end() { return 0; }
   virtual FT_INFO *ft_init_ext(uint flags, uint inx,String *key)
     { return NULL; }
+  /**
+    Initialize a full-text search whose caller will read at most
+    limit rows, and only the best ranked ones.
+
+    @param limit  number of rows, or HA_POS_ERROR if all rows may be read
+  */
+  virtual FT_INFO *ft_init_ext_with_hints(uint flags, uint inx, String *key,
+                                          ha_rows limit)
+    { return ft_init_ext(flags, inx, key); }
 public:
   virtual int ft_read(uchar *buf) { return HA_ERR_WRONG_COMMAND; }
   virtual int rnd_next(uchar *buf)=0;
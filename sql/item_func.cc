@@ -6218,7 +6218,8 @@ bool Item_func_match::init_search(THD *thd, bool no_order)
   if (key != NO_SUCH_KEY)
     THD_STAGE_INFO(table->in_use, stage_fulltext_initialization);
 
-  ft_handler= table->file->ft_init_ext(match_flags, key, ft_tmp);
+  ft_handler= table->file->ft_init_ext_with_hints(match_flags, key, ft_tmp,
+                                                  limit_hint);
 
   if (!ft_handler)
     DBUG_RETURN(1);
@@ -3706,10 +3706,15 @@ class Item_func_match :public Item_real_func
   Item *concat_ws;           // Item_func_concat_ws
   String value;              // value of concat_ws
   String search_value;       // key_item()'s value converted to cmp_collation
+  /**
+    How many of the best ranked rows the query will read, or HA_POS_ERROR.
+    Set by the optimizer before init_search().
+  */
+  ha_rows limit_hint;
 
   Item_func_match(THD *thd, List<Item> &a, uint b):
     Item_real_func(thd, a), key(0), match_flags(b), join_key(0), ft_handler(0),
-    table(0), master(0), concat_ws(0) { }
+    table(0), master(0), concat_ws(0), limit_hint(HA_POS_ERROR) { }
   void cleanup() override
   {
     DBUG_ENTER("Item_func_match::cleanup");
@@ -3719,6 +3724,7 @@ class Item_func_match :public Item_real_func
     ft_handler= 0;
     concat_ws= 0;
     table= 0;           // required by Item_func_match::eq()
+    limit_hint= HA_POS_ERROR;
     DBUG_VOID_RETURN;
   }
   bool is_expensive_processor(void *arg) override { return TRUE; }
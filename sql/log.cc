@@ -61,6 +61,8 @@
 #include "sp_head.h"
 #include "sql_table.h"
 #include "log_cache.h"
+#include "key.h"                                // key_copy, key_hashnr
+#include <algorithm>
 
 #include "wsrep_mysqld.h"
 #ifdef WITH_WSREP
@@ -74,6 +76,10 @@
 #include <utility>     // pair
 #endif
 
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
 /* max size of the log message */
 #define MAX_LOG_BUFFER_SIZE 1024
 #define MAX_TIME_SIZE 32
@@ -369,8 +375,13 @@ class binlog_cache_mngr {
                     ulong *param_ptr_binlog_cache_disk_use,
                     bool precompute_checksums)
     : stmt_cache(precompute_checksums), trx_cache(precompute_checksums),
-      last_commit_pos_offset(0), using_xa(FALSE), xa_xid(0)
+      last_commit_pos_offset(0), using_xa(FALSE), xa_xid(0),
+      payload_length(0), payload_uncompressed_length(0)
   {
+     bzero(&payload_cache, sizeof(payload_cache));
+#ifdef HAVE_ZSTD
+     zstd_cctx= NULL;
+#endif
      stmt_cache.set_binlog_cache_info(param_max_binlog_stmt_cache_size,
                                       param_ptr_binlog_stmt_cache_use,
                                       param_ptr_binlog_stmt_cache_disk_use);
@@ -380,6 +391,15 @@ class binlog_cache_mngr {
      last_commit_pos_file[0]= 0;
   }
 
+  ~binlog_cache_mngr()
+  {
+    if (my_b_inited(&payload_cache))
+      close_cached_file(&payload_cache);
+#ifdef HAVE_ZSTD
+    ZSTD_freeCCtx(zstd_cctx);
+#endif
+  }
+
   void reset(bool do_stmt, bool do_trx)
   {
     if (do_stmt)
@@ -388,6 +408,7 @@ class binlog_cache_mngr {
     {
       trx_cache.reset();
       using_xa= FALSE;
+      payload_length= 0;
       last_commit_pos_file[0]= 0;
       last_commit_pos_offset= 0;
     }
@@ -435,6 +456,20 @@ class binlog_cache_mngr {
   //Will be reset when gtid is written into binlog
   uchar  gtid_flags3;
   decltype (rpl_gtid::seq_no) sa_seq_no;
+
+  /*
+    With binlog_transaction_compression, the compressed events of trx_cache,
+    to be written as one Transaction_payload_log_event. payload_length is 0
+    when trx_cache is to be written as it is.
+  */
+  IO_CACHE payload_cache;
+  my_off_t payload_length;
+  my_off_t payload_uncompressed_length;
+  /* binlog_checksum_options of the events inside the payload. */
+  ulong payload_checksum_alg;
+#ifdef HAVE_ZSTD
+  ZSTD_CCtx *zstd_cctx;
+#endif
 private:
 
   binlog_cache_mngr& operator=(const binlog_cache_mngr& info);
@@ -4570,6 +4605,10 @@ bool MYSQL_BIN_LOG::reset_logs(THD *thd, bool create_new_log,
       rpl_global_gtid_binlog_state.load(init_state, init_state_len);
     else
       rpl_global_gtid_binlog_state.reset();
+#ifdef HAVE_REPLICATION
+    /* The file names will be reused. */
+    binlog_dump_cache_invalidate();
+#endif
   }
 
   /* Start logging with a new file */
@@ -6562,6 +6601,148 @@ binlog_cache_data* binlog_get_cache_data(binlog_cache_mngr *cache_mngr,
   return cache_mngr->get_binlog_cache_data(use_trans_cache);
 }
 
+/*
+  Final mixing step of MurmurHash3, so that the low bits of a writeset
+  hash are usable for indexing a table on the slave.
+*/
+static inline ulonglong writeset_mix(ulonglong h)
+{
+  h^= h >> 33;
+  h*= 0xff51afd7ed558ccdULL;
+  h^= h >> 33;
+  h*= 0xc4ceb9fe1a85ec53ULL;
+  h^= h >> 33;
+  return h;
+}
+
+/**
+  Remember the unique key values of a logged row.
+
+  For every PRIMARY or UNIQUE key, a hash of the table name, the key number
+  and the key value is appended to the writeset. Two transactions that
+  modify the same row, or that both change a unique key to or from the same
+  value, will have a common hash. The hashes are collation aware, so that
+  values that are equal in a case insensitive key hash equally.
+
+  A slave that applies row events only accesses rows through these keys,
+  except for foreign key checks and keys that cannot be hashed, in which case
+  the writeset is discarded.
+
+  @param table          the table of the row
+  @param before_record  the row before an UPDATE or DELETE, or NULL
+  @param after_record   the row after an INSERT or UPDATE, or NULL
+*/
+void binlog_cache_data::add_writeset(TABLE *table, const uchar *before_record,
+                                     const uchar *after_record)
+{
+  if (writeset_unusable)
+    return;
+
+  TABLE_SHARE *share= table->s;
+  if (share->primary_key >= MAX_KEY || !table->file->can_switch_engines())
+  {
+    set_writeset_unusable();
+    return;
+  }
+
+  ulong nr1= 1, nr2= 4;
+  my_charset_bin.hash_sort((const uchar*) share->table_cache_key.str,
+                           share->table_cache_key.length, &nr1, &nr2);
+  uchar key_buf[MAX_KEY_LENGTH];
+  const uchar *const records[2]= { before_record, after_record };
+
+  for (uint keynr= 0; keynr < share->keys; keynr++)
+  {
+    KEY *key_info= &table->key_info[keynr];
+    if (!(key_info->flags & HA_NOSAME))
+      continue;
+    if (key_info->algorithm == HA_KEY_ALG_LONG_HASH)
+    {
+      set_writeset_unusable();
+      return;
+    }
+
+    const KEY_PART_INFO *key_part= key_info->key_part;
+    const KEY_PART_INFO *const key_end=
+      key_part + key_info->user_defined_key_parts;
+
+    if (before_record && after_record && keynr != share->primary_key)
+    {
+      /*
+        A secondary key that an UPDATE does not change cannot conflict
+        with other transactions, except through the primary key.
+      */
+      bool changed= false;
+      for (const KEY_PART_INFO *kp= key_part; kp < key_end; kp++)
+        changed|= bitmap_is_set(table->write_set, kp->fieldnr - 1);
+      if (!changed)
+        continue;
+    }
+
+    for (const uchar *record : records)
+    {
+      if (!record)
+        continue;
+      bool is_null= false;
+      for (const KEY_PART_INFO *kp= key_part; kp < key_end; kp++)
+      {
+        /* The values of the before image are only known if they were read */
+        if (record == before_record &&
+            !bitmap_is_set(table->read_set, kp->fieldnr - 1))
+        {
+          set_writeset_unusable();
+          return;
+        }
+        if (kp->null_bit && (record[kp->null_offset] & kp->null_bit))
+          is_null= true;
+      }
+      /* NULL values never conflict in a UNIQUE key */
+      if (is_null)
+        continue;
+
+      key_copy(key_buf, record, key_info, 0);
+      ulonglong hash= writeset_mix(nr1 + keynr) ^
+        key_hashnr(key_info, key_info->user_defined_key_parts, key_buf);
+      if (writeset.append_val(writeset_mix(hash)))
+      {
+        set_writeset_unusable();
+        return;
+      }
+    }
+  }
+
+  if (writeset.elements() > opt_binlog_writeset_size)
+  {
+    compact_writeset();
+    if (writeset.elements() > opt_binlog_writeset_size)
+      set_writeset_unusable();
+  }
+}
+
+
+void binlog_cache_data::compact_writeset()
+{
+  ulonglong *first= writeset.front(), *last= first + writeset.elements();
+  std::sort(first, last);
+  writeset.elements(std::unique(first, last) - first);
+}
+
+
+const Dynamic_array<ulonglong> *binlog_cache_data::get_writeset()
+{
+  if (writeset_unusable || !writeset.elements())
+    return NULL;
+  compact_writeset();
+  return &writeset;
+}
+
+
+void binlog_add_writeset(binlog_cache_data *cache_data, TABLE *table,
+                         const uchar *before_record, const uchar *after_record)
+{
+  cache_data->add_writeset(table, before_record, after_record);
+}
+
 int binlog_flush_pending_rows_event(THD *thd, bool stmt_end,
                                     bool is_transactional,
                                     Event_log *bin_log,
@@ -6765,7 +6946,8 @@ Event_log::prepare_pending_rows_event(THD *thd, TABLE* table,
 bool
 MYSQL_BIN_LOG::write_gtid_event(THD *thd, bool standalone,
                                 bool is_transactional, uint64 commit_id,
-                                bool has_xid, bool is_ro_1pc)
+                                bool has_xid, bool is_ro_1pc,
+                                binlog_cache_data *writeset_cache)
 {
   rpl_gtid gtid;
   uint32 domain_id;
@@ -6822,6 +7004,22 @@ MYSQL_BIN_LOG::write_gtid_event(THD *thd, bool standalone,
                             LOG_EVENT_SUPPRESS_USE_F, is_transactional,
                             commit_id, has_xid, is_ro_1pc);
 
+  /*
+    The writeset is only useful to the slave if the event group can be
+    rolled back and retried, should it conflict after all.
+  */
+  if (writeset_cache &&
+      (gtid_event.flags2 & (Gtid_log_event::FL_TRANSACTIONAL |
+                            Gtid_log_event::FL_DDL |
+                            Gtid_log_event::FL_PREPARED_XA |
+                            Gtid_log_event::FL_COMPLETED_XA)) ==
+      Gtid_log_event::FL_TRANSACTIONAL)
+  {
+    if (const Dynamic_array<ulonglong> *writeset=
+        writeset_cache->get_writeset())
+      gtid_event.set_writeset(writeset->front(), uint(writeset->elements()));
+  }
+
   /* Write the event to the binary log. */
   DBUG_ASSERT(this == &mysql_bin_log);
 
@@ -7254,6 +7452,13 @@ bool MYSQL_BIN_LOG::write(Log_event *event_info, my_bool *with_annotate)
       }
     }
 
+    /*
+      Row events are described by the writeset, but the slave cannot know
+      what other events would access.
+    */
+    if (cache_data && event_info->get_type_code() != TABLE_MAP_EVENT)
+      cache_data->set_writeset_unusable();
+
     /*
       Write the event.
     */
@@ -8139,6 +8344,99 @@ write_binlog_checkpoint_event_already_locked(const char *name_arg, uint len)
 }
 
 
+#ifdef HAVE_ZSTD
+/*
+  Compress the events in the transaction cache into
+  cache_mngr->payload_cache, to be written to the binlog as one
+  Transaction_payload_log_event.
+
+  This is done before the transaction is queued for group commit, so that
+  the compression does not happen while holding LOCK_log. If the events can
+  not or should not be compressed, payload_length is left at 0 and the
+  transaction cache is written as usual.
+*/
+
+static void binlog_compress_trx_cache(binlog_cache_mngr *cache_mngr)
+{
+  binlog_cache_data *cache_data= &cache_mngr->trx_cache;
+  IO_CACHE *cache= &cache_data->cache_log;
+  IO_CACHE *to= &cache_mngr->payload_cache;
+  my_off_t saved_pos= my_b_tell(cache);
+  /* The event must be readable by the dump thread and by recovery. */
+  my_off_t max_length= global_system_variables.max_allowed_packet -
+    (LOG_EVENT_HEADER_LEN + TRANSACTION_PAYLOAD_BODY_HEADER_LEN +
+     BINLOG_CHECKSUM_LEN);
+  ZSTD_CCtx *cctx;
+  ZSTD_EndDirective mode= ZSTD_e_continue;
+  DBUG_ENTER("binlog_compress_trx_cache");
+
+  cache_mngr->payload_length= 0;
+  /*
+    The checksums of the events inside the payload can not be fixed when the
+    payload is written, so only compress events that already have the
+    checksums of the binlog.
+  */
+  if (saved_pos < opt_bin_log_compress_min_len ||
+      (ulong) cache_data->checksum_opt != binlog_checksum_options ||
+      opt_binlog_legacy_event_pos)
+    DBUG_VOID_RETURN;
+
+  if (!(cctx= cache_mngr->zstd_cctx) &&
+      !(cctx= cache_mngr->zstd_cctx= ZSTD_createCCtx()))
+    DBUG_VOID_RETURN;
+  ZSTD_CCtx_reset(cctx, ZSTD_reset_session_only);
+  if (ZSTD_isError(ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel,
+                          (int) opt_binlog_transaction_compression_level)) ||
+      ZSTD_isError(ZSTD_CCtx_setPledgedSrcSize(cctx, saved_pos)))
+    DBUG_VOID_RETURN;
+
+  if (!my_b_inited(to) &&
+      open_cached_file(to, mysql_tmpdir, LOG_PREFIX, (size_t) binlog_cache_size,
+                       MYF(MY_WME)))
+    DBUG_VOID_RETURN;
+  if (reinit_io_cache(to, WRITE_CACHE, 0, 0, 0))
+    DBUG_VOID_RETURN;
+
+  if (reinit_io_cache(cache, READ_CACHE, 0, 0, 0))
+    goto err;
+  do
+  {
+    size_t length= my_b_bytes_in_cache(cache);
+    if (!length && !(length= my_b_fill(cache)))
+      mode= ZSTD_e_end;
+    ZSTD_inBuffer in= { cache->read_pos, length, 0 };
+    size_t ret;
+    do
+    {
+      if (to->write_pos == to->write_end && my_b_flush_io_cache(to, 0))
+        goto err;
+      ZSTD_outBuffer out= { to->write_pos,
+                            (size_t) (to->write_end - to->write_pos), 0 };
+      ret= ZSTD_compressStream2(cctx, &out, &in, mode);
+      if (ZSTD_isError(ret))
+        goto err;
+      to->write_pos+= out.pos;
+      if (my_b_tell(to) > max_length)
+        goto err;                               // Too big, or not worth it
+    } while (mode == ZSTD_e_end ? ret != 0 : in.pos < in.size);
+    cache->read_pos+= length;
+  } while (mode != ZSTD_e_end);
+
+  if (my_b_tell(to) < saved_pos)
+  {
+    cache_mngr->payload_length= my_b_tell(to);
+    cache_mngr->payload_uncompressed_length= saved_pos;
+    cache_mngr->payload_checksum_alg= binlog_checksum_options;
+  }
+
+err:
+  if (reinit_io_cache(cache, WRITE_CACHE, saved_pos, 0, 0))
+    cache_mngr->payload_length= 0;
+  DBUG_VOID_RETURN;
+}
+#endif /* HAVE_ZSTD */
+
+
 /**
   Write a cached log entry to the binary log.
   - To support transaction over replication, we wrap the transaction
@@ -8202,6 +8500,18 @@ MYSQL_BIN_LOG::write_transaction_to_binlog(THD *thd,
   entry.end_event= end_ev;
   auto has_xid= entry.end_event->get_type_code() == XID_EVENT;
 
+#ifdef HAVE_ZSTD
+  /*
+    The events of an XA PREPARE are not compressed, and neither are the
+    events of the statement cache, which is used for non-transactional
+    changes.
+  */
+  if (opt_binlog_transaction_compression && using_trx_cache &&
+      !cache_mngr->trx_cache.empty() &&
+      end_ev->get_type_code() != XA_PREPARE_LOG_EVENT)
+    binlog_compress_trx_cache(cache_mngr);
+#endif
+
   for (; has_xid && !entry.need_unlog && ha_info; ha_info= ha_info->next())
   {
     if (ha_info->is_started() && ha_info->ht() != binlog_hton &&
@@ -9108,9 +9418,17 @@ MYSQL_BIN_LOG::write_transaction_or_stmt(group_commit_entry *entry,
   DBUG_ASSERT(!(entry->using_stmt_cache && !mngr->stmt_cache.empty() &&
                 mngr->get_binlog_cache_log(FALSE)->error));
 
+  /*
+    Changes to non-transactional tables are not described by the writeset.
+  */
+  binlog_cache_data *writeset_cache=
+    opt_binlog_writeset_size && entry->using_trx_cache &&
+    !(entry->using_stmt_cache && !mngr->stmt_cache.empty())
+    ? &mngr->trx_cache : NULL;
+
   if (write_gtid_event(entry->thd, is_prepared_xa(entry->thd),
                        entry->using_trx_cache, commit_id,
-                       has_xid, entry->ro_1pc))
+                       has_xid, entry->ro_1pc, writeset_cache))
     DBUG_RETURN(ER_ERROR_ON_WRITE);
 
   if (entry->using_stmt_cache && !mngr->stmt_cache.empty() &&
@@ -9134,10 +9452,33 @@ MYSQL_BIN_LOG::write_transaction_or_stmt(group_commit_entry *entry,
                       DBUG_SUICIDE();
                     });
 
-    if (write_cache(entry->thd, mngr->get_binlog_cache_data(TRUE)))
+    /*
+      binlog_checksum can have changed since the payload was compressed, in
+      which case the events are written uncompressed.
+    */
+    if (mngr->payload_length &&
+        mngr->payload_checksum_alg == binlog_checksum_options)
+    {
+      Transaction_payload_log_event ev(entry->thd, &mngr->payload_cache,
+                                       mngr->payload_length,
+                                       mngr->payload_uncompressed_length);
+      mngr->payload_length= 0;
+      if (write_event(&ev))
+      {
+        entry->error_cache= NULL;
+        DBUG_RETURN(ER_ERROR_ON_WRITE);
+      }
+      status_var_add(entry->thd->status_var.binlog_bytes_written,
+                     ev.data_written);
+    }
+    else
     {
-      entry->error_cache= &mngr->trx_cache.cache_log;
-      DBUG_RETURN(ER_ERROR_ON_WRITE);
+      mngr->payload_length= 0;
+      if (write_cache(entry->thd, mngr->get_binlog_cache_data(TRUE)))
+      {
+        entry->error_cache= &mngr->trx_cache.cache_log;
+        DBUG_RETURN(ER_ERROR_ON_WRITE);
+      }
     }
   }
 
@@ -1117,7 +1117,8 @@ class MYSQL_BIN_LOG: public TC_LOG, private Event_log
   bool is_xidlist_idle();
   bool write_gtid_event(THD *thd, bool standalone, bool is_transactional,
                         uint64 commit_id,
-                        bool has_xid= false, bool ro_1pc= false);
+                        bool has_xid= false, bool ro_1pc= false,
+                        binlog_cache_data *writeset_cache= NULL);
   int read_state_from_file();
   int write_state_to_file();
   int get_most_recent_gtid_list(rpl_gtid **list, uint32 *size);
@@ -1395,6 +1396,9 @@ int online_alter_log_row(TABLE* table, const uchar *before_record,
                          const uchar *after_record, Log_func *log_func);
 binlog_cache_data* binlog_get_cache_data(binlog_cache_mngr *cache_mngr,
                                          bool use_trans_cache);
+void binlog_add_writeset(binlog_cache_data *cache_data, TABLE *table,
+                         const uchar *before_record,
+                         const uchar *after_record);
 
 extern MYSQL_PLUGIN_IMPORT MYSQL_BIN_LOG mysql_bin_log;
 extern handlerton *binlog_hton;
@@ -17,6 +17,7 @@
 */
 
 #include "log_event.h"
+#include "sql_array.h"
 
 static constexpr my_off_t MY_OFF_T_UNDEF= ~0ULL;
 /** Truncate cache log files bigger than this */
@@ -28,7 +29,9 @@ class binlog_cache_data
 public:
   binlog_cache_data(bool precompute_checksums):
                     before_stmt_pos(MY_OFF_T_UNDEF), m_pending(0), status(0),
-                    incident(FALSE), precompute_checksums(precompute_checksums),
+                    incident(FALSE), writeset(PSI_INSTRUMENT_MEM),
+                    writeset_unusable(false),
+                    precompute_checksums(precompute_checksums),
                     saved_max_binlog_cache_size(0), ptr_binlog_cache_use(0),
                     ptr_binlog_cache_disk_use(0)
   {
@@ -102,6 +105,8 @@ class binlog_cache_data
     status= 0;
     incident= FALSE;
     before_stmt_pos= MY_OFF_T_UNDEF;
+    writeset.clear();
+    writeset_unusable= false;
     DBUG_ASSERT(empty());
   }
 
@@ -167,6 +172,29 @@ class binlog_cache_data
     status|= status_arg;
   }
 
+  /*
+    Remember the unique keys of a row that was logged in the cache, for
+    slave_parallel_mode=writeset. Defined in log.cc.
+  */
+  void add_writeset(TABLE *table, const uchar *before_record,
+                    const uchar *after_record);
+
+  /*
+    Note that the cache contains something that is not described by the
+    writeset, so that no writeset will be written for the transaction.
+  */
+  void set_writeset_unusable()
+  {
+    writeset_unusable= true;
+    writeset.clear();
+  }
+
+  /*
+    Return the distinct key hashes of the transaction, or NULL if no
+    writeset can be written for it.
+  */
+  const Dynamic_array<ulonglong> *get_writeset();
+
   /*
     Cache to store data before copying it to the binary log.
   */
@@ -206,6 +234,19 @@ class binlog_cache_data
   */
   bool incident;
 
+  /*
+    Hashes of the unique key values of the rows that were logged in the
+    cache, possibly with duplicates. Only collected when
+    binlog_writeset_size is nonzero.
+  */
+  Dynamic_array<ulonglong> writeset;
+
+  /* Set when the writeset does not cover all changes in the cache. */
+  bool writeset_unusable;
+
+  /* Sort the writeset and remove duplicates. */
+  void compact_writeset();
+
   /* Whether the caller requested precomputing checksums. */
   bool precompute_checksums;
 
@@ -55,6 +55,9 @@
 #include "rpl_constants.h"
 #include "sql_digest.h"
 #include "zlib.h"
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
 #include "myisampack.h"
 #include <algorithm>
 
@@ -701,6 +704,7 @@ const char* Log_event::get_type_str(Log_event_type type)
   case WRITE_ROWS_COMPRESSED_EVENT_V1: return "Write_rows_compressed_v1";
   case UPDATE_ROWS_COMPRESSED_EVENT_V1: return "Update_rows_compressed_v1";
   case DELETE_ROWS_COMPRESSED_EVENT_V1: return "Delete_rows_compressed_v1";
+  case TRANSACTION_PAYLOAD_EVENT: return "Transaction_payload";
 
   default: return "Unknown";				/* impossible */
   }
@@ -1050,7 +1054,8 @@ Log_event* Log_event::read_log_event(const uchar *buf, uint event_len,
   }
 
   if (event_type > fdle->number_of_event_types &&
-      event_type != FORMAT_DESCRIPTION_EVENT)
+      event_type != FORMAT_DESCRIPTION_EVENT &&
+      event_type != TRANSACTION_PAYLOAD_EVENT)
   {
     /*
       It is unsafe to use the fdle if its post_header_len
@@ -1198,6 +1203,9 @@ Log_event* Log_event::read_log_event(const uchar *buf, uint event_len,
     case INCIDENT_EVENT:
       ev= new Incident_log_event(buf, event_len, fdle);
       break;
+    case TRANSACTION_PAYLOAD_EVENT:
+      ev= new Transaction_payload_log_event(buf, event_len, fdle);
+      break;
     case ANNOTATE_ROWS_EVENT:
       ev= new Annotate_rows_log_event(buf, event_len, fdle);
       break;
@@ -2394,7 +2402,8 @@ Gtid_log_event::Gtid_log_event(const uchar *buf, uint event_len,
                                const Format_description_log_event
                                *description_event)
   : Log_event(buf, description_event), seq_no(0), commit_id(0),
-    flags_extra(0), extra_engines(0)
+    flags_extra(0), extra_engines(0), writeset(NULL), writeset_count(0),
+    writeset_owned(false)
 {
   uint8 header_size= description_event->common_header_len;
   uint8 post_header_len= description_event->post_header_len[GTID_EVENT-1];
@@ -2472,6 +2481,33 @@ Gtid_log_event::Gtid_log_event(const uchar *buf, uint event_len,
       sa_seq_no= uint8korr(buf);
       buf+= 8;
     }
+    if (flags_extra & FL_EXTRA_WRITESET_E1)
+    {
+      if (event_len < static_cast<uint>(buf - buf_0) + 2)
+      {
+        seq_no= 0;
+        return;
+      }
+      writeset_count= uint2korr(buf);
+      buf+= 2;
+      const size_t len= size_t{writeset_count} * 8;
+      if (!writeset_count || event_len < static_cast<uint>(buf - buf_0) + len)
+      {
+        seq_no= 0;
+        return;
+      }
+      ulonglong *hashes= static_cast<ulonglong*>
+        (my_malloc(PSI_INSTRUMENT_ME, len, MYF(MY_WME)));
+      if (!hashes)
+      {
+        seq_no= 0;
+        return;
+      }
+      for (uint i= 0; i < writeset_count; i++, buf+= 8)
+        hashes[i]= uint8korr(buf);
+      writeset= hashes;
+      writeset_owned= true;
+    }
   }
   /*
     the strict '<' part of the assert corresponds to extra zero-padded
@@ -3908,6 +3944,165 @@ Ignorable_log_event::Ignorable_log_event(const uchar *buf,
 
 Ignorable_log_event::~Ignorable_log_event() = default;
 
+
+/**************************************************************************
+  Transaction_payload_log_event methods
+**************************************************************************/
+
+Transaction_payload_log_event::Transaction_payload_log_event(
+       const uchar *buf, uint event_len,
+       const Format_description_log_event *description_event)
+  :Log_event(buf, description_event), algorithm(0), uncompressed_length(0),
+   payload(0), payload_length(0)
+{
+  uint8 header_size= description_event->common_header_len;
+#ifdef MYSQL_SERVER
+  payload_cache= 0;
+#endif
+  if (event_len < (uint) header_size + TRANSACTION_PAYLOAD_BODY_HEADER_LEN)
+    return;
+  buf+= header_size;
+  uncompressed_length= uint8korr(buf + 1);
+  payload= buf + TRANSACTION_PAYLOAD_BODY_HEADER_LEN;
+  payload_length= event_len - header_size - TRANSACTION_PAYLOAD_BODY_HEADER_LEN;
+  algorithm= buf[0];
+}
+
+
+#ifdef HAVE_ZSTD
+Transaction_payload_reader::~Transaction_payload_reader()
+{
+  ZSTD_freeDStream((ZSTD_DStream*) dstream);
+  my_free(buf);
+}
+
+
+bool Transaction_payload_reader::init(const Transaction_payload_log_event *ev)
+{
+  if (ev->algorithm != TRANSACTION_PAYLOAD_ZSTD)
+    return true;
+  if (!dstream)
+  {
+    if (!(dstream= ZSTD_createDStream()))
+      return true;
+  }
+  else if (ZSTD_isError(ZSTD_DCtx_reset((ZSTD_DStream*) dstream,
+                                        ZSTD_reset_session_only)))
+    return true;
+  if (!buf)
+  {
+    buf_size= ZSTD_DStreamOutSize();
+    if (!(buf= (uchar*) my_malloc(PSI_INSTRUMENT_ME, buf_size, MYF(MY_WME))))
+      return true;
+  }
+  in= ev->payload;
+  in_length= (size_t) ev->payload_length;
+  in_pos= 0;
+  buf_start= buf_end= 0;
+  uncompressed_length= ev->uncompressed_length;
+  total_out= 0;
+  frame_done= false;
+  return false;
+}
+
+
+/*
+  Make sure that at least NEED bytes are decompressed and not read yet.
+  The unread bytes are moved to the start of the buffer first.
+*/
+bool Transaction_payload_reader::fill(size_t need)
+{
+  size_t avail= buf_end - buf_start;
+  if (avail >= need)
+    return false;
+  if (need - avail > uncompressed_length - total_out)
+    return true;                                // Truncated event
+  if (buf_start)
+  {
+    memmove(buf, buf + buf_start, avail);
+    buf_start= 0;
+    buf_end= avail;
+  }
+  if (need > buf_size)
+  {
+    uchar *new_buf= (uchar*) my_realloc(PSI_INSTRUMENT_ME, buf, need,
+                                        MYF(MY_WME));
+    if (!new_buf)
+      return true;
+    buf= new_buf;
+    buf_size= need;
+  }
+  while (buf_end < need)
+  {
+    /* Never decompress more than the announced uncompressed length. */
+    size_t room= (size_t) MY_MIN((ulonglong) (buf_size - buf_end),
+                                 uncompressed_length - total_out);
+    ZSTD_outBuffer out= { buf, buf_end + room, buf_end };
+    ZSTD_inBuffer inb= { in, in_length, in_pos };
+    size_t res= ZSTD_decompressStream((ZSTD_DStream*) dstream, &out, &inb);
+    if (ZSTD_isError(res) || (out.pos == buf_end && inb.pos == in_pos))
+      return true;
+    frame_done= res == 0;
+    total_out+= out.pos - buf_end;
+    buf_end= out.pos;
+    in_pos= inb.pos;
+  }
+  return false;
+}
+
+
+bool Transaction_payload_reader::next(uchar **event, uint *event_len)
+{
+  *event= NULL;
+  if (buf_start == buf_end && total_out == uncompressed_length)
+  {
+    /*
+      All events were read. The frame must end exactly here, which may need
+      one more call to consume its epilogue.
+    */
+    if (!frame_done)
+    {
+      ZSTD_outBuffer out= { buf, 0, 0 };
+      ZSTD_inBuffer inb= { in, in_length, in_pos };
+      size_t res= ZSTD_decompressStream((ZSTD_DStream*) dstream, &out, &inb);
+      if (ZSTD_isError(res) || res != 0)
+        return true;
+      in_pos= inb.pos;
+      frame_done= true;
+    }
+    return in_pos != in_length;
+  }
+  if (fill(LOG_EVENT_MINIMAL_HEADER_LEN))
+    return true;
+  uint len= uint4korr(buf + buf_start + EVENT_LEN_OFFSET);
+  if (len < LOG_EVENT_MINIMAL_HEADER_LEN || fill(len))
+    return true;
+  *event= buf + buf_start;
+  *event_len= len;
+  buf_start+= len;
+  return false;
+}
+#else
+Transaction_payload_reader::~Transaction_payload_reader() = default;
+
+bool Transaction_payload_reader::init(const Transaction_payload_log_event *)
+{
+  /* Built without zstd, the payload cannot be decompressed. */
+  return true;
+}
+
+bool Transaction_payload_reader::fill(size_t)
+{
+  return true;
+}
+
+bool Transaction_payload_reader::next(uchar **event, uint *)
+{
+  *event= NULL;
+  return true;
+}
+#endif /* HAVE_ZSTD */
+
 bool copy_event_cache_to_file_and_reinit(IO_CACHE *cache, FILE *file)
 {
   return (my_b_copy_all_to_file(cache, file) ||
@@ -230,6 +230,7 @@ class String;
 #define GTID_LIST_HEADER_LEN   4
 #define START_ENCRYPTION_HEADER_LEN 0
 #define XA_PREPARE_HEADER_LEN 0
+#define TRANSACTION_PAYLOAD_HEADER_LEN 0
 
 /* 
   Max number of possible extra bytes in a replication event compared to a
@@ -582,8 +583,11 @@ class String;
 /* MariaDB >= 10.0.1, which knows about global transaction id events. */
 #define MARIA_SLAVE_CAPABILITY_GTID 4
 
+/* MariaDB >= 11.4, which knows about Transaction_payload_log_event. */
+#define MARIA_SLAVE_CAPABILITY_TRANSACTION_PAYLOAD 5
+
 /* Our capability. */
-#define MARIA_SLAVE_CAPABILITY_MINE MARIA_SLAVE_CAPABILITY_GTID
+#define MARIA_SLAVE_CAPABILITY_MINE MARIA_SLAVE_CAPABILITY_TRANSACTION_PAYLOAD
 
 
 /*
@@ -733,7 +737,20 @@ enum Log_event_type
 
   /* Add new MariaDB events here - right above this comment!  */
 
-  ENUM_END_EVENT /* end marker */
+  ENUM_END_EVENT, /* end marker */
+
+  /*
+    Events from here on have no post-header, and are not counted in the
+    post-header lengths of the Format_description_log_event. This way,
+    adding them does not change the format description (and so the event
+    positions) of binlogs that do not use them.
+  */
+
+  /*
+    The events of one transaction, compressed together. Only written with
+    binlog_transaction_compression=ON.
+  */
+  TRANSACTION_PAYLOAD_EVENT= 224
 };
 
 
@@ -1577,6 +1594,27 @@ class Log_event
   */
   const char* get_type_str();
 
+  static bool is_group_event(enum Log_event_type ev_type)
+  {
+    switch (ev_type)
+    {
+    case START_EVENT_V3:
+    case STOP_EVENT:
+    case ROTATE_EVENT:
+    case SLAVE_EVENT:
+    case FORMAT_DESCRIPTION_EVENT:
+    case INCIDENT_EVENT:
+    case HEARTBEAT_LOG_EVENT:
+    case BINLOG_CHECKPOINT_EVENT:
+    case GTID_LIST_EVENT:
+    case START_ENCRYPTION_EVENT:
+      return false;
+
+    default:
+      return true;
+    }
+  }
+
 #if defined(MYSQL_SERVER) && defined(HAVE_REPLICATION)
 
   /**
@@ -1637,6 +1675,7 @@ class Log_event
     case USER_VAR_EVENT:
     case TABLE_MAP_EVENT:
     case ANNOTATE_ROWS_EVENT:
+    case TRANSACTION_PAYLOAD_EVENT:
       return true;
     case DELETE_ROWS_EVENT:
     case UPDATE_ROWS_EVENT:
@@ -1654,27 +1693,6 @@ class Log_event
     rows event except the last one.
   */
   virtual bool is_part_of_group() { return 0; }
-
-  static bool is_group_event(enum Log_event_type ev_type)
-  {
-    switch (ev_type)
-    {
-    case START_EVENT_V3:
-    case STOP_EVENT:
-    case ROTATE_EVENT:
-    case SLAVE_EVENT:
-    case FORMAT_DESCRIPTION_EVENT:
-    case INCIDENT_EVENT:
-    case HEARTBEAT_LOG_EVENT:
-    case BINLOG_CHECKPOINT_EVENT:
-    case GTID_LIST_EVENT:
-    case START_ENCRYPTION_EVENT:
-      return false;
-
-    default:
-      return true;
-    }
-  }
   
 protected:
 
@@ -3326,6 +3344,12 @@ class Gtid_log_event: public Log_event
     When zero the event does not contain that information.
   */
   uint8 extra_engines;
+  /*
+    Hashes of the unique key values that the transaction modified
+    (FL_EXTRA_WRITESET_E1), or NULL.
+  */
+  const ulonglong *writeset;
+  uint16 writeset_count;
 
   /* Flags2. */
 
@@ -3371,6 +3395,11 @@ class Gtid_log_event: public Log_event
   static const uchar FL_START_ALTER_E1= 2;
   static const uchar FL_COMMIT_ALTER_E1= 4;
   static const uchar FL_ROLLBACK_ALTER_E1= 8;
+  /*
+    FL_EXTRA_WRITESET_E1 is set when the event is followed by the writeset
+    of the transaction, for slave_parallel_mode=writeset.
+  */
+  static const uchar FL_EXTRA_WRITESET_E1= 16;
 
 #ifdef MYSQL_SERVER
   Gtid_log_event(THD *thd_arg, uint64 seq_no, uint32 domain_id, bool standalone,
@@ -3387,7 +3416,11 @@ class Gtid_log_event: public Log_event
 #endif
   Gtid_log_event(const uchar *buf, uint event_len,
                  const Format_description_log_event *description_event);
-  ~Gtid_log_event() = default;
+  ~Gtid_log_event()
+  {
+    if (writeset_owned)
+      my_free(const_cast<ulonglong*>(writeset));
+  }
   Log_event_type get_type_code() { return GTID_EVENT; }
   enum_logged_status logged_status() { return LOGGED_NO_DATA; }
   int get_data_size()
@@ -3405,6 +3438,18 @@ class Gtid_log_event: public Log_event
   }
 
 #ifdef MYSQL_SERVER
+  /*
+    Attach a writeset to the event. The hashes must remain valid until the
+    event has been written.
+  */
+  void set_writeset(const ulonglong *hashes, uint count)
+  {
+    DBUG_ASSERT(!writeset_owned);
+    DBUG_ASSERT(count && count <= UINT_MAX16);
+    writeset= hashes;
+    writeset_count= uint16(count);
+    flags_extra|= FL_EXTRA_WRITESET_E1;
+  }
   bool write(Log_event_writer *writer);
   static int make_compatible_event(String *packet, bool *need_dummy_event,
                                     ulong ev_offset, enum_binlog_checksum_alg checksum_alg);
@@ -3413,6 +3458,9 @@ class Gtid_log_event: public Log_event
                    uint32 *domain_id, uint32 *server_id, uint64 *seq_no,
                    uchar *flags2, const Format_description_log_event *fdev);
 #endif
+private:
+  /* Whether writeset was allocated by the constructor */
+  bool writeset_owned;
 };
 
 
@@ -4868,6 +4916,7 @@ class Rows_log_event : public Log_event
   };
 
   int find_key(const rpl_group_info *); // Find a best key to use in find_row()
+  void prefetch_rows(rpl_group_info *);
   uint find_key_parts(const KEY *key) const;
   bool use_pk_position() const;
   int find_row(rpl_group_info *);
@@ -5394,6 +5443,151 @@ class Ignorable_log_event : public Log_event {
   virtual int get_data_size() { return IGNORABLE_HEADER_LEN; }
 };
 
+
+/* Compression algorithms of Transaction_payload_log_event. */
+enum enum_transaction_payload_alg
+{
+  TRANSACTION_PAYLOAD_ZSTD= 1
+};
+
+/* The algorithm and the uncompressed length, at the start of the body. */
+#define TRANSACTION_PAYLOAD_BODY_HEADER_LEN 9
+
+/**
+  @class Transaction_payload_log_event
+
+  The events of one transaction, compressed together, when
+  binlog_transaction_compression is enabled.
+
+  The event takes the place of the events from the transaction cache. The
+  GTID event before it and the commit (or XA PREPARE) event after it are not
+  compressed, so that crash recovery, the GTID index and the scheduling of
+  the parallel slave work as for any other transaction.
+
+  The events inside have end_log_pos 0, and checksums according to the
+  binlog_checksum of the binlog file that they are in. The slave IO thread
+  writes them to the relay log one by one, so the slave SQL thread never
+  sees this event.
+
+  @section Transaction_payload_log_event_binary_format Binary Format
+
+  The event has no post-header. The body is:
+
+  <table>
+  <caption>Body for Transaction_payload_log_event</caption>
+
+  <tr>
+    <th>Name</th>
+    <th>Format</th>
+    <th>Description</th>
+  </tr>
+
+  <tr>
+    <td>algorithm</td>
+    <td>1 byte enumeration</td>
+    <td>The compression algorithm, always TRANSACTION_PAYLOAD_ZSTD.</td>
+  </tr>
+
+  <tr>
+    <td>uncompressed_length</td>
+    <td>8 byte unsigned integer</td>
+    <td>The total length of the events.</td>
+  </tr>
+
+  <tr>
+    <td>payload</td>
+    <td>rest of the event</td>
+    <td>The events, compressed as one zstd frame.</td>
+  </tr>
+  </table>
+*/
+class Transaction_payload_log_event: public Log_event
+{
+public:
+  uint8 algorithm;
+  ulonglong uncompressed_length;
+  /* The compressed events; points into the buffer of the event. */
+  const uchar *payload;
+  ulonglong payload_length;
+
+#ifdef MYSQL_SERVER
+  Transaction_payload_log_event(THD *thd_arg, IO_CACHE *payload_cache_arg,
+                                ulonglong payload_length_arg,
+                                ulonglong uncompressed_length_arg);
+#ifdef HAVE_REPLICATION
+  void pack_info(Protocol* protocol);
+#endif
+#else
+  bool print(FILE *file, PRINT_EVENT_INFO *print_event_info);
+#endif
+  Transaction_payload_log_event(const uchar *buf, uint event_len,
+                                const Format_description_log_event
+                                *description_event);
+  Log_event_type get_type_code() { return TRANSACTION_PAYLOAD_EVENT; }
+  int get_data_size()
+  {
+    return (int) (TRANSACTION_PAYLOAD_BODY_HEADER_LEN + payload_length);
+  }
+  bool is_valid() const { return algorithm == TRANSACTION_PAYLOAD_ZSTD; }
+  bool is_part_of_group() { return 1; }
+#ifdef MYSQL_SERVER
+  bool write(Log_event_writer *writer);
+#endif
+
+private:
+#ifdef MYSQL_SERVER
+  /* The compressed events to write, in a temporary file. */
+  IO_CACHE *payload_cache;
+#if defined(HAVE_REPLICATION)
+  virtual int do_apply_event(rpl_group_info *rgi);
+#endif
+#endif
+};
+
+
+/**
+  Reads the events inside a Transaction_payload_log_event, decompressing
+  only as much of the payload as is needed for the next event. Can be
+  reused for any number of payloads.
+*/
+class Transaction_payload_reader
+{
+public:
+  Transaction_payload_reader()
+    :dstream(0), in(0), in_length(0), in_pos(0), buf(0), buf_size(0),
+     buf_start(0), buf_end(0), uncompressed_length(0), total_out(0),
+     frame_done(false)
+  {}
+  ~Transaction_payload_reader();
+
+  /*
+    Start reading the events of EV. The event (and its buffer) must stay
+    alive while the events are read. Returns true on error.
+  */
+  bool init(const Transaction_payload_log_event *ev);
+
+  /*
+    Get the next event. The event is in a buffer owned by the reader, which
+    the caller may modify, and which is valid until the next call.
+
+    Returns true if the payload is corrupt or on out of memory. At the end of
+    the payload, returns false with *event set to NULL.
+  */
+  bool next(uchar **event, uint *event_len);
+
+private:
+  bool fill(size_t need);
+
+  void *dstream;                              // ZSTD_DStream
+  const uchar *in;
+  size_t in_length, in_pos;
+  /* Decompressed data, of which [buf_start, buf_end) is not read yet. */
+  uchar *buf;
+  size_t buf_size, buf_start, buf_end;
+  ulonglong uncompressed_length, total_out;
+  bool frame_done;
+};
+
 #ifdef MYSQL_CLIENT
 bool copy_cache_to_string_wrapped(IO_CACHE *body,
                                   LEX_STRING *to,
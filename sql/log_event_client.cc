@@ -2336,6 +2336,27 @@ bool Binlog_checkpoint_log_event::print(FILE *file,
 }
 
 
+bool
+Transaction_payload_log_event::print(FILE *file,
+                                     PRINT_EVENT_INFO *print_event_info)
+{
+  char buf1[22], buf2[22];
+  if (print_event_info->short_form)
+    return 0;
+
+  Write_on_release_cache cache(&print_event_info->head_cache, file,
+                               Write_on_release_cache::FLUSH_F);
+
+  if (print_header(&cache, print_event_info, FALSE) ||
+      my_b_printf(&cache, "\tTransaction_payload zstd, %s bytes "
+                  "compressed to %s bytes\n",
+                  ullstr(uncompressed_length, buf1),
+                  ullstr(payload_length, buf2)))
+    return 1;
+  return cache.flush_data();
+}
+
+
 bool
 Gtid_list_log_event::print(FILE *file, PRINT_EVENT_INFO *print_event_info)
 {
@@ -3829,8 +3850,21 @@ Gtid_log_event::print(FILE *file, PRINT_EVENT_INFO *print_event_info)
     if (flags_extra & FL_ROLLBACK_ALTER_E1)
       if (my_b_printf(&cache, " ROLLBACK ALTER id= %lu", sa_seq_no))
         goto err;
+    if (flags_extra & FL_EXTRA_WRITESET_E1)
+      if (my_b_printf(&cache, " writeset=%u", uint{writeset_count}))
+        goto err;
     if (my_b_printf(&cache, "\n"))
       goto err;
+    if ((flags_extra & FL_EXTRA_WRITESET_E1) && print_event_info->verbose)
+    {
+      if (my_b_write_string(&cache, "###   writeset:"))
+        goto err;
+      for (uint i= 0; i < writeset_count; i++)
+        if (my_b_printf(&cache, " %016llx", writeset[i]))
+          goto err;
+      if (my_b_printf(&cache, "\n"))
+        goto err;
+    }
 
     if (!print_event_info->allow_parallel_printed ||
         print_event_info->allow_parallel != !!(flags2 & FL_ALLOW_PARALLEL))
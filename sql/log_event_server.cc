@@ -2824,7 +2824,8 @@ Gtid_log_event::Gtid_log_event(THD *thd_arg, uint64 seq_no_arg,
     seq_no(seq_no_arg), commit_id(commit_id_arg), domain_id(domain_id_arg),
     flags2((standalone ? FL_STANDALONE : 0) |
            (commit_id_arg ? FL_GROUP_COMMIT_ID : 0)),
-    flags_extra(0), extra_engines(0)
+    flags_extra(0), extra_engines(0), writeset(NULL), writeset_count(0),
+    writeset_owned(false)
 {
   cache_type= Log_event::EVENT_NO_CACHE;
   bool is_tmp_table= thd_arg->lex->stmt_accessed_temp_table();
@@ -2938,7 +2939,8 @@ Gtid_log_event::peek(const uchar *event_start, size_t event_len,
 bool
 Gtid_log_event::write(Log_event_writer *writer)
 {
-  uchar buf[GTID_HEADER_LEN+2+sizeof(XID) + /* flags_extra: */ 1+4];
+  uchar buf[GTID_HEADER_LEN+2+sizeof(XID) + /* flags_extra: */ 1+4 +
+            /* sa_seq_no: */ 8 + /* writeset_count: */ 2];
   size_t write_len= 13;
 
   int8store(buf, seq_no);
@@ -2994,14 +2996,37 @@ Gtid_log_event::write(Log_event_writer *writer)
     write_len+= 8;
   }
 
-  if (write_len < GTID_HEADER_LEN)
+  size_t writeset_len= 0;
+  if (flags_extra & FL_EXTRA_WRITESET_E1)
   {
+    DBUG_ASSERT(writeset_count);
+    int2store(buf + write_len, writeset_count);
+    write_len+= 2;
+    writeset_len= size_t{writeset_count} * 8;
+  }
+
+  /*
+    The reader expects the hashes right after the writeset count, so the
+    padding may only go at the very end: with a writeset the event body
+    is never shorter than GTID_HEADER_LEN anyway.
+  */
+  if (write_len + writeset_len < GTID_HEADER_LEN)
+  {
+    DBUG_ASSERT(!writeset_len);
     bzero(buf+write_len, GTID_HEADER_LEN-write_len);
     write_len= GTID_HEADER_LEN;
   }
-  return write_header(writer, write_len) ||
-         write_data(writer, buf, write_len) ||
-         write_footer(writer);
+  if (write_header(writer, write_len + writeset_len) ||
+      write_data(writer, buf, write_len))
+    return true;
+  for (uint i= 0; i < writeset_len / 8; i++)
+  {
+    uchar hash[8];
+    int8store(hash, writeset[i]);
+    if (write_data(writer, hash, sizeof hash))
+      return true;
+  }
+  return write_footer(writer);
 }
 
 
@@ -3071,6 +3096,11 @@ Gtid_log_event::pack_info(Protocol *protocol)
     p= strmov(p, " ROLLBACK ALTER id=");
     p= longlong10_to_str(sa_seq_no, p, 10);
   }
+  if (flags_extra & FL_EXTRA_WRITESET_E1)
+  {
+    p= strmov(p, " writeset=");
+    p= longlong10_to_str(writeset_count, p, 10);
+  }
 
   protocol->store(buf, p-buf, &my_charset_bin);
 }
@@ -5092,6 +5122,9 @@ int Rows_log_event::do_apply_event(rpl_group_info *rgi)
 
     // Do event specific preparations 
     error= do_before_row_operations(rgi);
+    if (likely(!error) && opt_slave_row_prefetch_threads &&
+        thd->slave_thread && !rpl_data.is_online_alter())
+      prefetch_rows(rgi);
 
     /*
       Bug#56662 Assertion failed: next_insert_id == 0, file handler.cc
@@ -7223,6 +7256,66 @@ uint Rows_log_event::find_key_parts(const KEY *key) const
 
   @returns Error code on failure, 0 on success.
 */
+/**
+  Pass the keys of the rows that this Update or Delete event is going to
+  look up to the prefetch threads (@@slave_row_prefetch_threads).
+
+  The rows are unpacked once more into record[0]; the current row position
+  is restored afterwards. The first row is skipped, because the worker is
+  going to look it up right away.
+*/
+void Rows_log_event::prefetch_rows(rpl_group_info *rgi)
+{
+  TABLE *table= m_table;
+  const Log_event_type type= get_general_type_code();
+  if ((type != UPDATE_ROWS_EVENT && type != DELETE_ROWS_EVENT) ||
+      !m_key_info || !(m_key_info->flags & HA_NOSAME) ||
+      m_usable_key_parts != m_key_info->user_defined_key_parts ||
+      table->s->tmp_table != NO_TMP_TABLE || table->versioned())
+    return;
+
+  const uchar *const curr_row= m_curr_row, *const curr_row_end= m_curr_row_end;
+  const uint key_length= m_key_info->key_length;
+  rpl_prefetch_pool::job *j= NULL;
+  Check_level_instant_set clis(thd, CHECK_FIELD_IGNORE);
+
+  prepare_record(table, m_width, FALSE);
+  for (bool first= true; m_curr_row < m_rows_end; first= false)
+  {
+    if (unpack_current_row(rgi))
+      break;
+    if (!first)
+    {
+      if (!j && !(j= global_rpl_prefetch_pool.
+                  alloc_job(table, m_key_nr, rpl_prefetch_pool::JOB_KEYS)))
+        break;
+      key_copy(j->keys() + j->n_keys++ * key_length, table->record[0],
+               m_key_info, 0);
+      if (j->n_keys == rpl_prefetch_pool::JOB_KEYS)
+      {
+        global_rpl_prefetch_pool.submit(j);
+        j= NULL;
+      }
+    }
+    m_curr_row= m_curr_row_end;
+    if (type == UPDATE_ROWS_EVENT)
+    {
+      /* Skip the after image */
+      if (m_curr_row >= m_rows_end || unpack_current_row(rgi, &m_cols_ai))
+        break;
+      m_curr_row= m_curr_row_end;
+    }
+  }
+
+  if (j && j->n_keys)
+    global_rpl_prefetch_pool.submit(j);
+  else
+    my_free(j);
+  m_curr_row= curr_row;
+  m_curr_row_end= curr_row_end;
+}
+
+
 int Rows_log_event::find_key(const rpl_group_info *rgi)
 {
   DBUG_ASSERT(m_table);
@@ -8195,6 +8288,79 @@ void Ignorable_log_event::pack_info(Protocol *protocol)
 }
 
 
+/**************************************************************************
+  Transaction_payload_log_event methods
+**************************************************************************/
+
+Transaction_payload_log_event::Transaction_payload_log_event(
+        THD *thd_arg, IO_CACHE *payload_cache_arg,
+        ulonglong payload_length_arg, ulonglong uncompressed_length_arg)
+  :Log_event(thd_arg, 0, FALSE), algorithm(TRANSACTION_PAYLOAD_ZSTD),
+   uncompressed_length(uncompressed_length_arg), payload(0),
+   payload_length(payload_length_arg), payload_cache(payload_cache_arg)
+{
+  cache_type= EVENT_NO_CACHE;
+  /*
+    Each of the events inside has its own @@skip_replication flag, the
+    slave IO thread filters them.
+  */
+  flags&= ~LOG_EVENT_SKIP_REPLICATION_F;
+}
+
+
+#if defined(HAVE_REPLICATION)
+void Transaction_payload_log_event::pack_info(Protocol *protocol)
+{
+  char buf[128];
+  size_t bytes;
+  bytes= my_snprintf(buf, sizeof(buf),
+                     "zstd, %llu bytes compressed to %llu bytes",
+                     uncompressed_length, payload_length);
+  protocol->store(buf, bytes, &my_charset_bin);
+}
+
+
+int Transaction_payload_log_event::do_apply_event(rpl_group_info *rgi)
+{
+  /*
+    The slave IO thread writes the events of the payload to the relay log
+    instead of the event itself, so this can only be reached with a relay
+    log from somewhere else.
+  */
+  rgi->rli->report(ERROR_LEVEL, ER_BINLOG_UNCOMPRESS_ERROR, rgi->gtid_info(),
+                   "Transaction_payload event must be uncompressed by the "
+                   "slave IO thread");
+  return 1;
+}
+#endif
+
+
+bool Transaction_payload_log_event::write(Log_event_writer *writer)
+{
+  uchar buf[TRANSACTION_PAYLOAD_BODY_HEADER_LEN];
+  buf[0]= algorithm;
+  int8store(buf + 1, uncompressed_length);
+  if (write_header(writer, TRANSACTION_PAYLOAD_BODY_HEADER_LEN +
+                           payload_length) ||
+      write_data(writer, buf, sizeof(buf)) ||
+      reinit_io_cache(payload_cache, READ_CACHE, 0, 0, 0))
+    return 1;
+  my_off_t left= payload_length;
+  while (left)
+  {
+    size_t length= my_b_bytes_in_cache(payload_cache);
+    if (!length && !(length= my_b_fill(payload_cache)))
+      return 1;
+    length= (size_t) MY_MIN(length, left);
+    if (write_data(writer, payload_cache->read_pos, length))
+      return 1;
+    payload_cache->read_pos+= length;
+    left-= length;
+  }
+  return write_footer(writer);
+}
+
+
 #if defined(HAVE_REPLICATION)
 Heartbeat_log_event::Heartbeat_log_event(const uchar *buf, uint event_len,
                     const Format_description_log_event* description_event)
@@ -364,6 +364,8 @@ static longlong start_memory_used;
 bool opt_bin_log, opt_bin_log_used=0, opt_ignore_builtin_innodb= 0;
 bool opt_bin_log_compress;
 uint opt_bin_log_compress_min_len;
+my_bool opt_binlog_transaction_compression;
+uint opt_binlog_transaction_compression_level;
 my_bool opt_log, debug_assert_if_crashed_table= 0, opt_help= 0;
 my_bool debug_assert_on_not_freed_memory= 0;
 my_bool disable_log_notes, opt_support_flashback= 0;
@@ -479,6 +481,7 @@ ulonglong slave_type_conversions_options;
 ulong thread_cache_size=0;
 ulonglong binlog_cache_size=0;
 ulonglong binlog_file_cache_size=0;
+ulonglong opt_binlog_dump_cache_size= 0;
 uint slave_connections_needed_for_purge;
 ulonglong max_binlog_cache_size=0;
 ulonglong internal_binlog_space_limit;
@@ -502,11 +505,14 @@ ulong specialflag=0;
 ulong binlog_cache_use= 0, binlog_cache_disk_use= 0;
 ulong binlog_stmt_cache_use= 0, binlog_stmt_cache_disk_use= 0;
 ulong binlog_gtid_index_hit= 0, binlog_gtid_index_miss= 0;
+ulong binlog_dump_cache_hit= 0, binlog_dump_cache_miss= 0;
 ulong max_connections, max_connect_errors;
 uint max_password_errors;
 ulong extra_max_connections;
 uint max_digest_length= 0;
 ulong slave_retried_transactions;
+ulong slave_writeset_dependency_waits;
+ulong slave_prefetched_rows;
 ulong transactions_multi_engine;
 ulong rpl_transactions_multi_engine;
 ulong transactions_gtid_foreign_engine;
@@ -555,7 +561,9 @@ ulong opt_slave_domain_parallel_threads= 0;
 ulong opt_slave_parallel_mode;
 ulong opt_binlog_commit_wait_count= 0;
 ulong opt_binlog_commit_wait_usec= 0;
+ulong opt_binlog_writeset_size= 0;
 ulong opt_slave_parallel_max_queued= 131072;
+ulong opt_slave_row_prefetch_threads= 0;
 my_bool opt_gtid_ignore_duplicates= FALSE;
 uint opt_gtid_cleanup_batch_size= 64;
 
@@ -949,7 +957,8 @@ PSI_mutex_key key_RELAYLOG_LOCK_index;
 PSI_mutex_key key_LOCK_relaylog_end_pos;
 PSI_mutex_key key_LOCK_thread_id;
 PSI_mutex_key key_LOCK_slave_state, key_LOCK_binlog_state,
-  key_LOCK_rpl_thread, key_LOCK_rpl_thread_pool, key_LOCK_parallel_entry;
+  key_LOCK_rpl_thread, key_LOCK_rpl_thread_pool, key_LOCK_parallel_entry,
+  key_LOCK_rpl_prefetch, key_LOCK_binlog_dump_cache;
 PSI_mutex_key key_LOCK_rpl_semi_sync_master_enabled;
 PSI_mutex_key key_LOCK_binlog;
 
@@ -1048,6 +1057,8 @@ static PSI_mutex_info all_server_mutexes[]=
   { &key_LOCK_rpl_thread, "LOCK_rpl_thread", 0},
   { &key_LOCK_rpl_thread_pool, "LOCK_rpl_thread_pool", 0},
   { &key_LOCK_parallel_entry, "LOCK_parallel_entry", 0},
+  { &key_LOCK_rpl_prefetch, "LOCK_rpl_prefetch", 0},
+  { &key_LOCK_binlog_dump_cache, "LOCK_binlog_dump_cache", 0},
   { &key_LOCK_ack_receiver, "Ack_receiver::mutex", 0},
   { &key_LOCK_rpl_semi_sync_master_enabled, "LOCK_rpl_semi_sync_master_enabled", 0},
   { &key_LOCK_binlog, "LOCK_binlog", 0}
@@ -1056,6 +1067,7 @@ static PSI_mutex_info all_server_mutexes[]=
 PSI_rwlock_key key_rwlock_LOCK_grant, key_rwlock_LOCK_logger,
   key_rwlock_LOCK_sys_init_connect, key_rwlock_LOCK_sys_init_slave,
   key_rwlock_LOCK_system_variables_hash, key_rwlock_query_cache_query_lock,
+  key_rwlock_query_cache_shard_lock,
   key_LOCK_SEQUENCE,
   key_rwlock_LOCK_vers_stats, key_rwlock_LOCK_stat_serial,
   key_rwlock_LOCK_ssl_refresh,
@@ -1074,6 +1086,7 @@ static PSI_rwlock_info all_server_rwlocks[]=
   { &key_LOCK_SEQUENCE, "LOCK_SEQUENCE", 0},
   { &key_rwlock_LOCK_system_variables_hash, "LOCK_system_variables_hash", PSI_FLAG_GLOBAL},
   { &key_rwlock_query_cache_query_lock, "Query_cache_query::lock", 0},
+  { &key_rwlock_query_cache_shard_lock, "Query_cache_shard::lock", 0},
   { &key_rwlock_LOCK_vers_stats, "Vers_field_stats::lock", 0},
   { &key_rwlock_LOCK_stat_serial, "TABLE_SHARE::LOCK_stat_serial", 0},
   { &key_rwlock_LOCK_ssl_refresh, "LOCK_ssl_refresh", PSI_FLAG_GLOBAL },
@@ -1109,7 +1122,7 @@ PSI_cond_key key_TC_LOG_MMAP_COND_queue_busy;
 PSI_cond_key key_COND_rpl_thread_queue, key_COND_rpl_thread,
   key_COND_rpl_thread_stop, key_COND_rpl_thread_pool,
   key_COND_parallel_entry, key_COND_group_commit_orderer,
-  key_COND_prepare_ordered;
+  key_COND_prepare_ordered, key_COND_rpl_prefetch, key_COND_binlog_dump_cache;
 PSI_cond_key key_COND_wait_gtid, key_COND_gtid_ignore_duplicates;
 PSI_cond_key key_COND_ack_receiver;
 
@@ -1155,6 +1168,8 @@ static PSI_cond_info all_server_conds[]=
   { &key_COND_parallel_entry, "COND_parallel_entry", 0},
   { &key_COND_group_commit_orderer, "COND_group_commit_orderer", 0},
   { &key_COND_prepare_ordered, "COND_prepare_ordered", 0},
+  { &key_COND_rpl_prefetch, "COND_rpl_prefetch", 0},
+  { &key_COND_binlog_dump_cache, "COND_binlog_dump_cache", 0},
   { &key_COND_start_thread, "COND_start_thread", PSI_FLAG_GLOBAL},
   { &key_COND_wait_gtid, "COND_wait_gtid", 0},
   { &key_COND_gtid_ignore_duplicates, "COND_gtid_ignore_duplicates", 0},
@@ -1168,6 +1183,9 @@ PSI_thread_key key_thread_delayed_insert,
   key_thread_one_connection, key_thread_signal_hand,
   key_thread_slave_background, key_rpl_parallel_thread;
 PSI_thread_key key_thread_ack_receiver;
+PSI_thread_key key_thread_filesort_merge;
+PSI_thread_key key_thread_load_data_parser;
+PSI_thread_key key_thread_rpl_prefetch;
 
 static PSI_thread_info all_server_threads[]=
 {
@@ -1178,7 +1196,10 @@ static PSI_thread_info all_server_threads[]=
   { &key_thread_signal_hand, "signal_handler", PSI_FLAG_GLOBAL},
   { &key_thread_slave_background, "slave_background", PSI_FLAG_GLOBAL},
   { &key_thread_ack_receiver, "Ack_receiver", PSI_FLAG_GLOBAL},
-  { &key_rpl_parallel_thread, "rpl_parallel_thread", 0}
+  { &key_thread_filesort_merge, "filesort_merge", 0},
+  { &key_thread_load_data_parser, "load_data_parser", 0},
+  { &key_rpl_parallel_thread, "rpl_parallel_thread", 0},
+  { &key_thread_rpl_prefetch, "rpl_prefetch_thread", 0}
 };
 
 #ifdef HAVE_MMAP
@@ -1920,6 +1941,9 @@ static void mysqld_exit(int exit_code)
   DBUG_ENTER("mysqld_exit");
   rpl_deinit_gtid_waiting();
   rpl_deinit_gtid_slave_state();
+#ifdef HAVE_REPLICATION
+  binlog_dump_cache_free();
+#endif
 #ifdef WITH_WSREP
   wsrep_deinit_server();
   wsrep_sst_auth_free();
@@ -4485,6 +4509,7 @@ static int init_thread_environment()
 #ifdef HAVE_REPLICATION
   rpl_init_gtid_slave_state();
   rpl_init_gtid_waiting();
+  binlog_dump_cache_init();
 #endif
 
   DBUG_RETURN(0);
@@ -6782,6 +6807,9 @@ struct my_option my_long_options[]=
    "with rollback and retry. \"conservative\" limits parallelism in an "
    "effort to avoid any conflicts. \"aggressive\" tries to maximise the "
    "parallelism, possibly at the cost of increased conflict rate. "
+   "\"writeset\" is like \"optimistic\", but does not start a "
+   "transaction before prior transactions that modified the same rows "
+   "have committed, as recorded by the master in --binlog-writeset-size. "
    "\"minimal\" only parallelizes the commit steps of transactions. "
    "\"none\" disables parallel apply completely.",
    &opt_slave_parallel_mode, &opt_slave_parallel_mode,
@@ -7150,6 +7178,7 @@ static int show_ssl_get_cipher_list(THD *thd, SHOW_VAR *var, void *buf,
 
 DEF_SHOW_FUNC(status, SHOW_BOOL)
 DEF_SHOW_FUNC(clients, SHOW_LONG)
+DEF_SHOW_FUNC(yes_transactions, SHOW_LONG)
 DEF_SHOW_FUNC(wait_sessions, SHOW_LONG)
 DEF_SHOW_FUNC(trx_wait_time, SHOW_LONGLONG)
 DEF_SHOW_FUNC(trx_wait_num, SHOW_LONGLONG)
@@ -7410,6 +7439,8 @@ SHOW_VAR status_vars[]= {
   {"Binlog_bytes_written",     (char*) offsetof(STATUS_VAR, binlog_bytes_written), SHOW_LONGLONG_STATUS},
   {"Binlog_cache_disk_use",    (char*) &binlog_cache_disk_use,  SHOW_LONG},
   {"Binlog_cache_use",         (char*) &binlog_cache_use,       SHOW_LONG},
+  {"Binlog_dump_cache_hit",    (char*) &binlog_dump_cache_hit, SHOW_LONG},
+  {"Binlog_dump_cache_miss",   (char*) &binlog_dump_cache_miss, SHOW_LONG},
   {"Binlog_gtid_index_hit",    (char*) &binlog_gtid_index_hit, SHOW_LONG},
   {"Binlog_gtid_index_miss",   (char*) &binlog_gtid_index_miss, SHOW_LONG},
   {"Binlog_stmt_cache_disk_use",(char*) &binlog_stmt_cache_disk_use,  SHOW_LONG},
@@ -7421,6 +7452,8 @@ SHOW_VAR status_vars[]= {
   {"Column_compressions",      (char*) offsetof(STATUS_VAR, column_compressions), SHOW_LONG_STATUS},
   {"Column_decompressions",    (char*) offsetof(STATUS_VAR, column_decompressions), SHOW_LONG_STATUS},
   {"Com",                      (char*) com_status_vars, SHOW_ARRAY},
+  {"Compressed_bytes_received", (char*) offsetof(STATUS_VAR, compressed_bytes_received), SHOW_LONGLONG_STATUS},
+  {"Compressed_bytes_sent",    (char*) offsetof(STATUS_VAR, compressed_bytes_sent), SHOW_LONGLONG_STATUS},
   {"Compression",              (char*) &show_net_compression, SHOW_SIMPLE_FUNC},
   {"Connections",              (char*) &global_thread_id,         SHOW_LONG_NOFLUSH},
   {"Connection_errors_accept", (char*) &connection_errors_accept, SHOW_LONG},
@@ -7521,7 +7554,7 @@ SHOW_VAR status_vars[]= {
 #ifdef HAVE_REPLICATION
   SHOW_FUNC_ENTRY("Rpl_semi_sync_master_status", &SHOW_FNAME(status)),
   SHOW_FUNC_ENTRY("Rpl_semi_sync_master_clients", &SHOW_FNAME(clients)),
-  {"Rpl_semi_sync_master_yes_tx", (char*) &rpl_semi_sync_master_yes_transactions, SHOW_LONG},
+  SHOW_FUNC_ENTRY("Rpl_semi_sync_master_yes_tx", &SHOW_FNAME(yes_transactions)),
   {"Rpl_semi_sync_master_no_tx", (char*) &rpl_semi_sync_master_no_transactions, SHOW_LONG},
   SHOW_FUNC_ENTRY("Rpl_semi_sync_master_wait_sessions", &SHOW_FNAME(wait_sessions)),
   {"Rpl_semi_sync_master_no_times", (char*) &rpl_semi_sync_master_off_times, SHOW_LONG},
@@ -7530,6 +7563,7 @@ SHOW_VAR status_vars[]= {
   SHOW_FUNC_ENTRY("Rpl_semi_sync_master_tx_wait_time", &SHOW_FNAME(trx_wait_time)),
   SHOW_FUNC_ENTRY("Rpl_semi_sync_master_tx_waits", &SHOW_FNAME(trx_wait_num)),
   SHOW_FUNC_ENTRY("Rpl_semi_sync_master_tx_avg_wait_time", &SHOW_FNAME(avg_trx_wait_time)),
+  {"Rpl_semi_sync_master_tx_wait_histogram", (char*) rpl_semi_sync_master_trx_wait_histogram_vars, SHOW_ARRAY},
   SHOW_FUNC_ENTRY("Rpl_semi_sync_master_net_wait_time", &SHOW_FNAME(net_wait_time)),
   SHOW_FUNC_ENTRY("Rpl_semi_sync_master_net_waits", &SHOW_FNAME(net_wait_num)),
   SHOW_FUNC_ENTRY("Rpl_semi_sync_master_net_avg_wait_time", &SHOW_FNAME(avg_net_wait_time)),
@@ -7564,10 +7598,12 @@ SHOW_VAR status_vars[]= {
   {"Slaves_running",          (char*) &show_slaves_running, SHOW_SIMPLE_FUNC },
   {"Slave_connections",       (char*) offsetof(STATUS_VAR, com_register_slave), SHOW_LONG_STATUS},
   {"Slave_heartbeat_period",   (char*) &show_heartbeat_period, SHOW_SIMPLE_FUNC},
+  {"Slave_prefetched_rows",    (char*) &slave_prefetched_rows,  SHOW_LONG},
   {"Slave_received_heartbeats",(char*) &show_slave_received_heartbeats, SHOW_SIMPLE_FUNC},
   {"Slave_retried_transactions",(char*)&slave_retried_transactions, SHOW_LONG},
   {"Slave_running",            (char*) &show_slave_running,     SHOW_SIMPLE_FUNC},
   {"Slave_skipped_errors",     (char*) &slave_skipped_errors, SHOW_LONGLONG},
+  {"Slave_writeset_dependency_waits",(char*)&slave_writeset_dependency_waits, SHOW_LONG},
 #endif
   {"Slow_launch_threads",      (char*) &slow_launch_threads,    SHOW_LONG},
   {"Slow_queries",             (char*) offsetof(STATUS_VAR, long_query_count), SHOW_LONG_STATUS},
@@ -7634,6 +7670,8 @@ SHOW_VAR status_vars[]= {
   {"Transactions_multi_engine", (char*) &transactions_multi_engine, SHOW_LONG},
   {"Rpl_transactions_multi_engine", (char*) &rpl_transactions_multi_engine, SHOW_LONG},
   {"Transactions_gtid_foreign_engine", (char*) &transactions_gtid_foreign_engine, SHOW_LONG},
+  {"Uncompressed_bytes_received", (char*) offsetof(STATUS_VAR, uncompressed_bytes_received), SHOW_LONGLONG_STATUS},
+  {"Uncompressed_bytes_sent",  (char*) offsetof(STATUS_VAR, uncompressed_bytes_sent), SHOW_LONGLONG_STATUS},
   {"Update_scan",	       (char*) offsetof(STATUS_VAR, update_scan_count), SHOW_LONG_STATUS},
   {"Uptime",                   (char*) &show_starttime,         SHOW_SIMPLE_FUNC},
 #ifdef ENABLED_PROFILING
@@ -7839,6 +7877,7 @@ static int mysql_init_variables(void)
   specialflag= 0;
   binlog_cache_use=  binlog_cache_disk_use= 0;
   binlog_gtid_index_hit= binlog_gtid_index_miss= 0;
+  binlog_dump_cache_hit= binlog_dump_cache_miss= 0;
   max_used_connections= slow_launch_threads = 0;
   max_used_connections_time= 0;
   mysqld_user= mysqld_chroot= opt_init_file= opt_bin_logname = 0;
@@ -7899,6 +7938,8 @@ static int mysql_init_variables(void)
   report_user= report_password = report_host= 0;	/* TO BE DELETED */
   opt_relay_logname= opt_relaylog_index_name= 0;
   slave_retried_transactions= 0;
+  slave_writeset_dependency_waits= 0;
+  slave_prefetched_rows= 0;
   transactions_multi_engine= 0;
   rpl_transactions_multi_engine= 0;
   transactions_gtid_foreign_engine= 0;
@@ -9374,6 +9415,7 @@ PSI_stage_info stage_binlog_stopping_background_thread= { 0, "Stopping binlog ba
 PSI_stage_info stage_waiting_for_work_from_sql_thread= { 0, "Waiting for work from SQL thread", 0};
 PSI_stage_info stage_waiting_for_prior_transaction_to_commit= { 0, "Waiting for prior transaction to commit", 0};
 PSI_stage_info stage_waiting_for_prior_transaction_to_start_commit= { 0, "Waiting for prior transaction to start commit", 0};
+PSI_stage_info stage_waiting_for_writeset_dependency= { 0, "Waiting for prior transaction with a conflicting writeset to commit", 0};
 PSI_stage_info stage_waiting_for_room_in_worker_thread= { 0, "Waiting for room in worker thread event queue", 0};
 PSI_stage_info stage_waiting_for_workers_idle= { 0, "Waiting for worker threads to be idle", 0};
 PSI_stage_info stage_waiting_for_ftwrl= { 0, "Waiting due to global read lock", 0};
@@ -9597,6 +9639,7 @@ PSI_stage_info *all_server_stages[]=
   & stage_waiting_for_master_update,
   & stage_waiting_for_prior_transaction_to_commit,
   & stage_waiting_for_prior_transaction_to_start_commit,
+  & stage_waiting_for_writeset_dependency,
   & stage_waiting_for_query_cache_lock,
   & stage_waiting_for_relay_log_space,
   & stage_waiting_for_room_in_worker_thread,
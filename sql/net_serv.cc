@@ -121,6 +121,68 @@ extern my_bool thd_net_is_killed(THD *thd);
 
 static my_bool net_write_buff(NET *, const uchar *, size_t len);
 
+#ifdef HAVE_COMPRESS
+/**
+  Compress a packet into 'to'.
+
+  A client connection of the server keeps its zlib state in
+  THD::net_compress_stream, so it is not set up again for every packet.
+
+  @return 0 if 'to' contains the packet, compressed or not
+*/
+
+static my_bool net_compress(NET *net, uchar *to, const uchar *packet,
+                            size_t *len, size_t *complen)
+{
+#ifdef MYSQL_SERVER
+  THD *thd= (THD*) net->thd;
+  if (thd && net == &thd->net)
+  {
+    if (!thd->net_compress_stream)
+      thd->net_compress_stream= my_compress_stream_alloc();
+    if (thd->net_compress_stream &&
+        !my_compress_stream(thd->net_compress_stream,
+                            (int) thd->variables.net_compression_level,
+                            to, packet, len, complen) &&
+        *complen)
+    {
+      thd->status_var.compressed_bytes_sent+= *len;
+      thd->status_var.uncompressed_bytes_sent+= *complen;
+      return 0;
+    }
+    *complen= 0;
+    memcpy(to, packet, *len);
+    return 0;
+  }
+#endif
+  memcpy(to, packet, *len);
+  return my_compress(to, len, complen);
+}
+
+
+/** Uncompress a packet in place, see net_compress() */
+
+static my_bool net_uncompress(NET *net, uchar *packet, size_t len,
+                              size_t *complen)
+{
+#ifdef MYSQL_SERVER
+  THD *thd= (THD*) net->thd;
+  if (thd && net == &thd->net && *complen)
+  {
+    if (!thd->net_compress_stream &&
+        !(thd->net_compress_stream= my_compress_stream_alloc()))
+      return 1;
+    if (my_uncompress_stream(thd->net_compress_stream, packet, len, complen))
+      return 1;
+    thd->status_var.compressed_bytes_received+= len;
+    thd->status_var.uncompressed_bytes_received+= *complen;
+    return 0;
+  }
+#endif
+  return my_uncompress(packet, len, complen);
+}
+#endif /* HAVE_COMPRESS */
+
 my_bool net_allocate_new_packet(NET *net, void *thd, uint my_flags);
 
 /** Init with packet info. */
@@ -673,10 +735,13 @@ net_real_write(NET *net,const uchar *packet, size_t len)
       net->reading_or_writing= 0;
       DBUG_RETURN(1);
     }
-    memcpy(b+header_length,packet,len);
-
     /* Don't compress error packets (compress == 2) */
-    if (net->compress == 2 || my_compress(b+header_length, &len, &complen))
+    if (net->compress == 2)
+    {
+      memcpy(b+header_length,packet,len);
+      complen=0;
+    }
+    else if (net_compress(net, b+header_length, packet, &len, &complen))
       complen=0;
     int3store(&b[NET_HEADER_SIZE],complen);
     int3store(b,len);
@@ -1189,8 +1254,8 @@ my_net_read_packet_reallen(NET *net, my_bool read_from_server, ulong* reallen)
 	return packet_error;
       }
       read_from_server= 0;
-      if (my_uncompress(net->buff + net->where_b, packet_len,
-			&complen))
+      if (net_uncompress(net, net->buff + net->where_b, packet_len,
+                         &complen))
       {
 	net->error= 2;			/* caller will close socket */
         net->last_errno= ER_NET_UNCOMPRESS_ERROR;
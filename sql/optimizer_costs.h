@@ -108,6 +108,7 @@ extern OPTIMIZER_COSTS heap_optimizer_costs, tmp_table_optimizer_costs;
 */
 #define QSORT_SORT_SLOWNESS_CORRECTION_FACTOR    (0.1)
 #define PQ_SORT_SLOWNESS_CORRECTION_FACTOR       (0.1)
+#define RADIX_SORT_SLOWNESS_CORRECTION_FACTOR    (0.1)
 
 /*
   Creating a record from the join cache is faster than getting a row from
@@ -251,6 +251,8 @@ class Master_info : public Slave_reporting_capability
     @@global.binlog_checksum and deactivated once FD has been received.
   */
   enum_binlog_checksum_alg checksum_alg_before_fd;
+  /* Expands the Transaction_payload events received from the master. */
+  Transaction_payload_reader payload_reader;
   uint connect_retry;
 #ifndef DBUG_OFF
   int events_till_disconnect;
@@ -382,6 +384,12 @@ class Master_info : public Slave_reporting_capability
     ignored
   */
   bool semi_sync_reply_enabled;
+  /*
+    Set when the reply to an event that needed one was deferred, to be
+    coalesced with the reply to a later event.
+  */
+  bool semi_sync_reply_pending= false;
+  ulonglong semi_sync_reply_pending_since;
   List <start_alter_info> start_alter_list;
   MEM_ROOT mem_root;
   /*
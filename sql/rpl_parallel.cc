@@ -5,6 +5,7 @@
 #include "sql_parse.h"
 #include "debug_sync.h"
 #include "sql_repl.h"
+#include "sql_base.h"
 #include "wsrep_mysqld.h"
 #ifdef WITH_WSREP
 #include "wsrep_trans_observer.h"
@@ -24,6 +25,7 @@
 
 
 struct rpl_parallel_thread_pool global_rpl_thread_pool;
+struct rpl_prefetch_pool global_rpl_prefetch_pool;
 
 static void signal_error_to_sql_driver_thread(THD *thd, rpl_group_info *rgi,
                                               int err);
@@ -546,6 +548,49 @@ do_ftwrl_wait(rpl_group_info *rgi,
 }
 
 
+/*
+  With slave_parallel_mode=writeset, do not start this event group until the
+  last prior event group that modified any of the same rows has committed.
+
+  Returns non-zero if killed while waiting.
+*/
+static int
+do_writeset_wait(rpl_group_info *rgi)
+{
+  THD *thd= rgi->thd;
+  rpl_parallel_entry *entry= rgi->parallel_entry;
+  uint64 sub_id= rgi->writeset_wait_sub_id;
+  PSI_stage_info old_stage;
+  int err= 0;
+
+  mysql_mutex_lock(&entry->LOCK_parallel_entry);
+  if (entry->last_committed_sub_id >= sub_id)
+  {
+    mysql_mutex_unlock(&entry->LOCK_parallel_entry);
+    return 0;
+  }
+
+  statistic_increment(slave_writeset_dependency_waits, LOCK_status);
+  ++entry->need_sub_id_signal;
+  thd->set_time_for_next_stage();
+  thd->ENTER_COND(&entry->COND_parallel_entry, &entry->LOCK_parallel_entry,
+                  &stage_waiting_for_writeset_dependency, &old_stage);
+  do
+  {
+    if (unlikely(thd->check_killed()))
+    {
+      thd->send_kill_message();
+      err= 1;
+      break;
+    }
+    mysql_cond_wait(&entry->COND_parallel_entry, &entry->LOCK_parallel_entry);
+  } while (entry->last_committed_sub_id < sub_id);
+  --entry->need_sub_id_signal;
+  thd->EXIT_COND(&old_stage);
+  return err;
+}
+
+
 static int
 pool_mark_busy(rpl_parallel_thread_pool *pool, THD *thd)
 {
@@ -1472,6 +1517,12 @@ handle_rpl_parallel_thread(void *arg)
           slave_output_error_info(rgi, thd);
           signal_error_to_sql_driver_thread(thd, rgi, 1);
         }
+        else if (rgi->writeset_wait_sub_id && !skip_event_group &&
+                 (err= do_writeset_wait(rgi)))
+        {
+          slave_output_error_info(rgi, thd);
+          signal_error_to_sql_driver_thread(thd, rgi, 1);
+        }
       }
 
       group_rgi= rgi;
@@ -2784,12 +2835,53 @@ free_rpl_parallel_entry(void *element)
     e->current_gco= prev_gco;
   }
   delete_dynamic(&e->maybe_active_xid);
+  my_free(e->writeset_slots);
   mysql_cond_destroy(&e->COND_parallel_entry);
   mysql_mutex_destroy(&e->LOCK_parallel_entry);
   my_free(e);
 }
 
 
+/*
+  Determine the event group that must commit before an event group may start
+  with slave_parallel_mode=writeset, and record the writeset of the event
+  group.
+
+  Each hash of the writeset maps to a slot that holds the sub_id of the last
+  event group whose writeset had a hash mapping to the same slot. Collisions
+  only cause unnecessary waits. An event group without a writeset may access
+  any rows; the following event groups with a writeset will wait for it.
+
+  @param gtid_ev  the GTID event with a writeset, or NULL
+  @param sub_id   the sub_id of the event group
+
+  @return the sub_id to wait for, or 0
+*/
+uint64
+rpl_parallel_entry::writeset_dependency(const Gtid_log_event *gtid_ev,
+                                        uint64 sub_id)
+{
+  if (!gtid_ev ||
+      (!writeset_slots &&
+       !(writeset_slots= static_cast<uint64*>
+         (my_malloc(PSI_INSTRUMENT_ME, WRITESET_SLOTS * sizeof *writeset_slots,
+                    MYF(MY_ZEROFILL))))))
+  {
+    writeset_barrier_sub_id= sub_id;
+    return 0;
+  }
+
+  uint64 wait_sub_id= writeset_barrier_sub_id;
+  for (uint i= 0; i < gtid_ev->writeset_count; i++)
+  {
+    uint64 &slot= writeset_slots[gtid_ev->writeset[i] & (WRITESET_SLOTS - 1)];
+    set_if_bigger(wait_sub_id, slot);
+    slot= sub_id;
+  }
+  return wait_sub_id;
+}
+
+
 rpl_parallel::rpl_parallel() :
   current(NULL), sql_thread_stopping(false)
 {
@@ -3400,6 +3492,8 @@ rpl_parallel::do_event(rpl_group_info *serial_rgi, Log_event *ev,
     bool new_gco;
     enum_slave_parallel_mode mode= rli->mi->parallel_mode;
     uchar gtid_flags= gtid_ev->flags2;
+    bool use_writeset= mode == SLAVE_PARALLEL_WRITESET &&
+      (gtid_ev->flags_extra & Gtid_log_event::FL_EXTRA_WRITESET_E1);
     group_commit_orderer *gco;
     uint8 force_switch_flag;
     enum rpl_group_info::enum_speculation speculation;
@@ -3475,8 +3569,8 @@ rpl_parallel::do_event(rpl_group_info *serial_rgi, Log_event *ev,
         new_gco= false;
         if (!(gtid_flags & Gtid_log_event::FL_TRANSACTIONAL) ||
             ( (!(gtid_flags & Gtid_log_event::FL_ALLOW_PARALLEL) ||
-               (gtid_flags & Gtid_log_event::FL_WAITED)) &&
-              (mode < SLAVE_PARALLEL_AGGRESSIVE)))
+               ((gtid_flags & Gtid_log_event::FL_WAITED) && !use_writeset)) &&
+              (mode != SLAVE_PARALLEL_AGGRESSIVE)))
         {
           /*
             This transaction should not be speculatively run in parallel with
@@ -3503,6 +3597,16 @@ rpl_parallel::do_event(rpl_group_info *serial_rgi, Log_event *ev,
     }
     rgi->speculation= speculation;
 
+    /*
+      In writeset mode, the event group will wait for any prior event group
+      that modified the same rows to commit before starting, so a lock wait
+      on the master (FL_WAITED) does not predict a conflict.
+    */
+    if (mode == SLAVE_PARALLEL_WRITESET)
+      rgi->writeset_wait_sub_id=
+        e->writeset_dependency(use_writeset ? gtid_ev : NULL,
+                               rgi->gtid_sub_id);
+
     if (gtid_flags & Gtid_log_event::FL_GROUP_COMMIT_ID)
       e->last_commit_id= gtid_ev->commit_id;
     else
@@ -3601,3 +3705,257 @@ rpl_parallel::do_event(rpl_group_info *serial_rgi, Log_event *ev,
 
   return 0;
 }
+
+
+/*
+  Look up the keys of a list of prefetch jobs for the same table, so that
+  the rows will be found in the buffer pool when the worker thread gets to
+  them. The table is opened once for the whole list. Any error is ignored.
+*/
+static void
+rpl_prefetch_rows(THD *thd, rpl_prefetch_pool::job *jobs)
+{
+  rpl_prefetch_pool::job *j= jobs;
+  TABLE_LIST tlist;
+  const LEX_CSTRING db= { j->db, strlen(j->db) };
+  const LEX_CSTRING table_name= { j->table_name, strlen(j->table_name) };
+  ulong found= 0;
+
+  tlist.init_one_table(&db, &table_name, NULL, TL_READ);
+  if (open_and_lock_tables(thd, &tlist, FALSE,
+                           MYSQL_OPEN_IGNORE_LOGGING_FORMAT))
+  {
+    thd->clear_error();
+    close_thread_tables(thd);
+    thd->release_transactional_locks();
+    return;
+  }
+
+  TABLE *table= tlist.table;
+  table->use_all_columns();
+  for (; j && !thd->killed; j= j->next)
+  {
+    /* The table may have been altered after the job was submitted. */
+    if (j->keynr < table->s->keys &&
+        table->key_info[j->keynr].key_length == j->key_length &&
+        !table->file->ha_index_init(j->keynr, FALSE))
+    {
+      const uchar *key= j->keys();
+      for (uint i= 0; i < j->n_keys && !thd->killed;
+           i++, key+= j->key_length)
+        if (!table->file->ha_index_read_map(table->record[0], key,
+                                            HA_WHOLE_KEY, HA_READ_KEY_EXACT))
+          found++;
+      table->file->ha_index_end();
+    }
+  }
+  thd->clear_error();
+
+  ha_commit_trans(thd, FALSE);
+  close_thread_tables(thd);
+  ha_commit_trans(thd, TRUE);
+  thd->release_transactional_locks();
+  statistic_add(slave_prefetched_rows, found, &LOCK_status);
+}
+
+
+pthread_handler_t
+handle_rpl_prefetch_thread(void *arg)
+{
+  rpl_prefetch_pool *pool= static_cast<rpl_prefetch_pool*>(arg);
+
+  my_thread_init();
+  THD *thd= new THD(next_thread_id());
+  thd->thread_stack= (char*) &thd;
+  server_threads.insert(thd);
+  pthread_detach_this_thread();
+  thd->store_globals();
+  thd->system_thread= SYSTEM_THREAD_SLAVE_BACKGROUND;
+  thd->security_ctx->skip_grants();
+  thd->set_command(COM_DAEMON);
+  thd->variables.wsrep_on= 0;
+  thd->variables.option_bits&= ~OPTION_BIN_LOG;
+  /* Non-locking reads that never conflict with the worker threads */
+  thd->variables.tx_isolation= ISO_READ_UNCOMMITTED;
+  /*
+    A job is only a hint; never wait for a metadata lock. A conflicting
+    request (typically DDL applied by a worker) makes the job be skipped
+    instead of queueing this thread in front of or behind the DDL.
+  */
+  thd->variables.lock_wait_timeout= 0;
+  thd_proc_info(thd, "Waiting for rows to prefetch");
+
+  mysql_mutex_lock(&pool->LOCK_rpl_prefetch);
+  for (;;)
+  {
+    if (pool->running > pool->count)
+    {
+      pool->running--;
+      break;
+    }
+    rpl_prefetch_pool::job *j= pool->queue;
+    if (!j)
+    {
+      mysql_cond_wait(&pool->COND_rpl_prefetch, &pool->LOCK_rpl_prefetch);
+      continue;
+    }
+    /*
+      Take the following jobs for the same table too, so that the table is
+      opened and its metadata lock acquired once per batch rather than once
+      per job.
+    */
+    rpl_prefetch_pool::job *last= j;
+    for (uint n= 1;; n++)
+    {
+      pool->queued_size-= sizeof *last +
+        size_t{last->n_keys} * last->key_length;
+      rpl_prefetch_pool::job *next= last->next;
+      if (!next || n >= rpl_prefetch_pool::BATCH_JOBS ||
+          strcmp(next->db, j->db) || strcmp(next->table_name, j->table_name))
+        break;
+      last= next;
+    }
+    if (!(pool->queue= last->next))
+      pool->queue_last= &pool->queue;
+    last->next= NULL;
+    mysql_mutex_unlock(&pool->LOCK_rpl_prefetch);
+
+    thd_proc_info(thd, "Prefetching rows");
+    rpl_prefetch_rows(thd, j);
+    while (j)
+    {
+      rpl_prefetch_pool::job *next= j->next;
+      my_free(j);
+      j= next;
+    }
+    thd_proc_info(thd, "Waiting for rows to prefetch");
+
+    mysql_mutex_lock(&pool->LOCK_rpl_prefetch);
+  }
+  pool->stopping++;
+  mysql_mutex_unlock(&pool->LOCK_rpl_prefetch);
+
+  THD_CHECK_SENTRY(thd);
+  server_threads.erase(thd);
+  delete thd;
+
+  mysql_mutex_lock(&pool->LOCK_rpl_prefetch);
+  pool->stopping--;
+  mysql_cond_broadcast(&pool->COND_rpl_prefetch);
+  mysql_mutex_unlock(&pool->LOCK_rpl_prefetch);
+
+  my_thread_end();
+  return NULL;
+}
+
+
+void
+rpl_prefetch_pool::init()
+{
+  mysql_mutex_init(key_LOCK_rpl_prefetch, &LOCK_rpl_prefetch,
+                   MY_MUTEX_INIT_SLOW);
+  mysql_cond_init(key_COND_rpl_prefetch, &COND_rpl_prefetch, NULL);
+  queue= NULL;
+  queue_last= &queue;
+  queued_size= 0;
+  count= running= stopping= 0;
+  inited= true;
+}
+
+
+void
+rpl_prefetch_pool::destroy()
+{
+  if (!inited)
+    return;
+  resize(0);
+  mysql_cond_destroy(&COND_rpl_prefetch);
+  mysql_mutex_destroy(&LOCK_rpl_prefetch);
+  inited= false;
+}
+
+
+/*
+  Start or stop threads until new_count of them are running. The threads
+  that are asked to stop finish their current job first.
+*/
+int
+rpl_prefetch_pool::resize(uint new_count)
+{
+  int err= 0;
+
+  mysql_mutex_lock(&LOCK_rpl_prefetch);
+  count= new_count;
+  while (running < count)
+  {
+    pthread_t th;
+    if ((err= mysql_thread_create(key_thread_rpl_prefetch, &th,
+                                  &connection_attrib,
+                                  handle_rpl_prefetch_thread, this)))
+    {
+      count= running;
+      break;
+    }
+    running++;
+  }
+  mysql_cond_broadcast(&COND_rpl_prefetch);
+  while (running > count || stopping)
+    mysql_cond_wait(&COND_rpl_prefetch, &LOCK_rpl_prefetch);
+
+  if (!count)
+  {
+    while (job *j= queue)
+    {
+      queue= j->next;
+      my_free(j);
+    }
+    queue_last= &queue;
+    queued_size= 0;
+  }
+  mysql_mutex_unlock(&LOCK_rpl_prefetch);
+  return err;
+}
+
+
+rpl_prefetch_pool::job *
+rpl_prefetch_pool::alloc_job(const TABLE *table, uint keynr, uint n_keys)
+{
+  const uint key_length= table->key_info[keynr].key_length;
+  job *j= static_cast<job*>(my_malloc(PSI_INSTRUMENT_ME,
+                                      sizeof *j + size_t{n_keys} * key_length,
+                                      MYF(0)));
+  if (j)
+  {
+    strmake_buf(j->db, table->s->db.str);
+    strmake_buf(j->table_name, table->s->table_name.str);
+    j->keynr= keynr;
+    j->key_length= key_length;
+    j->n_keys= 0;
+  }
+  return j;
+}
+
+
+/*
+  Queue a job for the prefetch threads, or discard it if too much is
+  already queued.
+*/
+void
+rpl_prefetch_pool::submit(job *j)
+{
+  const size_t size= sizeof *j + size_t{j->n_keys} * j->key_length;
+
+  mysql_mutex_lock(&LOCK_rpl_prefetch);
+  if (!count || queued_size + size > opt_slave_parallel_max_queued)
+  {
+    mysql_mutex_unlock(&LOCK_rpl_prefetch);
+    my_free(j);
+    return;
+  }
+  j->next= NULL;
+  *queue_last= j;
+  queue_last= &j->next;
+  queued_size+= size;
+  mysql_cond_signal(&COND_rpl_prefetch);
+  mysql_mutex_unlock(&LOCK_rpl_prefetch);
+}
@@ -477,6 +477,18 @@ struct rpl_parallel_entry {
   uint64 count_committing_event_groups;
   /* The group_commit_orderer object for the events currently being queued. */
   group_commit_orderer *current_gco;
+  /*
+    For slave_parallel_mode=writeset, the sub_id of the last event group
+    queued with a writeset hash in each of WRITESET_SLOTS slots (indexed by
+    the hash modulo WRITESET_SLOTS). Allocated on first use.
+  */
+  uint64 *writeset_slots;
+  static constexpr uint WRITESET_SLOTS= 4096;
+  /*
+    The sub_id of the last event group queued without a writeset in
+    slave_parallel_mode=writeset.
+  */
+  uint64 writeset_barrier_sub_id;
   /* Relay log info of replication source for this entry. */
   Relay_log_info *rli;
 
@@ -490,6 +502,7 @@ struct rpl_parallel_entry {
                          rpl_group_info *rgi, PSI_stage_info *old_stage);
   int queue_master_restart(rpl_group_info *rgi,
                            Format_description_log_event *fdev);
+  uint64 writeset_dependency(const Gtid_log_event *gtid_ev, uint64 sub_id);
   /*
     the initial size of maybe_ array corresponds to the case of
     each worker receives perhaps unlikely XA-PREPARE and XA-COMMIT within
@@ -515,7 +528,58 @@ struct rpl_parallel {
 };
 
 
+/*
+  Threads that read ahead the rows that are about to be updated or deleted
+  by a replicated row event (--slave-row-prefetch-threads).
+
+  A large transaction is applied by a single worker, one row at a time. When
+  the rows are not in the buffer pool, the worker spends most of its time
+  waiting for one page read after another. The prefetch threads look up the
+  same keys concurrently, using their own non-locking reads, so that the
+  worker finds the pages already cached. A prefetch job is only a hint: the
+  worker never waits for it, and jobs are dropped rather than queued beyond
+  @@slave_parallel_max_queued bytes.
+*/
+struct rpl_prefetch_pool {
+  struct job {
+    job *next;
+    char db[NAME_LEN + 1];
+    char table_name[NAME_LEN + 1];
+    uint keynr;
+    uint key_length;
+    uint n_keys;
+    /* Followed by n_keys keys of key_length bytes each */
+    uchar *keys() { return reinterpret_cast<uchar*>(this + 1); }
+  };
+  /* Maximum number of keys in one job */
+  static constexpr uint JOB_KEYS= 32;
+  /* Maximum number of jobs for the same table that share one table open */
+  static constexpr uint BATCH_JOBS= 8;
+
+  mysql_mutex_t LOCK_rpl_prefetch;
+  mysql_cond_t COND_rpl_prefetch;
+  job *queue;
+  job **queue_last;
+  size_t queued_size;
+  /* Number of threads that should be running */
+  uint count;
+  /* Number of threads that are running */
+  uint running;
+  /* Number of threads that are exiting */
+  uint stopping;
+  bool inited;
+
+  rpl_prefetch_pool() : inited(false) {}
+  void init();
+  void destroy();
+  int resize(uint new_count);
+  job *alloc_job(const TABLE *table, uint keynr, uint n_keys);
+  void submit(job *j);
+};
+
+
 extern struct rpl_parallel_thread_pool global_rpl_thread_pool;
+extern struct rpl_prefetch_pool global_rpl_prefetch_pool;
 
 
 extern void wait_for_pending_deadlock_kill(THD *thd, rpl_group_info *rgi);
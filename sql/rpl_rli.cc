@@ -2144,6 +2144,7 @@ rpl_group_info::reinit(Relay_log_info *rli)
   last_master_timestamp = 0;
   gtid_ignore_duplicate_state= GTID_DUPLICATE_NULL;
   speculation= SPECULATE_NO;
+  writeset_wait_sub_id= 0;
   rpt= NULL;
   start_alter_ev= NULL;
   direct_commit_alter= false;
@@ -2151,7 +2152,7 @@ rpl_group_info::reinit(Relay_log_info *rli)
 }
 
 rpl_group_info::rpl_group_info(Relay_log_info *rli)
-  : thd(0), wait_commit_sub_id(0),
+  : thd(0), wait_commit_sub_id(0), writeset_wait_sub_id(0),
     wait_commit_group_info(0), parallel_entry(0),
     deferred_events(NULL), m_annotate_event(0), is_parallel_exec(false),
     gtid_ev_flags2(0), gtid_ev_flags_extra(0), gtid_ev_sa_seq_no(0),
@@ -733,6 +733,12 @@ struct rpl_group_info
     for the wrong commit).
   */
   uint64 wait_commit_sub_id;
+  /*
+    With slave_parallel_mode=writeset, the sub_id of the last prior event
+    group whose writeset intersects ours. We do not start until that event
+    group has committed. Zero if there is no such dependency.
+  */
+  uint64 writeset_wait_sub_id;
   rpl_group_info *wait_commit_group_info;
   /*
     This holds a pointer to a struct that keeps track of the need to wait
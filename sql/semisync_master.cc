@@ -50,6 +50,23 @@ ulong rpl_semi_sync_master_clients          = 0;
 ulonglong rpl_semi_sync_master_net_wait_time = 0;
 ulonglong rpl_semi_sync_master_trx_wait_time = 0;
 
+/*
+  Histogram of the time transactions waited for a slave reply: the number of
+  waits of at most 100us, 1ms, 10ms, 100ms, 1s, and of more than 1s.
+*/
+#define TRX_WAIT_HISTOGRAM_BUCKETS 6
+ulonglong rpl_semi_sync_master_trx_wait_histogram[TRX_WAIT_HISTOGRAM_BUCKETS];
+
+SHOW_VAR rpl_semi_sync_master_trx_wait_histogram_vars[]= {
+  {"100us", (char*) &rpl_semi_sync_master_trx_wait_histogram[0], SHOW_LONGLONG},
+  {"1ms",   (char*) &rpl_semi_sync_master_trx_wait_histogram[1], SHOW_LONGLONG},
+  {"10ms",  (char*) &rpl_semi_sync_master_trx_wait_histogram[2], SHOW_LONGLONG},
+  {"100ms", (char*) &rpl_semi_sync_master_trx_wait_histogram[3], SHOW_LONGLONG},
+  {"1s",    (char*) &rpl_semi_sync_master_trx_wait_histogram[4], SHOW_LONGLONG},
+  {"more",  (char*) &rpl_semi_sync_master_trx_wait_histogram[5], SHOW_LONGLONG},
+  {NullS, NullS, SHOW_LONG}
+};
+
 Repl_semi_sync_master repl_semisync_master;
 Ack_receiver ack_receiver;
 
@@ -415,6 +432,7 @@ Repl_semi_sync_master::Repl_semi_sync_master()
     m_init_done(false),
     m_reply_file_name_inited(false),
     m_reply_file_pos(0L),
+    m_reply_pos_key(0),
     m_wait_file_name_inited(false),
     m_wait_file_pos(0),
     m_master_enabled(false),
@@ -472,6 +490,7 @@ int Repl_semi_sync_master::enable_master()
     {
       m_commit_file_name_inited = false;
       m_reply_file_name_inited  = false;
+      m_reply_pos_key= 0;
       m_wait_file_name_inited   = false;
 
       set_master_enabled(true);
@@ -507,6 +526,7 @@ void Repl_semi_sync_master::disable_master()
     m_active_tranxs = NULL;
 
     m_reply_file_name_inited = false;
+    m_reply_pos_key= 0;
     m_wait_file_name_inited  = false;
     m_commit_file_name_inited = false;
 
@@ -592,15 +612,15 @@ void Repl_semi_sync_master::remove_slave()
   @retval -1  Slave is going down (ok)
 */
 
-int Repl_semi_sync_master::report_reply_packet(uint32 server_id,
-                                               const uchar *packet,
-                                               ulong packet_len)
+int Repl_semi_sync_master::read_reply_packet(uint32 server_id,
+                                             const uchar *packet,
+                                             ulong packet_len,
+                                             char *log_file_name,
+                                             my_off_t *log_file_pos)
 {
   int result= 1;                                // Assume error
-  char log_file_name[FN_REFLEN+1];
-  my_off_t log_file_pos;
   ulong log_file_len = 0;
-  DBUG_ENTER("Repl_semi_sync_master::report_reply_packet");
+  DBUG_ENTER("Repl_semi_sync_master::read_reply_packet");
 
   DBUG_EXECUTE_IF("semisync_corrupt_magic",
                   const_cast<uchar*>(packet)[REPLY_MAGIC_NUM_OFFSET]= 0;);
@@ -624,7 +644,7 @@ int Repl_semi_sync_master::report_reply_packet(uint32 server_id,
     goto l_end;
   }
 
-  log_file_pos = uint8korr(packet + REPLY_BINLOG_POS_OFFSET);
+  *log_file_pos = uint8korr(packet + REPLY_BINLOG_POS_OFFSET);
   log_file_len = packet_len - REPLY_BINLOG_NAME_OFFSET;
   if (unlikely(log_file_len >= FN_REFLEN))
   {
@@ -637,11 +657,10 @@ int Repl_semi_sync_master::report_reply_packet(uint32 server_id,
   DBUG_ASSERT(dirname_length(log_file_name) == 0);
 
   DBUG_PRINT("semisync", ("%s: Got reply(%s, %lu) from server %u",
-                          "Repl_semi_sync_master::report_reply_packet",
-                          log_file_name, (ulong)log_file_pos, server_id));
+                          "Repl_semi_sync_master::read_reply_packet",
+                          log_file_name, (ulong)*log_file_pos, server_id));
 
   rpl_semi_sync_master_get_ack++;
-  report_reply_binlog(server_id, log_file_name, log_file_pos);
   DBUG_RETURN(0);
 
 l_end:
@@ -716,6 +735,9 @@ int Repl_semi_sync_master::report_reply_binlog(uint32 server_id,
                                               signal_waiting_transaction);
     if (m_active_tranxs->is_empty())
       m_wait_file_name_inited= false;
+    /* Only after the waiters up to this point have been removed */
+    m_reply_pos_key.store(binlog_pos_key(log_file_name, log_file_pos),
+                          std::memory_order_release);
 
     DBUG_PRINT("semisync", ("%s: Got reply at (%s, %lu)",
                             "Repl_semi_sync_master::report_reply_binlog",
@@ -874,6 +896,22 @@ int Repl_semi_sync_master::commit_trx(const char *trx_wait_binlog_name,
     PSI_stage_info old_stage;
     THD *thd= current_thd;
     bool aborted __attribute__((unused)) = 0;
+
+    /*
+      If the reply for this transaction was already received, its
+      Active_tranx node is gone and there is nothing to wait for: do not
+      acquire LOCK_binlog. The state is checked again under the mutex below
+      in all other cases.
+    */
+    ulonglong trx_key= binlog_pos_key(trx_wait_binlog_name,
+                                      trx_wait_binlog_pos);
+    if (trx_key && is_on() &&
+        trx_key <= m_reply_pos_key.load(std::memory_order_acquire))
+    {
+      m_unlocked_yes_transactions.fetch_add(1);
+      DBUG_RETURN(0);
+    }
+
     set_timespec(start_ts, 0);
 
     DEBUG_SYNC(thd, "rpl_semisync_master_commit_trx_before_lock");
@@ -1005,6 +1043,11 @@ int Repl_semi_sync_master::commit_trx(const char *trx_wait_binlog_name,
         {
           rpl_semi_sync_master_trx_wait_num++;
           rpl_semi_sync_master_trx_wait_time += wait_time;
+          int bucket= 0;
+          for (ulonglong limit= 100; bucket < TRX_WAIT_HISTOGRAM_BUCKETS - 1 &&
+               (ulonglong) wait_time > limit; limit*= 10)
+            bucket++;
+          rpl_semi_sync_master_trx_wait_histogram[bucket]++;
 
           DBUG_EXECUTE_IF("testing_cond_var_per_thd", {
             /*
@@ -1101,11 +1144,33 @@ void Repl_semi_sync_master::switch_off()
     rpl_semi_sync_master_off_times++;
     m_wait_file_name_inited   = false;
     m_reply_file_name_inited  = false;
+    m_reply_pos_key= 0;
     sql_print_information("Semi-sync replication switched OFF.");
   }
   DBUG_VOID_RETURN;
 }
 
+ulonglong Repl_semi_sync_master::binlog_pos_key(const char *log_file_name,
+                                               my_off_t log_file_pos)
+{
+  const char *ext= strrchr(log_file_name, '.');
+  ulonglong key= 0;
+
+  /*
+    Binlog files are numbered with 6 digits, in which case the numerical
+    order is the same as the order of Active_tranx::compare().
+  */
+  if (!ext || strlen(++ext) != 6 || log_file_pos >> 32)
+    return 0;
+  for (; *ext; ext++)
+  {
+    if (!my_isdigit(&my_charset_latin1, *ext))
+      return 0;
+    key= key * 10 + (*ext - '0');
+  }
+  return key << 32 | log_file_pos;
+}
+
 int Repl_semi_sync_master::try_switch_on(int server_id,
                                          const char *log_file_name,
                                          my_off_t log_file_pos)
@@ -1376,9 +1441,11 @@ int Repl_semi_sync_master::after_reset_master()
 
   m_wait_file_name_inited   = false;
   m_reply_file_name_inited  = false;
+  m_reply_pos_key= 0;
   m_commit_file_name_inited = false;
 
   rpl_semi_sync_master_yes_transactions = 0;
+  m_unlocked_yes_transactions= 0;
   rpl_semi_sync_master_no_transactions = 0;
   rpl_semi_sync_master_off_times = 0;
   rpl_semi_sync_master_timefunc_fails = 0;
@@ -1388,6 +1455,8 @@ int Repl_semi_sync_master::after_reset_master()
   rpl_semi_sync_master_trx_wait_time = 0;
   rpl_semi_sync_master_net_wait_num = 0;
   rpl_semi_sync_master_net_wait_time = 0;
+  memset(rpl_semi_sync_master_trx_wait_histogram, 0,
+         sizeof(rpl_semi_sync_master_trx_wait_histogram));
 
   unlock();
 
@@ -1411,6 +1480,8 @@ void Repl_semi_sync_master::set_export_stats()
   lock();
 
   rpl_semi_sync_master_status           = m_state;
+  rpl_semi_sync_master_yes_transactions+=
+    m_unlocked_yes_transactions.exchange(0);
   rpl_semi_sync_master_avg_trx_wait_time=
     ((rpl_semi_sync_master_trx_wait_num) ?
      (ulong)((double)rpl_semi_sync_master_trx_wait_time /
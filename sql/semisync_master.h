@@ -21,6 +21,7 @@
 
 #include "semisync.h"
 #include "semisync_master_ack_receiver.h"
+#include "my_atomic_wrapper.h"
 
 #ifdef HAVE_PSI_INTERFACE
 extern PSI_mutex_key key_LOCK_rpl_semi_sync_master_enabled;
@@ -437,6 +438,18 @@ class Repl_semi_sync_master
   /* The position in that file up to which we have the reply from any slaves. */
   my_off_t        m_reply_file_pos;
 
+  /* binlog_pos_key() of m_reply_file_name and m_reply_file_pos, or 0. It is
+   * read without LOCK_binlog by commit_trx(), so that a transaction that
+   * already got its reply does not have to acquire the mutex.
+   */
+  Atomic_relaxed<ulonglong> m_reply_pos_key;
+
+  /* Transactions that commit_trx() found acknowledged without acquiring
+   * LOCK_binlog. They are added to rpl_semi_sync_master_yes_transactions
+   * by set_export_stats().
+   */
+  Atomic_relaxed<ulong> m_unlocked_yes_transactions;
+
   /* This is set to true when we know the 'smallest' wait position. */
   bool            m_wait_file_name_inited;
 
@@ -494,6 +507,13 @@ class Repl_semi_sync_master
   int try_switch_on(int server_id,
                     const char *log_file_name, my_off_t log_file_pos);
 
+  /* Map a binlog position to an integer that compares like
+   * Active_tranx::compare(), or to 0 if the binlog file name does not have
+   * the usual numerical extension.
+   */
+  static ulonglong binlog_pos_key(const char *log_file_name,
+                                  my_off_t log_file_pos);
+
  public:
   Repl_semi_sync_master();
   ~Repl_semi_sync_master() = default;
@@ -560,9 +580,23 @@ class Repl_semi_sync_master
   /* Remove a semi-sync replication slave */
   void remove_slave();
 
-  /* It parses a reply packet and call report_reply_binlog to handle it. */
-  int report_reply_packet(uint32 server_id, const uchar *packet,
-                        ulong packet_len);
+  /* It parses a reply packet into the binlog position it acknowledges. The
+   * ACK receiver passes the largest position it read from all slaves in one
+   * round to report_reply_binlog.
+   *
+   * Input:
+   *  server_id     - (IN)  slave server id number
+   *  packet        - (IN)  the reply packet
+   *  packet_len    - (IN)  the reply packet length
+   *  log_file_name - (OUT) binlog file name, of at least FN_REFLEN+1 bytes
+   *  log_file_pos  - (OUT) binlog file offset
+   *
+   * Return:
+   *  0: success;  1: error;  -1: the slave is going down
+   */
+  int read_reply_packet(uint32 server_id, const uchar *packet,
+                        ulong packet_len, char *log_file_name,
+                        my_off_t *log_file_pos);
 
   /* In semi-sync replication, reports up to which binlog position we have
    * received replies from the slave indicating that it already get the events.
@@ -732,6 +766,8 @@ extern ulonglong rpl_semi_sync_master_net_wait_time;
 extern ulonglong rpl_semi_sync_master_trx_wait_time;
 extern unsigned long long rpl_semi_sync_master_request_ack;
 extern unsigned long long rpl_semi_sync_master_get_ack;
+extern ulonglong rpl_semi_sync_master_trx_wait_histogram[];
+extern SHOW_VAR rpl_semi_sync_master_trx_wait_histogram_vars[];
 
 /*
   This indicates whether we should keep waiting if no semi-sync slave
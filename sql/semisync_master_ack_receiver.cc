@@ -267,6 +267,11 @@ void Ack_receiver::run()
   {
     int ret, slave_count= 0;
     Slave *slave;
+    /* The largest position acknowledged by the replies read in this round */
+    char ack_file_name[FN_REFLEN+1], log_file_name[FN_REFLEN+1];
+    my_off_t ack_file_pos= 0, log_file_pos;
+    uint32 ack_server_id= 0;
+    bool got_ack= false;
 
     mysql_mutex_lock(&m_mutex);
     if (unlikely(m_status != ST_UP))
@@ -349,34 +354,69 @@ void Ack_receiver::run()
           continue;
         }
 
-        len= my_net_read(&net);
-        if (likely(len != packet_error))
+        /*
+          Read all the replies the slave has sent so far, not only the first
+          one, as they would otherwise wait for the next poll.
+        */
+        do
         {
-          int res;
-          res= repl_semisync_master.report_reply_packet(slave->server_id(),
-                                                        net.read_pos, len);
-          if (unlikely(res < 0))
+          len= my_net_read(&net);
+          if (likely(len != packet_error))
           {
-            /*
-              Slave has sent COM_QUIT or other failure.
-              Delete it from listener
-            */
-            it.remove();
-            m_slaves_changed= true;
+            int res;
+            res= repl_semisync_master.read_reply_packet(slave->server_id(),
+                                                        net.read_pos, len,
+                                                        log_file_name,
+                                                        &log_file_pos);
+            if (unlikely(res < 0))
+            {
+              /*
+                Slave has sent COM_QUIT or other failure.
+                Delete it from listener
+              */
+              it.remove();
+              m_slaves_changed= true;
+              break;
+            }
+            if (res == 0 &&
+                (!got_ack ||
+                 Active_tranx::compare(log_file_name, log_file_pos,
+                                       ack_file_name, ack_file_pos) > 0))
+            {
+              strmake_buf(ack_file_name, log_file_name);
+              ack_file_pos= log_file_pos;
+              ack_server_id= slave->server_id();
+              got_ack= true;
+            }
           }
-        }
-        else if (net.last_errno == ER_NET_READ_ERROR)
-        {
-          if (net.last_errno > 0 && global_system_variables.log_warnings > 2)
-            sql_print_warning("Semisync ack receiver got error %d \"%s\" "
-                              "from slave server-id %d",
-                              net.last_errno, ER_DEFAULT(net.last_errno),
-                              slave->server_id());
-          it.remove();
-          m_slaves_changed= true;
-        }
+          else
+          {
+            if (net.last_errno == ER_NET_READ_ERROR)
+            {
+              if (net.last_errno > 0 &&
+                  global_system_variables.log_warnings > 2)
+                sql_print_warning("Semisync ack receiver got error %d \"%s\" "
+                                  "from slave server-id %d",
+                                  net.last_errno,
+                                  ER_DEFAULT(net.last_errno),
+                                  slave->server_id());
+              it.remove();
+              m_slaves_changed= true;
+            }
+            break;
+          }
+          net_clear(&net, 0);
+        } while (slave->vio.read_pos < slave->vio.read_end);
       }
     }
+    /*
+      Report the replies of all the slaves at once: the waiting transactions
+      up to the largest acknowledged position are all released, with a
+      single acquisition of LOCK_binlog.
+    */
+    if (got_ack)
+      repl_semisync_master.report_reply_binlog(ack_server_id, ack_file_name,
+                                               ack_file_pos);
     mysql_mutex_unlock(&m_mutex);
   }
 
@@ -113,6 +113,7 @@ void Repl_semi_sync_slave::slave_start(Master_info *mi)
 
   set_slave_enabled(semi_sync);
   mi->semi_sync_reply_enabled= 0;
+  mi->semi_sync_reply_pending= false;
 
   sql_print_information("Slave I/O thread: Start %s replication to\
  master '%s@%s:%d' in log '%s' at position %lu",
@@ -263,6 +264,40 @@ int Repl_semi_sync_slave::request_transmit(Master_info *mi)
   return 0;
 }
 
+/*
+  The longest a reply is deferred, while events keep arriving, before it is
+  sent anyway.
+*/
+#define MAX_REPLY_DEFER_USEC 100
+
+bool Repl_semi_sync_slave::defer_reply(Master_info *mi)
+{
+  NET *net= &mi->mysql->net;
+  Vio *vio= net->vio;
+  ulonglong now= microsecond_interval_timer();
+  size_t buffered;
+
+  if (!mi->semi_sync_reply_pending)
+  {
+    mi->semi_sync_reply_pending= true;
+    mi->semi_sync_reply_pending_since= now;
+  }
+
+  /*
+    Only if the next packet is complete in the read buffer, so that reading
+    it does not wait for the master.
+  */
+  if (!net->compress && vio &&
+      (buffered= (size_t) (vio->read_end - vio->read_pos)) >= NET_HEADER_SIZE &&
+      buffered >= NET_HEADER_SIZE + uint3korr(vio->read_pos) &&
+      now - mi->semi_sync_reply_pending_since < MAX_REPLY_DEFER_USEC &&
+      !DBUG_IF("semislave_no_deferred_reply"))
+    return true;
+
+  mi->semi_sync_reply_pending= false;
+  return false;
+}
+
 int Repl_semi_sync_slave::slave_reply(Master_info *mi)
 {
   MYSQL* mysql= mi->mysql;
@@ -88,6 +88,16 @@ class Repl_semi_sync_slave
    * binlog position.
    */
   int slave_reply(Master_info* mi);
+
+  /* Decide whether the reply to the event just queued, or to earlier ones,
+   * can be deferred: it is when the next event is already received, and the
+   * reply sent after it will acknowledge both. This saves the master from
+   * processing one reply per transaction when it sends them in bursts.
+   *
+   * Return:
+   *  true: do not reply now;  false: reply now
+   */
+  bool defer_reply(Master_info *mi);
   void slave_start(Master_info *mi);
   void slave_stop(Master_info *mi);
   void slave_reconnect(Master_info *mi);
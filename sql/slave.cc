@@ -565,6 +565,10 @@ int init_slave()
 
   if (global_rpl_thread_pool.init(opt_slave_parallel_threads))
     return 1;
+  global_rpl_prefetch_pool.init();
+  if (global_rpl_prefetch_pool.resize(opt_slave_row_prefetch_threads))
+    sql_print_warning("Failed to start %lu slave row prefetch threads",
+                      opt_slave_row_prefetch_threads);
 
   slave_background_thread_gtid_loaded= false;
   mysql_manager_submit(bg_rpl_load_gtid_slave_state, NULL);
@@ -1286,6 +1290,7 @@ void slave_prepare_for_shutdown()
   // It's safe to destruct worker pool now when
   // all driver threads are gone.
   global_rpl_thread_pool.deactivate();
+  global_rpl_prefetch_pool.resize(0);
 }
 
 /*
@@ -1317,6 +1322,7 @@ void end_slave()
   mysql_mutex_unlock(&LOCK_active_mi);
 
   global_rpl_thread_pool.destroy();
+  global_rpl_prefetch_pool.destroy();
   free_all_rpl_filters();
   DBUG_VOID_RETURN;
 }
@@ -4767,6 +4773,60 @@ static int try_to_reconnect(THD *thd, MYSQL *mysql, Master_info *mi,
 }
 
 
+/**
+  Send a semi-sync reply to the master.
+
+  @param mi  Master connection information.
+*/
+
+static void send_semi_sync_reply(Master_info *mi)
+{
+  DBUG_EXECUTE_IF("simulate_delay_semisync_slave_reply",
+                  my_sleep(800000););
+  if (repl_semisync_slave.slave_reply(mi))
+  {
+    /*
+      Master is not responding (gone away?) or it has turned semi sync
+      off. Turning off semi-sync responses as there is no point in sending
+      data to the master if the master not receiving the messages.
+      This also stops the logs from getting filled with
+      "Semi-sync slave net_flush() reply failed" messages.
+      On reconnect semi sync will be turned on again, if the
+      master has semi-sync enabled.
+
+      We check mi->abort_slave to see if the io thread was
+      killed and in this case we do not need an error message as
+      we know what is going on.
+     */
+    if (!mi->abort_slave)
+      sql_print_error("Master server does not read semi-sync messages "
+                      "last_error: %s (%d). "
+                      "Fallback to asynchronous replication",
+                      mi->mysql->net.last_error,
+                      mi->mysql->net.last_errno);
+    mi->semi_sync_reply_enabled= 0;
+  }
+}
+
+
+/**
+  Send the semi-sync reply that was deferred to the next event, when the
+  I/O thread is not going to read that event right away.
+
+  @param mi  Master connection information.
+*/
+
+static void flush_semi_sync_reply(Master_info *mi)
+{
+  if (!mi->semi_sync_reply_pending)
+    return;
+  mi->semi_sync_reply_pending= false;
+  if (mi->mysql && repl_semisync_slave.get_slave_enabled() &&
+      mi->semi_sync_reply_enabled)
+    send_semi_sync_reply(mi);
+}
+
+
 /**
   Slave IO thread entry point.
 
@@ -5021,6 +5081,8 @@ pthread_handler_t handle_slave_io(void *arg)
 
       if (unlikely(event_len == packet_error))
       {
+        /* The event the reply was deferred to is not coming */
+        flush_semi_sync_reply(mi);
         uint mysql_error_number= mysql_errno(mysql);
         switch (mysql_error_number) {
         case CR_NET_PACKET_TOO_LARGE:
@@ -5116,34 +5178,10 @@ Stopping slave I/O thread due to out-of-memory error from master");
 
       if (repl_semisync_slave.get_slave_enabled() &&
           mi->semi_sync_reply_enabled &&
-          (mi->semi_ack & SEMI_SYNC_NEED_ACK))
-      {
-        DBUG_EXECUTE_IF("simulate_delay_semisync_slave_reply",
-                        my_sleep(800000););
-        if (repl_semisync_slave.slave_reply(mi))
-        {
-          /*
-            Master is not responding (gone away?) or it has turned semi sync
-            off. Turning off semi-sync responses as there is no point in sending
-            data to the master if the master not receiving the messages.
-            This also stops the logs from getting filled with
-            "Semi-sync slave net_flush() reply failed" messages.
-            On reconnect semi sync will be turned on again, if the
-            master has semi-sync enabled.
-
-            We check mi->abort_slave to see if the io thread was
-            killed and in this case we do not need an error message as
-            we know what is going on.
-           */
-          if (!mi->abort_slave)
-            sql_print_error("Master server does not read semi-sync messages "
-                            "last_error: %s (%d). "
-                            "Fallback to asynchronous replication",
-                            mi->mysql->net.last_error,
-                            mi->mysql->net.last_errno);
-          mi->semi_sync_reply_enabled= 0;
-        }
-      }
+          ((mi->semi_ack & SEMI_SYNC_NEED_ACK) ||
+           mi->semi_sync_reply_pending) &&
+          !repl_semisync_slave.defer_reply(mi))
+        send_semi_sync_reply(mi);
       if (mi->using_gtid == Master_info::USE_GTID_NO &&
           /*
             If rpl_semi_sync_slave_delay_master is enabled, we will flush
@@ -5184,17 +5222,23 @@ Stopping slave I/O thread due to out-of-memory error from master");
       if (rli->log_space_limit && rli->log_space_limit <
           rli->log_space_total &&
           !rli->ignore_log_space_limit)
+      {
+        /* Do not keep the master waiting while the relay log drains */
+        flush_semi_sync_reply(mi);
         if (wait_for_relay_log_space(rli))
         {
           sql_print_error("Slave I/O thread aborted while waiting for relay \
 log space");
           goto err;
         }
+      }
     }
   }
 
   // error = 0;
 err:
+  /* Acknowledge what was queued, on STOP SLAVE and on errors alike */
+  flush_semi_sync_reply(mi);
   // print the current replication position
   if (mi->using_gtid == Master_info::USE_GTID_NO)
     sql_print_information("Slave I/O thread exiting, read up to log '%s', "
@@ -6058,6 +6102,64 @@ static int process_io_rotate(Master_info *mi, Rotate_log_event *rev)
   any >=5.0.0 format.
 */
 
+/*
+  Write the events inside a Transaction_payload_log_event to the relay log,
+  so that the SQL thread executes them like any other events.
+
+  The events that the master would have filtered with @@skip_replication, if
+  they had not been compressed, are filtered here.
+
+  @return 0 or the error code
+*/
+
+static int queue_transaction_payload(Master_info *mi, const uchar *buf,
+                                     ulong event_len,
+                                     enum_binlog_checksum_alg checksum_alg,
+                                     String *error_msg)
+{
+  Relay_log_info *rli= &mi->rli;
+  uint checksum_len= checksum_alg == BINLOG_CHECKSUM_ALG_CRC32 ?
+    BINLOG_CHECKSUM_LEN : 0;
+  Transaction_payload_log_event ev(buf, (uint) (event_len - checksum_len),
+                                   rli->relay_log.description_event_for_queue);
+  Transaction_payload_reader *reader= &mi->payload_reader;
+  uchar *event;
+  uint len;
+  DBUG_ENTER("queue_transaction_payload");
+
+  if (!ev.is_valid() || reader->init(&ev))
+    goto uncompress_error;
+  for (;;)
+  {
+    if (reader->next(&event, &len))
+      goto uncompress_error;
+    if (!event)
+      break;
+    if (opt_replicate_events_marked_for_skip == RPL_SKIP_FILTER_ON_MASTER &&
+        (uint2korr(event + FLAGS_OFFSET) & LOG_EVENT_SKIP_REPLICATION_F))
+      continue;
+    if (mi->do_accept_own_server_id)
+    {
+      int2store(event + FLAGS_OFFSET,
+                uint2korr(event + FLAGS_OFFSET) | LOG_EVENT_ACCEPT_OWN_F);
+      if (checksum_len)
+        int4store(event + len - BINLOG_CHECKSUM_LEN,
+                  my_checksum(0, event, len - BINLOG_CHECKSUM_LEN));
+    }
+    if (rli->relay_log.write_event_buffer(event, len))
+      DBUG_RETURN(ER_SLAVE_RELAY_LOG_WRITE_FAILURE);
+  }
+  DBUG_RETURN(0);
+
+uncompress_error:
+  char llbuf[22];
+  error_msg->append(STRING_WITH_LEN("binlog uncompress error, master log_pos: "));
+  llstr(mi->master_log_pos, llbuf);
+  error_msg->append(llbuf, strlen(llbuf));
+  DBUG_RETURN(ER_BINLOG_UNCOMPRESS_ERROR);
+}
+
+
 static int queue_event(Master_info* mi, const uchar *buf, ulong event_len)
 {
   int error= 0;
@@ -7026,29 +7128,33 @@ static int queue_event(Master_info* mi, const uchar *buf, ulong event_len)
   }
   else
   {
-    if (mi->do_accept_own_server_id)
+    if ((uchar)buf[EVENT_TYPE_OFFSET] == TRANSACTION_PAYLOAD_EVENT)
+      error= queue_transaction_payload(mi, buf, event_len, checksum_alg,
+                                       &error_msg);
+    else
     {
-      int2store(const_cast<uchar*>(buf + FLAGS_OFFSET),
-                uint2korr(buf + FLAGS_OFFSET) | LOG_EVENT_ACCEPT_OWN_F);
-      if (checksum_alg != BINLOG_CHECKSUM_ALG_OFF)
+      if (mi->do_accept_own_server_id)
       {
-        ha_checksum crc= 0;
+        int2store(const_cast<uchar*>(buf + FLAGS_OFFSET),
+                  uint2korr(buf + FLAGS_OFFSET) | LOG_EVENT_ACCEPT_OWN_F);
+        if (checksum_alg != BINLOG_CHECKSUM_ALG_OFF)
+        {
+          ha_checksum crc= 0;
 
-        crc= my_checksum(crc, (const uchar *) buf,
-                         event_len - BINLOG_CHECKSUM_LEN);
-        int4store(&buf[event_len - BINLOG_CHECKSUM_LEN], crc);
+          crc= my_checksum(crc, (const uchar *) buf,
+                           event_len - BINLOG_CHECKSUM_LEN);
+          int4store(&buf[event_len - BINLOG_CHECKSUM_LEN], crc);
+        }
       }
+      if (unlikely(rli->relay_log.write_event_buffer((uchar*)buf, event_len)))
+        error= ER_SLAVE_RELAY_LOG_WRITE_FAILURE;
     }
-    if (likely(!rli->relay_log.write_event_buffer((uchar*)buf, event_len)))
+    if (likely(!error))
     {
       mi->master_log_pos+= inc_pos;
       DBUG_PRINT("info", ("master_log_pos: %lu", (ulong) mi->master_log_pos));
       rli->relay_log.harvest_bytes_written(&rli->log_space_total);
     }
-    else
-    {
-      error= ER_SLAVE_RELAY_LOG_WRITE_FAILURE;
-    }
     rli->ign_master_log_name_end[0]= 0; // last event is not ignored
     if (got_gtid_event)
       rli->ign_gtids.remove_if_present(&event_gtid);
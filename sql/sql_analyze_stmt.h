@@ -210,6 +210,23 @@ class Counter_tracker
 };
 
 
+/*
+  Statistics of a hashed join buffer that did not fit into join_buffer_size
+  and has been spilled into partitions in temporary files.
+*/
+
+class Spill_tracker
+{
+public:
+  Spill_tracker() : r_spills(0), r_partitions(0), r_bytes(0) {}
+  ha_rows r_spills;     /* how many times the join buffer has been spilled */
+  ha_rows r_partitions; /* total number of partitions used by the spills */
+  ulonglong r_bytes;    /* bytes written into the temporary files */
+
+  bool has_spills() const { return (r_spills != 0); }
+};
+
+
 /*
   A class for collecting read statistics.
   
@@ -25,6 +25,8 @@
 (first_block)
 	- list of queries block (queries_blocks)
 	- list of used tables (tables_blocks)
+	- lock-free presence filters of both hashes (queries_filter,
+tables_filter), see Query_cache_filter in sql_cache.h
 
 2. Query cache memory pool (cache) consists of
 	- table of steps of memory bins allocation
@@ -754,6 +756,8 @@ void Query_cache::unlock(void)
   DBUG_ASSERT(m_cache_lock_status == Query_cache::LOCKED ||
               m_cache_lock_status == Query_cache::LOCKED_NO_WAIT);
   m_cache_lock_status= Query_cache::UNLOCKED;
+  if (m_unlocked_hits)
+    hits+= m_unlocked_hits.exchange(0);
   DBUG_PRINT("Query_cache",("Sending signal"));
   mysql_cond_signal(&COND_cache_status_changed);
   DBUG_ASSERT(m_requests_in_progress > 0);
@@ -942,6 +946,25 @@ bool Query_cache_query::try_lock_writing()
 }
 
 
+/*
+  Lock for read without waiting; used by cache hits, which must not block
+  while they hold a shard lock (a writer of the query may be waiting for
+  the shard lock in exclusive mode).
+*/
+
+bool Query_cache_query::try_lock_reading()
+{
+  DBUG_ENTER("Query_cache_block::try_lock_reading");
+  if (mysql_rwlock_tryrdlock(&lock) != 0)
+  {
+    DBUG_PRINT("info", ("can't lock rwlock"));
+    DBUG_RETURN(0);
+  }
+  DBUG_PRINT("info", ("rwlock %p locked", &lock));
+  DBUG_RETURN(1);
+}
+
+
 inline void Query_cache_query::lock_reading()
 {
   RW_RLOCK(&lock);
@@ -1265,6 +1288,28 @@ void mysql_query_cache_invalidate4(THD *thd,
 }
 
 
+/*****************************************************************************
+  Query_cache_filter methods
+*****************************************************************************/
+
+bool Query_cache_filter::init()
+{
+  DBUG_ASSERT(!slots);
+  slots= (std::atomic<uint32> *)
+    my_malloc(key_memory_Query_cache,
+              QUERY_CACHE_FILTER_SLOTS * sizeof(std::atomic<uint32>),
+              MYF(MY_ZEROFILL));
+  return slots == NULL;
+}
+
+
+void Query_cache_filter::free()
+{
+  my_free(slots);
+  slots= NULL;
+}
+
+
 /*****************************************************************************
    Query_cache methods
 *****************************************************************************/
@@ -1279,6 +1324,7 @@ Query_cache::Query_cache(size_t query_cache_limit_arg,
    queries_in_cache(0), hits(0), inserts(0), refused(0),
    total_blocks(0), lowmem_prunes(0),
    m_cache_status(OK),
+   m_unlocked_hits(0),
    min_allocation_unit(ALIGN_SIZE(min_allocation_unit_arg)),
    min_result_data_size(ALIGN_SIZE(min_result_data_size_arg)),
    def_query_hash_size(ALIGN_SIZE(def_query_hash_size_arg)),
@@ -1564,6 +1610,8 @@ def_week_frmt: %zu, in_trans: %d, autocommit: %d",
           unlock();
 	  goto end;
 	}
+	queries_filter.add(&my_charset_bin, (uchar*) query, tot_length);
+	shard_insert(query_block);
 	double_linked_list_simple_include(query_block, &queries_blocks);
 	inserts++;
 	queries_in_cache++;
@@ -1875,23 +1923,13 @@ Query_cache::send_result_to_client(THD *thd, char *org_sql, uint query_length)
       goto err;
     }
   }
-  /*
-    Try to obtain an exclusive lock on the query cache. If the cache is
-    disabled or if a full cache flush is in progress, the attempt to
-    get the lock is aborted.
-
-    The TIMEOUT parameter indicate that the lock is allowed to timeout.
-  */
-  if (try_lock(thd, Query_cache::TIMEOUT))
-    goto err;
-
-  if (query_cache_size == 0)
-  {
-    thd->query_cache_is_applicable= 0;            // Query can't be cached
-    goto err_unlock;
-  }
 
   Query_cache_block *query_block;
+  Query_cache_shard *shard;
+  /*
+    The key is built without the lock, it only depends on the statement and
+    the connection state.
+  */
   if (thd->variables.query_cache_strip_comments)
   {
     if (found_brace)
@@ -1981,13 +2019,40 @@ def_week_frmt: %zu, in_trans: %d, autocommit: %d",
   memcpy((uchar *)(sql + (tot_length - QUERY_CACHE_FLAGS_SIZE)),
 	 (uchar*) &flags, QUERY_CACHE_FLAGS_SIZE);
 
+  /*
+    A statement that is certainly not in the cache is a miss that does not
+    need structure_guard_mutex at all. The statement stays applicable, so
+    store_query() will try to cache its result.
+  */
+  if (!queries_filter.may_contain(&my_charset_bin, (uchar*) sql, tot_length))
+  {
+    DBUG_PRINT("qcache", ("Query is not in query filter"));
+    goto err_miss;
+  }
+
+  /*
+    A hit does not take structure_guard_mutex: the query is searched in its
+    shard, which is locked in shared mode only (see Query_cache_shard).
+    A full cache flush empties the shards before freeing any query, so
+    while it is in progress every statement misses.
+  */
+  fix_local_query_cache_mode(thd);
+  if (query_cache_size == 0)
+  {
+    thd->query_cache_is_applicable= 0;            // Query can't be cached
+    goto err_miss;
+  }
+
+  shard= get_shard((uchar*) sql, tot_length);
 #ifdef WITH_WSREP
   bool once_more;
   once_more= true;
 lookup:
 #endif /* WITH_WSREP */
+  mysql_rwlock_rdlock(&shard->lock);
 
-  query_block = (Query_cache_block *)  my_hash_search(&queries, (uchar*) sql,
+  query_block = (Query_cache_block *)  my_hash_search(&shard->queries,
+                                                      (uchar*) sql,
                                                       tot_length);
   /* Quick abort on unlocked data */
   if (query_block == 0 ||
@@ -2002,18 +2067,24 @@ def_week_frmt: %zu, in_trans: %d, autocommit: %d",
 #ifdef WITH_WSREP
   if (once_more && WSREP_CLIENT(thd) && wsrep_must_sync_wait(thd))
   {
-    unlock();
+    mysql_rwlock_unlock(&shard->lock);
     if (wsrep_sync_wait(thd))
       goto err;
-    if (try_lock(thd, Query_cache::TIMEOUT))
-      goto err;
     once_more= false;
     goto lookup;
   }
 #endif /* WITH_WSREP */
 
-  /* Now lock and test that nothing changed while blocks was unlocked */
-  BLOCK_LOCK_RD(query_block);
+  /*
+    Now lock and test that nothing changed while blocks was unlocked.
+    Don't wait for a writer of the query while holding the shard lock,
+    the writer may be waiting for the shard lock itself.
+  */
+  if (!query_block->query()->try_lock_reading())
+  {
+    DBUG_PRINT("qcache", ("query found, but locked"));
+    goto err_unlock;
+  }
 
   query = query_block->query();
   result_block= query->result();
@@ -2062,7 +2133,7 @@ def_week_frmt: %zu, in_trans: %d, autocommit: %d",
       DBUG_PRINT("qcache",
                  ("Temporary table detected: '%s.%s'",
                   tmptable->db.str, tmptable->table_name.str));
-      unlock();
+      mysql_rwlock_unlock(&shard->lock);
       /*
         We should not store result of this query because it contain
         temporary tables => assign following variable to make check
@@ -2086,7 +2157,7 @@ def_week_frmt: %zu, in_trans: %d, autocommit: %d",
       DBUG_PRINT("qcache",
 		 ("probably no SELECT access to %s.%s =>  return to normal processing",
 		  table_list.db.str, table_list.alias.str));
-      unlock();
+      mysql_rwlock_unlock(&shard->lock);
       thd->query_cache_is_applicable= 0;        // Query can't be cached
       thd->lex->safe_to_cache_query= 0;         // For prepared statements
       BLOCK_UNLOCK_RD(query_block);
@@ -2124,18 +2195,28 @@ def_week_frmt: %zu, in_trans: %d, autocommit: %d",
       {
         DBUG_PRINT("qcache", ("Handler does not allow caching for %.*s",
                               (int)qcache_se_key_len, qcache_se_key_name));
-        BLOCK_UNLOCK_RD(query_block);
         if (engine_data != table->engine_data())
         {
           DBUG_PRINT("qcache",
                      ("Handler require invalidation queries of %.*s %llu-%llu",
                       (int)qcache_se_key_len, qcache_se_key_name,
                       engine_data, table->engine_data()));
-          invalidate_table_internal((uchar *) table->db(),
-                                    table->key_length());
+          /*
+            Invalidation needs structure_guard_mutex, which is taken after
+            the query and shard locks. The table block may be freed as
+            soon as they are released, so copy its key.
+          */
+          uchar table_key[MAX_DBKEY_LENGTH];
+          size_t table_key_length= table->key_length();
+          memcpy(table_key, table->data(), table_key_length);
+          BLOCK_UNLOCK_RD(query_block);
+          mysql_rwlock_unlock(&shard->lock);
+          invalidate_table(thd, table_key, table_key_length);
         }
         else
         {
+          BLOCK_UNLOCK_RD(query_block);
+          mysql_rwlock_unlock(&shard->lock);
           /*
             As this can change from call to call, don't reset set
             thd->lex->safe_to_cache_query
@@ -2149,17 +2230,29 @@ def_week_frmt: %zu, in_trans: %d, autocommit: %d",
         */
         DBUG_ASSERT(! thd->transaction_rollback_request);
         trans_rollback_stmt(thd);
-        goto err_unlock;				// Parse query
+        goto err_miss;				// Parse query
       }
     }
     else
       DBUG_PRINT("qcache", ("handler allow caching %s,%s",
 			    table_list.db.str, table_list.alias.str));
   }
-  move_to_query_list_end(query_block);
-  hits++;
+  /*
+    The LRU order and the hit counter are protected by structure_guard_mutex.
+    Keeping them exact is not worth waiting for it: if the mutex is busy,
+    the query keeps its place in the LRU list, and the hit is counted later.
+  */
+  if (!mysql_mutex_trylock(&structure_guard_mutex))
+  {
+    if (m_cache_lock_status == Query_cache::UNLOCKED)
+      move_to_query_list_end(query_block);
+    hits+= 1 + m_unlocked_hits.exchange(0);
+    mysql_mutex_unlock(&structure_guard_mutex);
+  }
+  else
+    m_unlocked_hits.fetch_add(1);
   query->increment_hits();
-  unlock();
+  mysql_rwlock_unlock(&shard->lock);
 
   /*
     Send cached result to client
@@ -2212,7 +2305,8 @@ def_week_frmt: %zu, in_trans: %d, autocommit: %d",
   DBUG_RETURN(1);				// Result sent to client
 
 err_unlock:
-  unlock();
+  mysql_rwlock_unlock(&shard->lock);
+err_miss:
   MYSQL_QUERY_CACHE_MISS(thd->query());
   /*
     query_plan_flags doesn't have to be changed here as it contains
@@ -2519,8 +2613,15 @@ void Query_cache::destroy()
     free_cache();
     unlock();
 
+    for (uint i= 0; i < QUERY_CACHE_SHARDS; i++)
+    {
+      my_hash_free(&shards[i].queries);
+      mysql_rwlock_destroy(&shards[i].lock);
+    }
     mysql_cond_destroy(&COND_cache_status_changed);
     mysql_mutex_destroy(&structure_guard_mutex);
+    queries_filter.free();
+    tables_filter.free();
     initialized = 0;
     DBUG_ASSERT(m_requests_in_progress == 0);
   }
@@ -2550,6 +2651,14 @@ void Query_cache::init()
   m_cache_lock_status= Query_cache::UNLOCKED;
   m_cache_status= Query_cache::OK;
   m_requests_in_progress= 0;
+  for (uint i= 0; i < QUERY_CACHE_SHARDS; i++)
+  {
+    mysql_rwlock_init(key_rwlock_query_cache_shard_lock, &shards[i].lock);
+    (void) my_hash_init(key_memory_Query_cache, &shards[i].queries,
+                        &my_charset_bin,
+                        def_query_hash_size / QUERY_CACHE_SHARDS, 0, 0,
+                        query_cache_query_get_key, 0, 0);
+  }
   initialized = 1;
   /*
     Using state_map from latin1 should be fine in all cases:
@@ -2585,6 +2694,17 @@ void Query_cache::init()
     free_cache();
     m_cache_status= DISABLED;
   }
+  else
+  {
+    /*
+      The filters are allocated separately from the cache memory, so that
+      they survive resize() and don't take space from small caches.
+      Failing to allocate them is not fatal, it only disables the unlocked
+      checks.
+    */
+    queries_filter.init();
+    tables_filter.init();
+  }
   DBUG_VOID_RETURN;
 }
 
@@ -2806,6 +2926,8 @@ void Query_cache::free_cache()
   DBUG_ASSERT(m_cache_lock_status == LOCKED_NO_WAIT ||
               m_cache_status == DISABLE_REQUEST);
 
+  shards_reset();
+
   /* Destroy locks */
   Query_cache_block *block= queries_blocks;
   if (block)
@@ -2836,6 +2958,8 @@ void Query_cache::free_cache()
   make_disabled();
   my_hash_free(&queries);
   my_hash_free(&tables);
+  queries_filter.clear();
+  tables_filter.clear();
   DBUG_VOID_RETURN;
 }
 
@@ -2861,6 +2985,7 @@ void Query_cache::flush_cache()
 {
   QC_DEBUG_SYNC("wait_in_query_cache_flush2");
 
+  shards_reset();
   my_hash_reset(&queries);
   while (queries_blocks != 0)
   {
@@ -2941,6 +3066,12 @@ void Query_cache::free_query_internal(Query_cache_block *query_block)
   queries_in_cache--;
 
   Query_cache_query *query= query_block->query();
+  {
+    size_t key_length;
+    uchar *key= query_cache_query_get_key((uchar*) query_block, &key_length,
+                                          0);
+    queries_filter.remove(&my_charset_bin, key, key_length);
+  }
 
   if (query->writer() != 0)
   {
@@ -3008,12 +3139,73 @@ void Query_cache::free_query(Query_cache_block *query_block)
 		      query_block,
 		      query_block->query()->length() ));
 
+  shard_delete(query_block);
   my_hash_delete(&queries,(uchar *) query_block);
   free_query_internal(query_block);
 
   DBUG_VOID_RETURN;
 }
 
+
+/**
+  Find the shard of the query with the given key.
+*/
+
+Query_cache_shard *Query_cache::get_shard(const uchar *key, size_t length)
+{
+  my_hash_value_type hash_value= my_hash_sort(&my_charset_bin, key, length);
+  /* The low bits select the bucket inside the hash of the shard */
+  return &shards[(hash_value >> 16) & (QUERY_CACHE_SHARDS - 1)];
+}
+
+
+/**
+  Add a query that was just inserted into 'queries' to its shard, so that
+  it becomes visible to cache hits.
+*/
+
+void Query_cache::shard_insert(Query_cache_block *query_block)
+{
+  size_t key_length;
+  uchar *key= query_cache_query_get_key((uchar*) query_block, &key_length, 0);
+  Query_cache_shard *shard= get_shard(key, key_length);
+  mysql_rwlock_wrlock(&shard->lock);
+  /* Failure only makes the query invisible to hits */
+  (void) my_hash_insert(&shard->queries, (uchar*) query_block);
+  mysql_rwlock_unlock(&shard->lock);
+}
+
+
+/**
+  Remove a query from its shard. After this no new hit can find it, and
+  hits which found it before have released the shard lock.
+*/
+
+void Query_cache::shard_delete(Query_cache_block *query_block)
+{
+  size_t key_length;
+  uchar *key= query_cache_query_get_key((uchar*) query_block, &key_length, 0);
+  Query_cache_shard *shard= get_shard(key, key_length);
+  mysql_rwlock_wrlock(&shard->lock);
+  my_hash_delete(&shard->queries, (uchar*) query_block);
+  mysql_rwlock_unlock(&shard->lock);
+}
+
+
+/**
+  Remove all queries from the shards, before they are freed all at once.
+*/
+
+void Query_cache::shards_reset()
+{
+  for (uint i= 0; i < QUERY_CACHE_SHARDS; i++)
+  {
+    mysql_rwlock_wrlock(&shards[i].lock);
+    my_hash_reset(&shards[i].queries);
+    mysql_rwlock_unlock(&shards[i].lock);
+  }
+}
+
 /*****************************************************************************
  Query data creation
 *****************************************************************************/
@@ -3301,8 +3493,30 @@ void Query_cache::invalidate_table(THD *thd, TABLE *table)
                    table->s->table_cache_key.length);
 }
 
+/**
+  Collation of the table keys in the 'tables' hash and its filter.
+  Must match the one given to my_hash_init() in init_cache().
+*/
+
+CHARSET_INFO *Query_cache::table_key_charset()
+{
+#ifndef FN_NO_CASE_SENSE
+  return &my_charset_bin;
+#else
+  return lower_case_table_names ? &my_charset_bin : files_charset_info;
+#endif
+}
+
 void Query_cache::invalidate_table(THD *thd, uchar * key, size_t key_length)
 {
+  /*
+    Most writes go to tables which have no cached queries. Don't queue up
+    on structure_guard_mutex for them; see Query_cache_filter on why the
+    unlocked check is safe.
+  */
+  if (!tables_filter.may_contain(table_key_charset(), key, key_length))
+    return;
+
   DEBUG_SYNC(thd, "wait_in_query_cache_invalidate1");
 
   /*
@@ -3570,13 +3784,16 @@ Query_cache::insert_table(THD *thd, size_t key_len, const char *key,
     */
     list_root->next= list_root->prev= list_root;
 
-    if (hash &&
-        my_hash_insert(&tables, (const uchar *) table_block))
+    if (hash)
     {
-      DBUG_PRINT("qcache", ("Can't insert table to hash"));
-      // write_block_data return locked block
-      free_memory_block(table_block);
-      DBUG_RETURN(0);
+      if (my_hash_insert(&tables, (const uchar *) table_block))
+      {
+        DBUG_PRINT("qcache", ("Can't insert table to hash"));
+        // write_block_data return locked block
+        free_memory_block(table_block);
+        DBUG_RETURN(0);
+      }
+      tables_filter.add(table_key_charset(), (uchar*) key, key_len);
     }
     char *db= header->db();
     header->table(db + db_length + 1);
@@ -3641,7 +3858,11 @@ void Query_cache::unlink_table(Query_cache_block_table *node)
                                &tables_blocks);
     Query_cache_table *header= table_block->table();
     if (header->is_hashed())
+    {
+      tables_filter.remove(table_key_charset(), (uchar*) header->db(),
+                           header->key_length());
       my_hash_delete(&tables,(uchar *) table_block);
+    }
     free_memory_block(table_block);
   }
   DBUG_VOID_RETURN;
@@ -4260,12 +4481,17 @@ void Query_cache::pack_cache()
 
   if (first_block)
   {
+    /* Keep hits away from the blocks while they move */
+    for (uint i= 0; i < QUERY_CACHE_SHARDS; i++)
+      mysql_rwlock_wrlock(&shards[i].lock);
     do
     {
       Query_cache_block *next=block->pnext;
       ok = move_by_type(&border, &before, &gap, block);
       block = next;
     } while (ok && block != first_block);
+    for (uint i= 0; i < QUERY_CACHE_SHARDS; i++)
+      mysql_rwlock_unlock(&shards[i].lock);
 
     if (border != 0)
     {
@@ -4393,6 +4619,11 @@ my_bool Query_cache::move_by_type(uchar **border,
     size_t key_length;
     key=query_cache_query_get_key((uchar*) block, &key_length, 0);
     my_hash_first(&queries, (uchar*) key, key_length, &record_idx);
+    /* The caller holds all shard locks */
+    Query_cache_shard *shard= get_shard(key, key_length);
+    HASH_SEARCH_STATE shard_record_idx;
+    uchar *shard_record= my_hash_first(&shard->queries, (uchar*) key,
+                                       key_length, &shard_record_idx);
     block->query()->unlock_n_destroy();
     block->destroy();
     // Move table of used tables
@@ -4461,6 +4692,8 @@ my_bool Query_cache::move_by_type(uchar **border,
     }
     /* Fix hash to point at moved block */
     my_hash_replace(&queries, &record_idx, (uchar*) new_block);
+    if (shard_record)
+      my_hash_replace(&shard->queries, &shard_record_idx, (uchar*) new_block);
     DBUG_PRINT("qcache", ("moved %zu bytes to %p, new gap at %p",
 			len, new_block, *border));
     break;
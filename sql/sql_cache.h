@@ -18,6 +18,8 @@
 
 #include "hash.h"
 #include "my_base.h"                            /* ha_rows */
+#include "my_atomic_wrapper.h"
+#include <atomic>
 
 class MY_LOCALE;
 struct TABLE_LIST;
@@ -62,6 +64,18 @@ typedef struct st_changed_table_list CHANGED_TABLE_LIST;
    of list of free blocks */
 #define QUERY_CACHE_MEM_BIN_TRY                 5
 
+/*
+  number of slots in the lock-free query and table presence filters
+  (see Query_cache_filter), must be a power of 2
+*/
+#define QUERY_CACHE_FILTER_SLOTS		(16*1024)
+
+/*
+  number of shards of the query hash that is searched by cache hits
+  (see Query_cache_shard), must be a power of 2
+*/
+#define QUERY_CACHE_SHARDS			16
+
 /* packing parameters */
 #define QUERY_CACHE_PACK_ITERATION		2
 #define QUERY_CACHE_PACK_LIMIT			(512*1024L)
@@ -159,7 +173,8 @@ struct Query_cache_query
   unsigned int last_pkt_nr;
   uint8 tbls_type;
   uint8 ready;
-  ulonglong hit_count;
+  /* Incremented by concurrent hits, which only share the query lock */
+  Atomic_relaxed<ulonglong> hit_count;
 
   Query_cache_query() = default;                      /* Remove gcc warning */
   inline void init_n_lock();
@@ -185,11 +200,12 @@ struct Query_cache_query
   */
   inline void set_results_ready()          { ready= 1; }
   inline bool is_results_ready()           { return ready; }
-  inline void increment_hits() { hit_count++; }
+  inline void increment_hits() { hit_count.fetch_add(1); }
   inline ulonglong hits() { return hit_count; }
   void lock_writing();
   void lock_reading();
   bool try_lock_writing();
+  bool try_lock_reading();
   void unlock_writing();
   void unlock_reading();
 };
@@ -264,6 +280,89 @@ extern "C"
 extern "C" void query_cache_invalidate_by_MyISAM_filename(const char* filename);
 
 
+/**
+  Lock-free counting filter over the keys of one of the query cache hashes.
+
+  Each slot counts the hashed keys which map to it. The counters are only
+  changed under structure_guard_mutex, at the same time the key is added to
+  or removed from the hash, but they may be read without any lock: a zero
+  slot proves that the key is not in the hash, so lookups of uncached
+  queries and invalidations of tables without cached queries can return
+  without queueing on structure_guard_mutex. A non zero slot only means that
+  the key may be present and the caller has to take the lock and search the
+  hash as usual.
+
+  The slots are updated and read with sequentially consistent operations, so
+  an unlocked reader that finds a zero slot is ordered before the locked
+  writer that adds the key, exactly as if it had taken the lock first.
+*/
+
+class Query_cache_filter
+{
+  std::atomic<uint32> *slots;
+
+  uint32 slot_no(CHARSET_INFO *cs, const uchar *key, size_t length) const
+  {
+    return (uint32) (my_hash_sort(cs, key, length) &
+                     (QUERY_CACHE_FILTER_SLOTS - 1));
+  }
+public:
+  Query_cache_filter() : slots(NULL) {}
+  /*
+    Without slots (not initialized or out of memory) every key may be
+    present, so the callers always fall back to the locked hash search.
+  */
+  bool init();
+  void free();
+  /* Only to be called when the filtered hash is empty */
+  void clear()
+  {
+    if (slots)
+      for (uint i= 0; i < QUERY_CACHE_FILTER_SLOTS; i++)
+        slots[i].store(0, std::memory_order_relaxed);
+  }
+  void add(CHARSET_INFO *cs, const uchar *key, size_t length)
+  {
+    if (slots)
+      slots[slot_no(cs, key, length)].fetch_add(1);
+  }
+  void remove(CHARSET_INFO *cs, const uchar *key, size_t length)
+  {
+    if (slots)
+    {
+      DBUG_ASSERT(slots[slot_no(cs, key, length)].load() > 0);
+      slots[slot_no(cs, key, length)].fetch_sub(1);
+    }
+  }
+  bool may_contain(CHARSET_INFO *cs, const uchar *key, size_t length) const
+  {
+    return !slots || slots[slot_no(cs, key, length)].load() != 0;
+  }
+};
+
+
+/**
+  One shard of the index of cached queries that is searched by cache hits.
+
+  Each query of the 'queries' hash is also in the hash of one shard, chosen
+  by the hash value of its key. The shards are changed under
+  structure_guard_mutex together with the 'queries' hash, holding the shard
+  lock in exclusive mode. A hit takes the lock of its shard in shared mode
+  only, and no other lock than that and the read lock of the query it
+  found, so that hits never queue on structure_guard_mutex.
+
+  While a hit holds the shard lock, the query and the tables it uses
+  cannot be freed or moved: freeing the query removes it from the shard
+  first, and pack_cache() locks all shards.
+*/
+
+struct Query_cache_shard
+{
+  mysql_rwlock_t lock;
+  HASH queries;
+};
+
+
 struct Query_cache_memory_bin
 {
   Query_cache_memory_bin() = default;                 /* Remove gcc warning */
@@ -346,6 +445,15 @@ class Query_cache
   Query_cache_memory_bin *bins;			// free block lists
   Query_cache_memory_bin_step *steps;		// bins spacing info
   HASH queries, tables;
+  /*
+    Presence filters of the 'queries' and 'tables' hashes, which may be
+    checked without structure_guard_mutex (see Query_cache_filter).
+  */
+  Query_cache_filter queries_filter, tables_filter;
+  /* Copies of the 'queries' hash that are searched by cache hits */
+  Query_cache_shard shards[QUERY_CACHE_SHARDS];
+  /* Hits not yet added to 'hits', which changes under the mutex only */
+  Atomic_relaxed<size_t> m_unlocked_hits;
   /* options */
   size_t min_allocation_unit, min_result_data_size;
   uint def_query_hash_size, def_table_hash_size;
@@ -376,6 +484,7 @@ class Query_cache
   void invalidate_table(THD *thd, uchar *key, size_t  key_length);
   void invalidate_table(THD *thd, Query_cache_block *table_block);
   void invalidate_query_block_list(Query_cache_block_table *list_root);
+  static CHARSET_INFO *table_key_charset();
 
   TABLE_COUNTER_TYPE
     register_tables_from_list(THD *thd, TABLE_LIST *tables_used,
@@ -399,6 +508,10 @@ class Query_cache
 		       size_t *gap, Query_cache_block *i);
   uint find_bin(size_t size);
   void move_to_query_list_end(Query_cache_block *block);
+  Query_cache_shard *get_shard(const uchar *key, size_t length);
+  void shard_insert(Query_cache_block *query_block);
+  void shard_delete(Query_cache_block *query_block);
+  void shards_reset();
   void insert_into_free_memory_sorted_list(Query_cache_block *new_block,
 					   Query_cache_block **list);
   void pack_cache();
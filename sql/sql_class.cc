@@ -813,6 +813,7 @@ THD::THD(my_thread_id id, bool is_wsrep_applier)
   net.vio=0;
   net.buff= 0;
   net.reading_or_writing= 0;
+  net_compress_stream= 0;
   client_capabilities= 0;                       // minimalistic client
   system_thread= NON_SYSTEM_THREAD;
   cleanup_done= free_connection_done= abort_on_warning= got_warning= 0;
@@ -1665,6 +1666,10 @@ void THD::free_connection()
     vio_delete(net.vio);
   net.vio= nullptr;
   net_end(&net);
+#ifdef HAVE_COMPRESS
+  my_compress_stream_free(net_compress_stream);
+  net_compress_stream= NULL;
+#endif
   delete(rgi_fake);
   rgi_fake= NULL;
   delete(rli_fake);
@@ -1843,6 +1848,10 @@ void add_to_status(STATUS_VAR *to_var, STATUS_VAR *from_var)
   /* Handle the not ulong variables. See end of system_status_var */
   to_var->bytes_received+=      from_var->bytes_received;
   to_var->bytes_sent+=          from_var->bytes_sent;
+  to_var->compressed_bytes_received+= from_var->compressed_bytes_received;
+  to_var->uncompressed_bytes_received+= from_var->uncompressed_bytes_received;
+  to_var->compressed_bytes_sent+= from_var->compressed_bytes_sent;
+  to_var->uncompressed_bytes_sent+= from_var->uncompressed_bytes_sent;
   to_var->rows_read+=           from_var->rows_read;
   to_var->rows_sent+=           from_var->rows_sent;
   to_var->rows_tmp_read+=       from_var->rows_tmp_read;
@@ -1896,6 +1905,15 @@ void add_diff_to_status(STATUS_VAR *to_var, STATUS_VAR *from_var,
   to_var->bytes_received+=       from_var->bytes_received -
                                  dec_var->bytes_received;
   to_var->bytes_sent+=           from_var->bytes_sent - dec_var->bytes_sent;
+  to_var->compressed_bytes_received+= from_var->compressed_bytes_received -
+                                      dec_var->compressed_bytes_received;
+  to_var->uncompressed_bytes_received+=
+    from_var->uncompressed_bytes_received -
+    dec_var->uncompressed_bytes_received;
+  to_var->compressed_bytes_sent+= from_var->compressed_bytes_sent -
+                                  dec_var->compressed_bytes_sent;
+  to_var->uncompressed_bytes_sent+= from_var->uncompressed_bytes_sent -
+                                    dec_var->uncompressed_bytes_sent;
   to_var->rows_read+=            from_var->rows_read - dec_var->rows_read;
   to_var->rows_sent+=            from_var->rows_sent - dec_var->rows_sent;
   to_var->rows_tmp_read+=        from_var->rows_tmp_read - dec_var->rows_tmp_read;
@@ -842,6 +842,10 @@ typedef struct system_variables
   uint column_compression_threshold;
   uint column_compression_zlib_level;
   uint in_subquery_conversion_threshold;
+  uint sort_merge_threads;
+  uint load_data_parser_threads;
+  uint net_compression_level;
+  uint join_buff_spill_partitions;
   int max_user_connections;
 
   /**
@@ -1043,6 +1047,9 @@ typedef struct system_status_var
   */
   ulonglong bytes_received;
   ulonglong bytes_sent;
+  /* Packets of the compressed protocol, before and after compression */
+  ulonglong compressed_bytes_received, uncompressed_bytes_received;
+  ulonglong compressed_bytes_sent, uncompressed_bytes_sent;
   ulonglong rows_read;
   ulonglong rows_sent;
   ulonglong rows_tmp_read;
@@ -2909,6 +2916,8 @@ class THD: public THD_count, /* this must be first */
   NET	  net;				// client connection descriptor
   /** Aditional network instrumentation for the server only. */
   NET_SERVER m_net_server_extension;
+  /** zlib state for the compressed protocol, see net_compress() */
+  MY_COMPRESS_STREAM *net_compress_stream;
   scheduler_functions *scheduler;       // Scheduler for this connection
   Protocol *protocol;			// Current protocol
   Protocol_text   protocol_text;	// Normal protocol
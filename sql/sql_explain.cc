@@ -2207,6 +2207,14 @@ void Explain_table_access::print_explain_json(Explain_query *query,
       else
         writer->add_null();
 
+      if (jbuf_spill_tracker.has_spills())
+      {
+        writer->add_member("r_spills").add_ll(jbuf_spill_tracker.r_spills);
+        writer->add_member("r_spill_partitions").
+          add_ll(jbuf_spill_tracker.r_partitions);
+        writer->add_member("r_spill_bytes").
+          add_ull(jbuf_spill_tracker.r_bytes);
+      }
     }
   }
 
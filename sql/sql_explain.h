@@ -921,6 +921,9 @@ class Explain_table_access : public Sql_alloc
   /* When using join buffer: Track the number of incoming record combinations */
   Counter_tracker jbuf_loops_tracker;
 
+  /* When using a hashed join buffer: track spilling it to temporary files */
+  Spill_tracker jbuf_spill_tracker;
+
   Explain_rowid_filter *rowid_filter;
 
   int print_explain(select_result_sink *output, uint8 explain_flags, 
@@ -35,6 +35,9 @@
 
 #define NO_MORE_RECORDS_IN_BUFFER  (uint)(-1)
 
+/* Size of the buffers of the temporary files of a spilled join cache */
+#define JOIN_CACHE_SPILL_BUFF_SIZE (4*IO_SIZE)
+
 static void save_or_restore_used_tabs(JOIN_TAB *join_tab, bool save);
 
 /*****************************************************************************
@@ -2846,7 +2849,7 @@ int JOIN_CACHE_HASHED::init(bool for_explain)
   ref_key_info= join_tab->get_keyinfo_by_key_no(join_tab->ref.key);
   ref_used_key_parts= join_tab->ref.key_parts;
 
-  hash_func= &JOIN_CACHE_HASHED::get_hash_idx_simple;
+  hash_func= &JOIN_CACHE_HASHED::get_hash_simple;
   hash_cmp_func= &JOIN_CACHE_HASHED::equal_keys_simple;
 
   KEY_PART_INFO *key_part= ref_key_info->key_part;
@@ -2855,7 +2858,7 @@ int JOIN_CACHE_HASHED::init(bool for_explain)
   {
     if (!key_part->field->eq_cmp_as_binary())
     {
-      hash_func= &JOIN_CACHE_HASHED::get_hash_idx_complex;
+      hash_func= &JOIN_CACHE_HASHED::get_hash_complex;
       hash_cmp_func= &JOIN_CACHE_HASHED::equal_keys_complex;
       break;
     }
@@ -2886,9 +2889,8 @@ int JOIN_CACHE_HASHED::init(bool for_explain)
     init_hash_table()
 
   DESCRIPTION
-    The function estimates the number of hash table entries in the hash
-    table to be used and initializes this hash table within the join buffer
-    space.
+    The function estimates the number of slots in the hash table to be used
+    and initializes this hash table within the join buffer space.
 
   RETURN VALUE
     Currently the function always returns 0;
@@ -2908,12 +2910,12 @@ int JOIN_CACHE_HASHED::init_hash_table()
        size_of_key_ofs+= 2)
   {    
     key_entry_length= get_size_of_rec_offset() + // key chain header
-                      size_of_key_ofs +          // reference to the next key 
                       (use_emb_key ?  get_size_of_rec_offset() : key_length);
 
+    /* A slot of the hash table takes size_of_key_ofs+1 bytes */
     size_t space_per_rec= avg_record_length +
                          avg_aux_buffer_incr +
-                         key_entry_length+size_of_key_ofs;
+                         key_entry_length+size_of_key_ofs+1;
     size_t n= buff_size / space_per_rec;
 
     /*
@@ -2921,18 +2923,27 @@ int JOIN_CACHE_HASHED::init_hash_table()
             the number of records in in the join buffer.
     */
     size_t max_n= buff_size / (pack_length-length+
-                             key_entry_length+size_of_key_ofs);
+                             key_entry_length+size_of_key_ofs+1);
 
     hash_entries= (uint) (n / 0.7);
-    set_if_bigger(hash_entries, 1);
+    set_if_bigger(hash_entries, JOIN_CACHE_HASH_GROUP);
     
     if (offset_size((uint)(max_n*key_entry_length)) <=
         size_of_key_ofs)
       break;
   }
    
-  /* Initialize the hash table */ 
-  hash_table= buff + (buff_size-hash_entries*size_of_key_ofs);
+  max_key_entries= hash_entries - hash_entries / 8;
+
+  /*
+    Initialize the hash table. The fingerprints of the first
+    JOIN_CACHE_HASH_GROUP-1 slots are repeated after the fingerprint of
+    the last slot, so that a group of fingerprints can always be read
+    with one load, see key_search().
+  */ 
+  hash_table= buff + (buff_size - hash_entries*(size_of_key_ofs+1) -
+                      (JOIN_CACHE_HASH_GROUP-1));
+  hash_slots= hash_table + hash_entries + JOIN_CACHE_HASH_GROUP-1;
   cleanup_hash_table();
   curr_key_entry= hash_table;
 
@@ -2979,7 +2990,7 @@ int JOIN_CACHE_HASHED::realloc_buffer()
   
   DESCRIPTION
     The function returns the size of the space occupied by one key entry
-    and one hash table entry.
+    and one hash table slot.
 
   RETURN VALUE
     maximum size of the additional space per record that is used to store
@@ -2991,14 +3002,13 @@ uint JOIN_CACHE_HASHED::get_max_key_addon_space_per_record()
   ulong len;
   TABLE_REF *ref= &join_tab->ref;
   /* 
-    The total number of hash entries in the hash tables is bounded by
+    The total number of slots in the hash tables is bounded by
     ceiling(N/0.7) where N is the maximum number of records in the buffer.
     That's why the multiplier 2 is used in the formula below. 
   */ 
   len= (use_emb_key ?  get_size_of_rec_offset() : ref->key_length) +
-        size_of_rec_ofs +    // size of the key chain header
-        size_of_rec_ofs +    // >= size of the reference to the next key 
-        2*size_of_rec_ofs;   // >= 2*( size of hash table entry)
+        size_of_rec_ofs +      // size of the key chain header
+        2*(size_of_rec_ofs+1); // >= 2*(size of hash table slot+fingerprint)
   return len; 
 }    
 
@@ -3050,6 +3060,9 @@ void JOIN_CACHE_HASHED::reset(bool for_writing)
     the record from the partial join.
     If the match flag field of a record contains MATCH_IMPOSSIBLE the key is
     not created for this record. 
+    When the number of key entries reaches max_key_entries the record
+    is the last one to be put into the buffer, otherwise the open addressing
+    hash table could become too full.
     
   RETURN VALUE
     TRUE    if it has been decided that it should be the last record
@@ -3096,28 +3109,27 @@ bool JOIN_CACHE_HASHED::put_record()
       key, 'key_ref' points to a flatten representation of the st_key_entry 
       structure that contains the key and the head of the record chain.
     */
-    last_next_ref_ptr= get_next_rec_ref(key_ref_ptr+get_size_of_key_offset());
+    last_next_ref_ptr= get_next_rec_ref(key_ref_ptr);
     /* rec->next_rec= key_entry->last_rec->next_rec */
     memcpy(next_ref_ptr, last_next_ref_ptr, get_size_of_rec_offset());
     /* key_entry->last_rec->next_rec= rec */ 
     store_next_rec_ref(last_next_ref_ptr, next_ref_ptr);
     /* key_entry->last_rec= rec */
-    store_next_rec_ref(key_ref_ptr+get_size_of_key_offset(), next_ref_ptr);
+    store_next_rec_ref(key_ref_ptr, next_ref_ptr);
   }
   else
   {
     /* 
       The key is not found in the hash table.
-      Put the key into the join buffer linking it with the keys for the
-      corresponding hash entry. Create a circular list with one element
-      referencing the record and attach the list to the key in the buffer.
+      Put the key into the join buffer and refer to it from the free slot
+      of the hash table found by key_search(). Create a circular list with
+      one element referencing the record and attach the list to the key in
+      the buffer.
     */
     uchar *cp= last_key_entry;
-    cp-= get_size_of_rec_offset()+get_size_of_key_offset();
-    store_next_key_ref(key_ref_ptr, cp);
-    store_null_key_ref(cp);
+    cp-= get_size_of_rec_offset();
     store_next_rec_ref(next_ref_ptr, next_ref_ptr);
-    store_next_rec_ref(cp+get_size_of_key_offset(), next_ref_ptr);
+    store_next_rec_ref(cp, next_ref_ptr);
     if (use_emb_key)
     {
       cp-= get_size_of_rec_offset();
@@ -3130,8 +3142,10 @@ bool JOIN_CACHE_HASHED::put_record()
     }
     last_key_entry= cp;
     DBUG_ASSERT(last_key_entry >= end_pos);
+    add_key_to_hash_table(key_ref_ptr, cp);
     /* Increment the counter of key_entries in the hash table */ 
-    key_entries++;
+    if (++key_entries >= max_key_entries)
+      is_full= TRUE;
   }  
   return is_full;
 }
@@ -3225,18 +3239,22 @@ bool JOIN_CACHE_HASHED::skip_if_not_needed_match()
     key_search()
       key             pointer to the key value
       key_len         key value length
-      key_ref_ptr OUT position of the reference to the next key from 
-                      the hash element for the found key , or
-                      a position where the reference to the the hash 
-                      element for the key is to be added in the
+      key_ref_ptr OUT position of the reference to the last record of
+                      the chain attached to the found key, or the position
+                      of the free slot of the hash table where the reference
+                      to the key entry for the key is to be added in the
                       case when the key has not been found
       
   DESCRIPTION
     The function looks for a key in the hash table of the join buffer.
-    If the key is found the functionreturns the position of the reference
-    to the next key from  to the hash element for the given key. 
-    Otherwise the function returns the position where the reference to the
-    newly created hash element for the given key is to be added.  
+    The slots are probed linearly starting from the slot the hash value of
+    the key maps to. The fingerprints of JOIN_CACHE_HASH_GROUP consecutive
+    slots are read as one 64-bit word and compared with the fingerprint of
+    the key all at once. Only the key entries whose fingerprints match are
+    compared with the key. The search stops at the first free slot, as the
+    keys are never removed from the hash table.
+    The fingerprint of the key is saved in search_fingerprint to be used
+    by add_key_to_hash_table().
 
   RETURN VALUE
     TRUE    the key is found in the hash table
@@ -3246,46 +3264,106 @@ bool JOIN_CACHE_HASHED::skip_if_not_needed_match()
 bool JOIN_CACHE_HASHED::key_search(uchar *key, uint key_len,
                                    uchar **key_ref_ptr) 
 {
-  bool is_found= FALSE;
-  uint idx= (this->*hash_func)(key, key_length);
-  uchar *ref_ptr= hash_table+size_of_key_ofs*idx;
-  while (!is_null_key_ref(ref_ptr))
+  const ulonglong lows= 0x0101010101010101ULL;
+  const ulonglong highs= 0x8080808080808080ULL;
+  ulong hash= (this->*hash_func)(key, key_length);
+  uint idx= (uint) (hash % hash_entries);
+  /* The high bit is set in the fingerprint of any used slot */
+  uchar fingerprint= (uchar) ((hash / hash_entries) | 0x80);
+  ulonglong pattern= lows * fingerprint;
+
+  search_fingerprint= fingerprint;
+  for (uint probed= 0; probed < hash_entries; probed+= JOIN_CACHE_HASH_GROUP)
   {
-    uchar *next_key;
-    ref_ptr= get_next_key_ref(ref_ptr);
-    next_key= use_emb_key ? get_emb_key(ref_ptr-get_size_of_rec_offset()) :
-                            ref_ptr-key_length;
+    ulonglong group= uint8korr(hash_table+idx);
+    ulonglong free_slots= ~group & highs;
+    ulonglong diff= group ^ pattern;
+    /*
+      A high bit is set for every byte of diff that is zero, and possibly
+      for some bytes following such a byte. The latter ones are filtered
+      out by the check of the fingerprint below.
+    */
+    ulonglong matches= (diff - lows) & ~diff & highs;
 
-    if ((this->*hash_cmp_func)(next_key, key, key_len))
+    for (uint i= 0; i < JOIN_CACHE_HASH_GROUP; i++, matches>>= 8,
+                                               free_slots>>= 8)
     {
-      is_found= TRUE;
-      break;
+      uint slot= idx + i;
+      if (slot >= hash_entries)
+        slot-= hash_entries;
+      if (free_slots & 0x80)
+      {
+        *key_ref_ptr= hash_slots+size_of_key_ofs*slot;
+        return FALSE;
+      }
+      if ((matches & 0x80) && hash_table[slot] == fingerprint)
+      {
+        uchar *key_entry= get_next_key_ref(hash_slots+size_of_key_ofs*slot);
+        uchar *next_key= use_emb_key ? get_emb_key(key_entry) : key_entry;
+        if ((this->*hash_cmp_func)(next_key, key, key_len))
+        {
+          *key_ref_ptr= key_entry+key_entry_length-get_size_of_rec_offset();
+          return TRUE;
+        }
+      }
     }
+    if ((idx+= JOIN_CACHE_HASH_GROUP) >= hash_entries)
+      idx-= hash_entries;
   }
-  *key_ref_ptr= ref_ptr;
-  return is_found;
+  /* Not reached when adding keys, as max_key_entries < hash_entries */
+  *key_ref_ptr= 0;
+  return FALSE;
 } 
 
 
+/*
+  Add a key entry into the hash table of the join buffer
+
+  SYNOPSIS
+    add_key_to_hash_table()
+      slot_ptr        free slot of the hash table returned by key_search()
+      key_entry       the key entry to be referred to from the slot
+
+  DESCRIPTION
+    The function stores the reference to the key entry in the slot and
+    the fingerprint of the key saved by the last call of key_search() in
+    the fingerprint array of the hash table. 
+
+  RETURN VALUE
+    none
+*/
+
+void JOIN_CACHE_HASHED::add_key_to_hash_table(uchar *slot_ptr,
+                                              uchar *key_entry)
+{
+  uint slot= (uint) ((slot_ptr-hash_slots)/size_of_key_ofs);
+  DBUG_ASSERT(slot < hash_entries && !hash_table[slot]);
+  store_next_key_ref(slot_ptr, key_entry);
+  hash_table[slot]= search_fingerprint;
+  if (slot < JOIN_CACHE_HASH_GROUP-1)
+    hash_table[hash_entries+slot]= search_fingerprint;
+}
+
+
 /* 
   Hash function that considers a key in the hash table as byte array
 
   SYNOPSIS
-    get_hash_idx_simple()
+    get_hash_simple()
       key             pointer to the key value
       key_len         key value length
       
   DESCRIPTION
-    The function calculates an index of the hash entry in the hash table
-    of the join buffer for the given key. It considers the key just as
-    a sequence of bytes of the length key_len.
+    The function calculates the hash value for the given key that is used
+    to find its slot in the hash table of the join buffer. It considers the
+    key just as a sequence of bytes of the length key_len.
 
   RETURN VALUE
-    the calculated index of the hash entry for the given key  
+    the calculated hash value for the given key  
 */
 
 inline
-uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
+ulong JOIN_CACHE_HASHED::get_hash_simple(uchar* key, uint key_len)
 {
   ulong nr= 1;
   ulong nr2= 4;
@@ -3296,7 +3374,7 @@ uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
     nr^= (ulong) ((((uint) nr & 63)+nr2)*((uint) *pos))+ (nr << 8);
     nr2+= 3;
   }
-  return nr % hash_entries;
+  return nr;
 }
 
 
@@ -3304,14 +3382,15 @@ uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
   Hash function that takes into account collations of the components of the key  
 
   SYNOPSIS
-    get_hash_idx_complex()
+    get_hash_complex()
       key             pointer to the key value
       key_len         key value length
       
   DESCRIPTION
-    The function calculates an index of the hash entry in the hash table
-    of the join buffer for the given key. It takes into account that the
-    components of the key may be of a varchar type with different collations.
+    The function calculates the hash value for the given key that is used
+    to find its slot in the hash table of the join buffer. It takes into
+    account that the components of the key may be of a varchar type with
+    different collations.
     The function guarantees that the same hash value for any two equal
     keys that may differ as byte sequences.
     The function takes the info about the components of the key, their
@@ -3320,14 +3399,13 @@ uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
     operation.
 
   RETURN VALUE
-    the calculated index of the hash entry for the given key  
+    the calculated hash value for the given key  
 */
 
 inline
-uint JOIN_CACHE_HASHED::get_hash_idx_complex(uchar *key, uint key_len)
+ulong JOIN_CACHE_HASHED::get_hash_complex(uchar *key, uint key_len)
 {
-  return 
-    (uint) (key_hashnr(ref_key_info, ref_used_key_parts, key) % hash_entries);
+  return key_hashnr(ref_key_info, ref_used_key_parts, key);
 }
 
 
@@ -3809,7 +3887,7 @@ uchar *JOIN_CACHE_BNLH::get_matching_chain_by_join_key()
   /* Look for this key in the join buffer */
   if (!key_search(key_buff, key_length, &key_ref_ptr))
     return 0;
-  return key_ref_ptr+get_size_of_key_offset();
+  return key_ref_ptr;
 }
 
 
@@ -3959,13 +4037,491 @@ int JOIN_CACHE_BNLH::init(bool for_explain)
 {
   DBUG_ENTER("JOIN_CACHE_BNLH::init");
 
-  if (!(join_tab_scan= new JOIN_TAB_SCAN(join, join_tab)))
+  if (!(join_tab_scan= new JOIN_TAB_SCAN(join, join_tab)) ||
+      !(spill_scan= new JOIN_TAB_SCAN_SPILL(join, join_tab)))
     DBUG_RETURN(1);
 
   DBUG_RETURN(JOIN_CACHE_HASHED::init(for_explain));
 }
 
 
+/*
+  Check whether the records of the BNLH join cache can be spilled
+
+  SYNOPSIS
+    spill_allowed()
+
+  DESCRIPTION
+    The function checks whether the records of the cache can be spilled
+    into partitions when the join buffer gets full. This is not possible
+    if:
+    - spilling is disabled by join_buffer_spill_partitions=0,
+    - the records refer to the records of a previous join cache,
+    - blob values are used, as only the images of record buffers are saved,
+    - the rowid of join_tab is needed, as the position of the handler is
+      lost when the rows of join_tab are read back from a temporary file,
+    - the statement is a multi-table update or delete that needs the
+      positions of the rows of the joined tables.
+    The function also calculates the length of a spilled record.
+
+  RETURN VALUE
+    TRUE    the records can be spilled
+    FALSE   otherwise
+*/
+
+bool JOIN_CACHE_BNLH::spill_allowed()
+{
+  THD *thd= join->thd;
+  if (!thd->variables.join_buff_spill_partitions || prev_cache || blobs ||
+      join_tab->table->s->blob_fields || join_tab->keep_current_rowid ||
+      join_tab->use_quick == 2 ||
+      thd->lex->sql_command == SQLCOM_UPDATE_MULTI ||
+      thd->lex->sql_command == SQLCOM_DELETE_MULTI)
+    return FALSE;
+
+  spill_rec_length= 0;
+  for (CACHE_FIELD *copy= field_descr; copy < field_descr+fields; copy++)
+  {
+    if (copy->type == CACHE_ROWID && !copy->length)
+      return FALSE;
+    spill_rec_length+= copy->length;
+  }
+  return TRUE;
+}
+
+
+/*
+  Get the spill partition for a join key
+
+  SYNOPSIS
+    get_spill_partition()
+      key   the join key built either for a partial join record or
+            for a row of join_tab
+
+  DESCRIPTION
+    The function calculates the hash value of the key with the hash function
+    of the cache, so equal keys always get into the same partition. The value
+    is mixed before taking the remainder, otherwise the partition would
+    correlate with the slot of the key in the hash table of the join buffer.
+
+  RETURN VALUE
+    the number of the partition for the key
+*/
+
+uint JOIN_CACHE_BNLH::get_spill_partition(uchar *key)
+{
+  ulonglong hash= (this->*hash_func)(key, key_length);
+  return (uint) (((hash * 0x9E3779B97F4A7C15ULL) >> 32) % spill_parts);
+}
+
+
+/*
+  Save the fields of the current partial join record into a spilled record
+
+  SYNOPSIS
+    pack_spill_record()
+      rec   the buffer of spill_rec_length bytes to save the record into
+
+  DESCRIPTION
+    The function copies the images of all flag and data fields of the cache
+    from the record buffers. Unlike the records in the join buffer, the
+    spilled records have fixed length and are never stripped.
+*/
+
+void JOIN_CACHE_BNLH::pack_spill_record(uchar *rec)
+{
+  for (CACHE_FIELD *copy= field_descr; copy < field_descr+fields; copy++)
+  {
+    if (copy->str)
+      memcpy(rec, copy->str, copy->length);
+    rec+= copy->length;
+  }
+}
+
+
+/*
+  Restore the fields of a spilled partial join record into the record buffers
+*/
+
+void JOIN_CACHE_BNLH::unpack_spill_record(uchar *rec)
+{
+  for (CACHE_FIELD *copy= field_descr; copy < field_descr+fields; copy++)
+  {
+    if (copy->str)
+      memcpy(copy->str, rec, copy->length);
+    rec+= copy->length;
+  }
+}
+
+
+/*
+  Write the current partial join record into its spill partition
+
+  SYNOPSIS
+    spill_record()
+
+  DESCRIPTION
+    The function builds the join key for the partial join record from the
+    record buffers and writes the record into the partition for this key.
+    The image of the record is kept after the read buffer spill_rec, so that
+    the last record put into the cache can be restored when the spilled
+    records have been joined.
+
+  RETURN VALUE
+    FALSE   the record has been written
+    TRUE    otherwise
+*/
+
+bool JOIN_CACHE_BNLH::spill_record()
+{
+  TABLE_REF *ref= &join_tab->ref;
+  uchar *last_rec= spill_rec+spill_rec_length;
+  Spill_partition *part;
+
+  cp_buffer_from_ref(join->thd, join_tab->table, ref);
+  part= spill_part+get_spill_partition(ref->key_buff);
+  pack_spill_record(last_rec);
+  if (my_b_write(&part->outer, last_rec, spill_rec_length))
+    return TRUE;
+  part->records++;
+  join_tab->jbuf_spill_tracker->r_bytes+= spill_rec_length;
+  return FALSE;
+}
+
+
+/*
+  Start spilling the records of the BNLH join cache into partitions
+
+  SYNOPSIS
+    start_spill()
+
+  DESCRIPTION
+    The function is called when the join buffer has become full. It creates
+    the spill partitions and moves all records from the join buffer into
+    them. The number of partitions is chosen so that each of them is expected
+    to fit into the join buffer, taking into account the estimated number of
+    partial join records. It is limited by join_buffer_spill_partitions.
+    After this all next records are written directly into their partitions.
+
+  RETURN VALUE
+    FALSE   the records have been spilled
+    TRUE    an error occurred
+*/
+
+bool JOIN_CACHE_BNLH::start_spill()
+{
+  THD *thd= join->thd;
+  double refills=
+    ceil((join_tab-1)->get_partial_join_cardinality() / (double) records);
+  uint parts;
+  DBUG_ENTER("JOIN_CACHE_BNLH::start_spill");
+
+  /* Leave room for an underestimated cardinality and for a skew of keys */
+  set_if_bigger(refills, 1.0);
+  parts= (uint) MY_MIN(refills * 1.5 + 1,
+                       (double) thd->variables.join_buff_spill_partitions);
+  DBUG_PRINT("info", ("records: %zu  partitions: %u", records, parts));
+
+  if (!(spill_rec= (uchar*) my_malloc(key_memory_JOIN_CACHE,
+                                      2*spill_rec_length+1, MYF(MY_WME))) ||
+      !(spill_part= (Spill_partition*)
+        my_malloc(key_memory_JOIN_CACHE, parts*sizeof(Spill_partition),
+                  MYF(MY_WME | MY_ZEROFILL))))
+    goto err;
+  /* The record in the record buffers is the last one put into the cache */
+  pack_spill_record(spill_rec+spill_rec_length);
+
+  spill_parts= parts;
+  for (uint i= 0; i < parts; i++)
+  {
+    if (open_cached_file(&spill_part[i].outer, mysql_tmpdir, TEMP_PREFIX,
+                         JOIN_CACHE_SPILL_BUFF_SIZE, MYF(MY_WME)) ||
+        open_cached_file(&spill_part[i].inner, mysql_tmpdir, TEMP_PREFIX,
+                         JOIN_CACHE_SPILL_BUFF_SIZE, MYF(MY_WME)))
+      goto err;
+  }
+  join_tab->jbuf_spill_tracker->r_spills++;
+  join_tab->jbuf_spill_tracker->r_partitions+= parts;
+
+  reset(FALSE);
+  for (size_t cnt= records; cnt; cnt--)
+  {
+    get_record();
+    if (spill_record())
+      goto err;
+  }
+  reset(TRUE);
+  DBUG_RETURN(FALSE);
+
+err:
+  spill_error= TRUE;
+  DBUG_RETURN(TRUE);
+}
+
+
+/*
+  Remove the spill partitions of the BNLH join cache
+*/
+
+void JOIN_CACHE_BNLH::free_spill()
+{
+  if (spill_part)
+  {
+    for (uint i= 0; i < spill_parts; i++)
+    {
+      close_cached_file(&spill_part[i].outer);
+      close_cached_file(&spill_part[i].inner);
+    }
+    my_free(spill_part);
+    spill_part= 0;
+  }
+  my_free(spill_rec);
+  spill_rec= 0;
+  spill_parts= 0;
+  spill_error= FALSE;
+}
+
+
+/*
+  Distribute the rows of join_tab over the spill partitions
+
+  SYNOPSIS
+    spill_join_tab_rows()
+
+  DESCRIPTION
+    The function scans join_tab once and writes the image of each row that
+    satisfies the condition pushed to the table into the spill partition
+    for the join key built from the row. The rows whose partitions have not
+    got any partial join records are skipped as they cannot match.
+
+  RETURN VALUE
+    return one of enum_nested_loop_state
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::spill_join_tab_rows()
+{
+  int error;
+  enum_nested_loop_state rc= NESTED_LOOP_OK;
+  TABLE *table= join_tab->table;
+  TABLE_REF *ref= &join_tab->ref;
+  KEY *keyinfo= join_tab->get_keyinfo_by_key_no(ref->key);
+  DBUG_ENTER("JOIN_CACHE_BNLH::spill_join_tab_rows");
+
+  table->null_row= 0;
+  if ((rc= join_tab_execution_startup(join_tab)) < 0)
+    DBUG_RETURN(rc);
+
+  if (join_tab->need_to_build_rowid_filter &&
+      join_tab->build_range_rowid_filter())
+    DBUG_RETURN(NESTED_LOOP_ERROR);
+
+  if (unlikely((error= join_tab_scan->open())))
+    goto finish;
+
+  while (!(error= join_tab_scan->next()))
+  {
+    Spill_partition *part;
+    if (unlikely(join->thd->check_killed()))
+    {
+      rc= NESTED_LOOP_KILLED;
+      break;
+    }
+    key_copy(key_buff, table->record[0], keyinfo, key_length, TRUE);
+    part= spill_part+get_spill_partition(key_buff);
+    if (!part->records)
+      continue;
+    if (my_b_write(&part->inner, table->record[0], table->s->reclength))
+    {
+      rc= NESTED_LOOP_ERROR;
+      break;
+    }
+    join_tab->jbuf_spill_tracker->r_bytes+= table->s->reclength;
+  }
+
+finish:
+  if (error > 0)
+    rc= NESTED_LOOP_ERROR;
+  join_tab_scan->close();
+  DBUG_RETURN(rc);
+}
+
+
+/*
+  Join the spilled records with the rows of join_tab partition by partition
+
+  SYNOPSIS
+    join_spilled_records()
+
+  DESCRIPTION
+    The function distributes the rows of join_tab over the spill partitions.
+    Then for each partition it reads the spilled partial join records back
+    into the join buffer and joins them by JOIN_CACHE::join_records with the
+    rows of join_tab saved for the partition, which are iterated over by
+    spill_scan instead of a scan of the table. If the records of a partition
+    do not fit into the join buffer the saved rows are read once per refill.
+    Finally the last record put into the cache is restored into the record
+    buffers and the partitions are removed.
+
+  RETURN VALUE
+    return one of enum_nested_loop_state
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::join_spilled_records()
+{
+  enum_nested_loop_state rc= NESTED_LOOP_ERROR;
+  JOIN_TAB_SCAN *save_join_tab_scan= join_tab_scan;
+  Spill_partition *part, *part_end= spill_part+spill_parts;
+  DBUG_ENTER("JOIN_CACHE_BNLH::join_spilled_records");
+
+  if (spill_error || (rc= spill_join_tab_rows()) != NESTED_LOOP_OK)
+    goto finish;
+
+  join_tab_scan= spill_scan;
+  for (part= spill_part; part < part_end; part++)
+  {
+    ha_rows cnt= part->records;
+    if (!cnt)
+      continue;
+    if (reinit_io_cache(&part->outer, READ_CACHE, 0L, 0, 0))
+    {
+      rc= NESTED_LOOP_ERROR;
+      goto finish;
+    }
+    spill_scan->file= &part->inner;
+    for ( ; cnt; cnt--)
+    {
+      if (my_b_read(&part->outer, spill_rec, spill_rec_length))
+      {
+        rc= NESTED_LOOP_ERROR;
+        goto finish;
+      }
+      unpack_spill_record(spill_rec);
+      if (JOIN_CACHE_HASHED::put_record() || cnt == 1)
+      {
+        rc= JOIN_CACHE::join_records(FALSE);
+        if (rc != NESTED_LOOP_OK && rc != NESTED_LOOP_NO_MORE_ROWS)
+          goto finish;
+        rc= NESTED_LOOP_OK;
+      }
+    }
+  }
+
+finish:
+  join_tab_scan= save_join_tab_scan;
+  if (spill_rec)
+    unpack_spill_record(spill_rec+spill_rec_length);
+  reset(TRUE);
+  free_spill();
+  DBUG_RETURN(rc);
+}
+
+
+/*
+  Add a record into the buffer of the BNLH join cache
+
+  SYNOPSIS
+    put_record()
+
+  DESCRIPTION
+    This implementation of the virtual function put_record writes the record
+    into the join buffer as JOIN_CACHE_HASHED::put_record does. When the join
+    buffer becomes full and the records can be spilled, the function starts
+    spilling them into partitions instead of reporting that the buffer is
+    full. The records that come after this are written into the partitions.
+
+  RETURN VALUE
+    TRUE    if it has been decided that it should be the last record
+            in the join buffer, or spilling has failed
+    FALSE   otherwise
+*/
+
+bool JOIN_CACHE_BNLH::put_record()
+{
+  if (spill_parts)
+  {
+    if (!spill_error)
+      spill_error= spill_record();
+    return spill_error;
+  }
+  if (!JOIN_CACHE_HASHED::put_record())
+    return FALSE;
+  return spill_allowed() ? start_spill() : TRUE;
+}
+
+
+/*
+  Join records from the BNLH join cache with records from join_tab
+
+  DESCRIPTION
+    If the records have been spilled the function joins the spilled records
+    partition by partition, otherwise it just calls JOIN_CACHE::join_records.
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::join_records(bool skip_last)
+{
+  if (!spill_parts && !spill_error)
+    return JOIN_CACHE::join_records(skip_last);
+  DBUG_ASSERT(!skip_last);
+  return join_spilled_records();
+}
+
+
+/*
+  Free the join buffer and the spill partitions of the BNLH join cache
+*/
+
+void JOIN_CACHE_BNLH::free()
+{
+  free_spill();
+  JOIN_CACHE::free();
+}
+
+
+/*
+  Initiate iteration over the rows of join_tab saved for a spill partition
+*/
+
+int JOIN_TAB_SCAN_SPILL::open()
+{
+  save_or_restore_used_tabs(join_tab, FALSE);
+  join_tab->tracker->r_scans++;
+  return reinit_io_cache(file, READ_CACHE, 0L, 0, 0);
+}
+
+
+/*
+  Read the next row of join_tab saved for a spill partition
+
+  RETURN VALUE
+    0     the next row has been read into the record buffer of join_tab
+    -1    there are no more rows
+    1     a read error occurred
+*/
+
+int JOIN_TAB_SCAN_SPILL::next()
+{
+  TABLE *table= join_tab->table;
+  if (my_b_read(file, table->record[0], table->s->reclength))
+    return file->error ? 1 : -1;
+  table->status= 0;
+  table->null_row= 0;
+  /* The saved rows have passed the condition pushed to the table */
+  join_tab->tracker->r_rows++;
+  join_tab->tracker->r_rows_after_where++;
+  return 0;
+}
+
+
+/*
+  Finish iteration over the rows of join_tab saved for a spill partition
+*/
+
+void JOIN_TAB_SCAN_SPILL::close()
+{
+  save_or_restore_used_tabs(join_tab, TRUE);
+}
+
+
 /* 
   Calculate the increment of the MRR buffer for a record write       
 
@@ -23,6 +23,12 @@
 #define JOIN_CACHE_HASHED_BIT                2
 #define JOIN_CACHE_BKA_BIT                   4
 
+/*
+  Number of fingerprints of the hash table slots of a hashed join cache
+  that are compared at once (they fill one 64-bit word)
+*/
+#define JOIN_CACHE_HASH_GROUP                8
+
 /* 
   Categories of data fields of variable length written into join cache buffers.
   The value of any of these fields is written into cache together with the
@@ -671,7 +677,7 @@ class JOIN_CACHE :public Sql_alloc
   }
      
   /* Join records from the join buffer with records from the next join table */ 
-  enum_nested_loop_state join_records(bool skip_last);
+  virtual enum_nested_loop_state join_records(bool skip_last);
 
   /* Add a comment on the join algorithm employed by the join cache */
   virtual bool save_explain_data(EXPLAIN_BKA_TYPE *explain);
@@ -680,7 +686,7 @@ class JOIN_CACHE :public Sql_alloc
 
   virtual ~JOIN_CACHE() = default;
   void reset_join(JOIN *j) { join= j; }
-  void free()
+  virtual void free()
   { 
     my_free(buff);
     buff= 0;
@@ -706,18 +712,22 @@ class JOIN_CACHE :public Sql_alloc
   that either itself contains the key value, or, in the case when the keys are
   embedded, refers to its occurrence in one of the records from the chain.
   To build the chains with the same keys a hash table is employed. It is placed
-  at the very end of the join buffer. The array of hash entries is allocated
-  first at the very bottom of the join buffer, while key entries are placed
-  before this array.
-  A hash entry contains a header of the list of the key entries with the same
-  hash value. 
+  at the very end of the join buffer. The hash table is an open addressing
+  table: the array of its slots is allocated first at the very bottom of the
+  join buffer, while key entries are placed before this array.
+  Each used slot refers to one key entry. A key that collides with another
+  one is placed into the next free slot.
+  The slot array is preceded by an array of one byte fingerprints of the
+  keys, one per slot, with 0 marking a free slot. A lookup compares
+  JOIN_CACHE_HASH_GROUP fingerprints at a time and dereferences a key entry
+  only when its fingerprint matches, so most probes for absent keys and
+  collisions are resolved without touching the key entries.
   Each key entry is a structure of the following type:
     struct st_join_cache_key_entry {
       union { 
         uchar[] value;
         cache_ref *value_ref; // offset from the beginning of the buffer
       } hash_table_key;
-      key_ref next_key; // offset backward from the beginning of hash table
       cache_ref *last_rec // offset from the beginning of the buffer
     }
   The references linking the records in a chain are always placed at the very
@@ -746,42 +756,44 @@ class JOIN_CACHE :public Sql_alloc
   ||^          |            |<---------------------------+-------------------+ |
   |++          | | ... mrr  |   buffer ...           ... |     |               |
   |            |            |                            |                     |
-  |      +-----+--------+   |                      +-----|-------+             |
-  |      V     |        |   |                      V     |       |             |
-  ||key_3|[/]|[*]|      |   |                |key_2|[/]|[*]|     |             |
-  |                   +-+---|-----------------------+            |             |
-  |                   V |   |                       |            |             |
-  |             |key_1|[*]|[*]|         |   | ... |[*]|   ...  |[*]|  ...  |   |
+  |      +-----+-------+    |                     +-----+                      |
+  |      V     |       |    |                     V     |                      |
+  ||key_3|[*]| |key_1|[*]|  |                |key_2|[*]|                       |
+  |   ^           ^                             ^                              |
+  |   |           +---------------------+       +---------------+              |
+  |   +---------------------------------|---+                   |              |
+  |              |fingerprints|  ...  |[*]|[*]|  ...          |[*]|  ...       |
   +----------------------------------------------------------------------------+
-                                        ^           ^            ^
-                                        |           i-th entry   j-th entry
-                                        hash table
+                                        ^   ^                   ^
+                                        |   | (i+1)-th slot     |
+                                        i-th slot               |
+                                                                j-th slot
 
-  i-th hash entry:
+  i-th slot:
     circular record chain for key_1:
       record_1_1
       record_1_2
       record_1_3 (points to record_1_1)
-    circular record chain for key_3:
-      record_3_1 (points to itself)
-
-  j-th hash entry:
+  j-th slot:
     circular record chain for key_2:
       record_2_1
       record_2_2 (points to record_2_1)
+  a slot between them, key_3 collided with key_1 and took the next slot:
+    circular record chain for key_3:
+      record_3_1 (points to itself)
 
 */
 
 class JOIN_CACHE_HASHED: public JOIN_CACHE
 {
 
-  typedef uint (JOIN_CACHE_HASHED::*Hash_func) (uchar *key, uint key_len);
+  typedef ulong (JOIN_CACHE_HASHED::*Hash_func) (uchar *key, uint key_len);
   typedef bool (JOIN_CACHE_HASHED::*Hash_cmp_func) (uchar *key1, uchar *key2,
                                                     uint key_len);
   
 private:
 
-  /* Size of the offset of a key entry in the hash table */
+  /* Size of the offset of a key entry stored in a hash table slot */
   uint size_of_key_ofs;
 
   /* 
@@ -791,10 +803,22 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
   */ 
   uint key_entry_length;
  
-  /* The beginning of the hash table in the join buffer */
+  /*
+    The beginning of the hash table in the join buffer. This is also the
+    beginning of the array of the fingerprints of the hash table slots.
+  */
   uchar *hash_table;
-  /* Number of hash entries in the hash table */
+  /* The array of the slots of the hash table */
+  uchar *hash_slots;
+  /* Number of slots in the hash table */
   uint hash_entries;
+  /*
+    Maximum number of key entries in the hash table. When it is reached
+    the join buffer is considered full, so some slots are always free.
+  */
+  uint max_key_entries;
+  /* The fingerprint of the key looked for by the last call of key_search() */
+  uchar search_fingerprint;
 
 
   /* The position of the currently retrieved key entry in the hash table */
@@ -803,8 +827,8 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
   /* The offset of the data fields from the beginning of the record fields */
   uint data_fields_offset;
 
-  inline uint get_hash_idx_simple(uchar *key, uint key_len);
-  inline uint get_hash_idx_complex(uchar *key, uint key_len);
+  inline ulong get_hash_simple(uchar *key, uint key_len);
+  inline ulong get_hash_complex(uchar *key, uint key_len);
 
   inline bool equal_keys_simple(uchar *key1, uchar *key2, uint key_len);
   inline bool equal_keys_complex(uchar *key1, uchar *key2, uint key_len);
@@ -862,46 +886,24 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
   uint get_size_of_key_offset() { return size_of_key_ofs; }
 
   /* 
-    Get the position of the next_key_ptr field pointed to by 
-    a linking reference stored at the position key_ref_ptr. 
-    This reference is actually the offset backward from the
-    beginning of hash table.
+    Get the position of the key entry referred to by the hash table
+    slot at the position slot_ptr. The stored reference is actually
+    the offset backward from the beginning of the hash table.
   */  
-  uchar *get_next_key_ref(uchar *key_ref_ptr)
+  uchar *get_next_key_ref(uchar *slot_ptr)
   {
-    return hash_table-get_offset(size_of_key_ofs, key_ref_ptr);
+    return hash_table-get_offset(size_of_key_ofs, slot_ptr);
   }
 
   /* 
-    Store the linking reference to the next_key_ptr field at 
-    the position key_ref_ptr. The position of the next_key_ptr
-    field is pointed to by ref. The stored reference is actually
-    the offset backward from the beginning of the hash table.
+    Store the reference to the key entry at the position ref into
+    the hash table slot at the position slot_ptr. The stored reference
+    is actually the offset backward from the beginning of the hash table.
   */  
-  void store_next_key_ref(uchar *key_ref_ptr, uchar *ref)
+  void store_next_key_ref(uchar *slot_ptr, uchar *ref)
   {
-    store_offset(size_of_key_ofs, key_ref_ptr, (ulong) (hash_table-ref));
+    store_offset(size_of_key_ofs, slot_ptr, (ulong) (hash_table-ref));
   }     
-  
-  /* 
-    Check whether the reference to the next_key_ptr field at the position
-    key_ref_ptr contains  a nil value.
-  */
-  bool is_null_key_ref(uchar *key_ref_ptr)
-  {
-    ulong nil= 0;
-    return memcmp(key_ref_ptr, &nil, size_of_key_ofs ) == 0;
-  } 
-
-  /* 
-    Set the reference to the next_key_ptr field at the position
-    key_ref_ptr equal to nil.
-  */
-  void store_null_key_ref(uchar *key_ref_ptr)
-  {
-    ulong nil= 0;
-    store_offset(size_of_key_ofs, key_ref_ptr, nil);
-  } 
 
   uchar *get_next_rec_ref(uchar *ref_ptr)
   {
@@ -984,6 +986,9 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
   /* Search for a key in the hash table of the join buffer */
   bool key_search(uchar *key, uint key_len, uchar **key_ref_ptr);
 
+  /* Add a key entry into a free slot found by key_search() */
+  void add_key_to_hash_table(uchar *slot_ptr, uchar *key_entry);
+
   /* Reallocate the join buffer of a hashed join cache */
   int realloc_buffer();
 
@@ -1151,14 +1156,86 @@ class JOIN_CACHE_BNL :public JOIN_CACHE
 };
 
 
+/*
+  The class JOIN_TAB_SCAN_SPILL is a companion class for the class
+  JOIN_CACHE_BNLH used when the records of the join buffer have been
+  spilled into partitions. It iterates over the rows of join_tab that
+  have been saved into the temporary file of one partition instead of
+  scanning the table.
+*/
+
+class JOIN_TAB_SCAN_SPILL: public JOIN_TAB_SCAN
+{
+public:
+  /* The temporary file with the rows of the partition to iterate over */
+  IO_CACHE *file;
+
+  JOIN_TAB_SCAN_SPILL(JOIN *j, JOIN_TAB *tab) :JOIN_TAB_SCAN(j, tab), file(0)
+  {}
+
+  int open();
+
+  int next();
+
+  void close();
+};
+
+
 /*
   The class JOIN_CACHE_BNLH is used when the BNLH join algorithm is
-  employed to perform a join operation   
+  employed to perform a join operation.
+  If the join buffer becomes full and spilling is allowed by the variable
+  join_buffer_spill_partitions the cache switches to a grace hash join:
+  all partial join records are written into temporary files, one per
+  partition determined by the hash of the join key, and when the last
+  record has been received the rows of join_tab are distributed over
+  partitions in the same way by a single scan of the table. Then each
+  partition is joined separately, so that the table is scanned only once
+  instead of once per refill of the join buffer.
 */
 
 class JOIN_CACHE_BNLH :public JOIN_CACHE_HASHED
 {
 
+private:
+
+  /* The temporary files and the number of records of a spill partition */
+  struct Spill_partition
+  {
+    /* The partial join records of the partition */
+    IO_CACHE outer;
+    /* The rows of join_tab of the partition */
+    IO_CACHE inner;
+    /* Number of the records written into 'outer' */
+    ha_rows records;
+  };
+
+  /* Spill partitions, 0 if the records are not spilled */
+  Spill_partition *spill_part;
+  /* Number of the elements in spill_part */
+  uint spill_parts;
+  /* Length of a partial join record written into a spill file */
+  uint spill_rec_length;
+  /*
+    Buffer for a record read from a spill file followed by the image
+    of the last record that has been put into the cache
+  */
+  uchar *spill_rec;
+  /* Set if writing a spilled record has failed */
+  bool spill_error;
+  /* The iterator over the rows of join_tab saved for a partition */
+  JOIN_TAB_SCAN_SPILL *spill_scan;
+
+  bool spill_allowed();
+  bool start_spill();
+  void free_spill();
+  uint get_spill_partition(uchar *key);
+  void pack_spill_record(uchar *rec);
+  void unpack_spill_record(uchar *rec);
+  bool spill_record();
+  enum_nested_loop_state spill_join_tab_rows();
+  enum_nested_loop_state join_spilled_records();
+
 protected:
 
   /* 
@@ -1197,7 +1274,9 @@ class JOIN_CACHE_BNLH :public JOIN_CACHE_HASHED
     used to join table 'tab' to the result of joining the previous tables 
     specified by the 'j' parameter.
   */   
-  JOIN_CACHE_BNLH(JOIN *j, JOIN_TAB *tab) : JOIN_CACHE_HASHED(j, tab) {}
+  JOIN_CACHE_BNLH(JOIN *j, JOIN_TAB *tab)
+    : JOIN_CACHE_HASHED(j, tab), spill_part(0), spill_parts(0),
+      spill_rec(0), spill_error(0), spill_scan(0) {}
 
   /* 
     This constructor creates a linked BNLH join cache. The cache is to be 
@@ -1206,7 +1285,8 @@ class JOIN_CACHE_BNLH :public JOIN_CACHE_HASHED
     cache object to which this cache is linked.
   */   
   JOIN_CACHE_BNLH(JOIN *j, JOIN_TAB *tab, JOIN_CACHE *prev) 
-    : JOIN_CACHE_HASHED(j, tab, prev) {}
+    : JOIN_CACHE_HASHED(j, tab, prev), spill_part(0), spill_parts(0),
+      spill_rec(0), spill_error(0), spill_scan(0) {}
 
   /* Initialize the BNLH cache */       
   int init(bool for_explain);
@@ -1215,6 +1295,13 @@ class JOIN_CACHE_BNLH :public JOIN_CACHE_HASHED
 
   bool is_key_access() { return TRUE; }
 
+  /* Add a record into the join buffer or into its spill partition */
+  bool put_record();
+
+  enum_nested_loop_state join_records(bool skip_last);
+
+  void free();
+
 };
 
 
@@ -239,13 +239,17 @@ class READ_INFO: public Load_data_param
 
 public:
   bool error,line_cuted,found_null,enclosed;
+  uint parser_threads;                  /* Parsed by Load_data_parser */
+  const char *file_name;                /* For the Load_data_parser threads */
   uchar	*row_start,			/* Found row starts here */
 	*row_end;			/* Found row ends here */
   LOAD_FILE_IO_CACHE cache;
 
   READ_INFO(THD *thd, File file, const Load_data_param &param,
 	    String &field_term,String &line_start,String &line_term,
-	    String &enclosed,int escape,bool get_it_from_net, bool is_fifo);
+	    String &enclosed,int escape,bool get_it_from_net, bool is_fifo,
+            uint parser_threads= 0, const char *file_name= NULL);
+  READ_INFO(THD *thd, File file, const READ_INFO &from);
   ~READ_INFO();
   int read_field();
   int read_fixed_length(void);
@@ -265,6 +269,26 @@ class READ_INFO: public Load_data_param
 
   my_off_t file_length() { return cache.end_of_file; }
   my_off_t position()    { return my_b_tell(&cache); }
+  uint line_term_length() const { return m_line_term.length(); }
+
+  /** Continue reading at a position of the file */
+  bool seek(my_off_t pos)
+  {
+    stack_pos= stack;
+    found_end_of_line= eof= line_cuted= false;
+    return (error= reinit_io_cache(&cache, READ_CACHE, pos, 0, 0));
+  }
+  /**
+    Continue reading at the first line that starts at pos or later.
+    Only valid when a line terminator can not be escaped, enclosed,
+    or be a part of a field terminator, see load_data_can_split().
+    @return 1 if there is no such line
+  */
+  int seek_line(my_off_t pos)
+  {
+    DBUG_ASSERT(pos >= m_line_term.length());
+    return seek(pos - m_line_term.length()) || next_line();
+  }
 
   /**
     skip all data till the eof.
@@ -297,6 +321,128 @@ static int read_xml_field(THD *thd, COPY_INFO &info, TABLE_LIST *table_list,
                           String &enclosed, ulong skip_lines,
                           bool ignore_check_option_errors);
 
+/*
+  Parallel parsing of LOAD DATA INFILE
+
+  load_data_parser threads run the READ_INFO tokenizer and store the
+  fields of the rows in batches, while the connection thread converts
+  and inserts the rows of the batches that are already parsed. TABLE and
+  Field objects belong to the connection thread, so only the parsing is
+  moved to the other threads. The rows are inserted in file order, which
+  keeps auto-increment values and warnings the same as in a serial load.
+
+  If a line terminator can be found without parsing the data before it
+  (see load_data_can_split()), the file is split into chunks of
+  LOAD_DATA_CHUNK_SIZE bytes. A row belongs to the chunk where it starts.
+  Chunk i is parsed by thread i % n, with its own READ_INFO and file
+  descriptor, into the batches of that thread. The connection thread
+  consumes the batches of chunk 0, 1, 2, ... in turn. Otherwise a single
+  thread parses the whole file with the READ_INFO of the statement.
+
+  A row is stored in a batch as
+    1 byte   LOAD_ROW_* flags
+    4 bytes  number of fields read
+  followed by the fields, each stored as
+    1 byte   1 if the field is NULL
+    4 bytes  length of the value
+    value, followed by a terminating 0 byte
+*/
+
+#define LOAD_DATA_BATCHES 4
+#define LOAD_DATA_BATCH_ROWS 1024
+#define LOAD_DATA_BATCH_SIZE (128*1024)
+/* A chunk fits in the batches of one thread, so that n threads can parse
+   n chunks ahead of the connection thread. */
+#define LOAD_DATA_CHUNK_SIZE LOAD_DATA_BATCH_SIZE
+
+#define LOAD_ROW_LINE_CUTED 1                   /* Row had too many fields */
+#define LOAD_ROW_LAST       2                   /* Last row of the file */
+
+struct Load_data_batch
+{
+  uchar *buf;
+  size_t length, size;
+  uint rows;
+  my_off_t position;                    /* File position after the batch */
+  bool end;                             /* No more rows in the chunk */
+  bool error;                           /* Parsing failed after the batch */
+  bool ready;                           /* Parsed and not yet consumed */
+};
+
+class Load_data_parser;
+
+struct Load_data_worker
+{
+  Load_data_parser *parser;
+  READ_INFO *read_info;
+  File file;                            /* Own descriptor, or -1 */
+  uint id;
+  uint next;                            /* The batch to consume next */
+  pthread_t thread_id;
+  Load_data_batch batches[LOAD_DATA_BATCHES];
+};
+
+class Load_data_parser
+{
+  READ_INFO &read_info;
+  const uint field_count;
+  const uint enclosed_length;
+  Load_data_worker *workers;
+  uint n_alloced;                       /* Elements of workers[] */
+  uint n_workers;                       /* Threads that were started */
+  bool split;                           /* The file is split into chunks */
+  my_off_t start_pos, end_pos, chunk_size;
+  ulonglong chunk;                      /* The chunk to consume next */
+  mysql_mutex_t lock;
+  mysql_cond_t cond;                    /* Signaled when a batch changes */
+  bool abort;
+
+  bool reserve(Load_data_batch *batch, size_t length);
+  void parse_batch(READ_INFO &info, Load_data_batch *batch, my_off_t end);
+  bool has_chunk(ulonglong i) const
+  { return !i || (split && start_pos + i * chunk_size < end_pos); }
+public:
+  Load_data_parser(READ_INFO &read_info, uint field_count,
+                   uint enclosed_length);
+  ~Load_data_parser();
+  bool start(THD *thd);
+  void run(Load_data_worker *worker);
+  Load_data_batch *next_batch();
+  bool release_batch();
+};
+
+
+/**
+  Check if the file can be split into chunks at line terminators, that is,
+  if every occurrence of the line terminator ends a line.
+
+  This is not the case if the terminator can be escaped or be inside an
+  enclosed field, if its first byte also occurs later in it or in the
+  field terminator (so that a match that starts earlier can swallow it),
+  or if the byte can be a part of a multi-byte character. LINES STARTING
+  BY is not supported either.
+*/
+
+static bool load_data_can_split(const sql_exchange *ex, int escape_char,
+                                CHARSET_INFO *cs)
+{
+  const String *line_term= ex->line_term;
+  const String *field_term= ex->field_term;
+
+  if (ex->enclosed->length() || escape_char != INT_MAX ||
+      ex->line_start->length() || !line_term->length())
+    return false;
+
+  const uchar first= (uchar) (*line_term)[0];
+  if (memchr(line_term->ptr() + 1, first, line_term->length() - 1) ||
+      memchr(field_term->ptr(), first, field_term->length()))
+    return false;
+
+  /* In UTF-8, a byte below 0x80 is never a part of a longer character */
+  return cs->mbmaxlen == 1 ||
+         (cs->mbminlen == 1 && (cs->state & MY_CS_UNICODE) && first < 0x80);
+}
+
 #ifndef EMBEDDED_LIBRARY
 static bool write_execute_load_query_log_event(THD *, const sql_exchange*, const
            char*, const char*, bool, enum enum_duplicates, bool, bool, int);
@@ -630,10 +776,28 @@ int mysql_load(THD *thd, const sql_exchange *ex, TABLE_LIST *table_list,
                     !(thd->variables.sql_mode & MODE_NO_BACKSLASH_ESCAPES)))
                     ? (*ex->escaped)[0] : INT_MAX;
 
+  /*
+    The parser threads can not read from the client connection. With
+    statement based binary logging the file is copied to the binary log
+    by the connection thread while it is read, see log_loaded_block().
+  */
+  uint parser_threads= thd->variables.load_data_parser_threads;
+  if (read_file_from_client || is_fifo || ex->filetype == FILETYPE_XML ||
+      param.is_fixed_length())
+    parser_threads= 0;
+#ifndef EMBEDDED_LIBRARY
+  if (mysql_bin_log.is_open() && !thd->is_current_stmt_binlog_format_row())
+    parser_threads= 0;
+#endif
+  if (parser_threads > 1 &&
+      !load_data_can_split(ex, info.escape_char, param.charset()))
+    parser_threads= 1;
+
   READ_INFO read_info(thd, file, param,
                       *ex->field_term, *ex->line_start,
                       *ex->line_term, *ex->enclosed,
-		      info.escape_char, read_file_from_client, is_fifo);
+		      info.escape_char, read_file_from_client, is_fifo,
+                      parser_threads, name);
   if (unlikely(read_info.error))
   {
     if (file >= 0)
@@ -1130,6 +1294,433 @@ continue_loop:;
 }
 
 
+Load_data_parser::Load_data_parser(READ_INFO &read_info_arg,
+                                   uint field_count_arg,
+                                   uint enclosed_length_arg)
+  :read_info(read_info_arg), field_count(field_count_arg),
+   enclosed_length(enclosed_length_arg), workers(NULL), n_alloced(0),
+   n_workers(0), split(false), chunk(0), abort(false)
+{
+  mysql_mutex_init(PSI_NOT_INSTRUMENTED, &lock, MY_MUTEX_INIT_FAST);
+  mysql_cond_init(PSI_NOT_INSTRUMENTED, &cond, NULL);
+}
+
+
+Load_data_parser::~Load_data_parser()
+{
+  if (n_workers)
+  {
+    mysql_mutex_lock(&lock);
+    abort= true;
+    mysql_cond_broadcast(&cond);
+    mysql_mutex_unlock(&lock);
+    for (uint i= 0; i < n_workers; i++)
+      pthread_join(workers[i].thread_id, NULL);
+  }
+  mysql_cond_destroy(&cond);
+  mysql_mutex_destroy(&lock);
+  for (uint i= 0; i < n_alloced; i++)
+  {
+    Load_data_worker *w= &workers[i];
+    for (uint j= 0; j < LOAD_DATA_BATCHES; j++)
+      my_free(w->batches[j].buf);
+    if (w->read_info != &read_info)
+      delete w->read_info;
+    if (w->file >= 0)
+      mysql_file_close(w->file, MYF(0));
+  }
+  my_free(workers);
+}
+
+
+static void *load_data_parser_thread(void *arg)
+{
+  Load_data_worker *worker= (Load_data_worker*) arg;
+  my_thread_init();
+  worker->parser->run(worker);
+  my_thread_end();
+  return 0;
+}
+
+
+/**
+  Start the parser threads.
+
+  Up to read_info.parser_threads threads are started when the file is
+  split into chunks, and one otherwise.
+
+  @retval false  OK
+  @retval true   No thread could be started. No error is set, the caller
+                 should parse the file itself.
+*/
+
+bool Load_data_parser::start(THD *thd)
+{
+  uint threads= read_info.parser_threads;
+
+  start_pos= read_info.position();
+  end_pos= read_info.file_length();
+  chunk_size= LOAD_DATA_CHUNK_SIZE;
+  DBUG_EXECUTE_IF("load_data_small_chunks", chunk_size= 100;);
+  set_if_bigger(chunk_size, read_info.line_term_length());
+  if (threads > 1)
+    set_if_smaller(threads, end_pos > start_pos
+                            ? (end_pos - start_pos - 1) / chunk_size + 1 : 1);
+  split= threads > 1;
+  if (!split)
+    threads= 1;
+
+  if (!(workers= (Load_data_worker*)
+        my_malloc(PSI_INSTRUMENT_ME, threads * sizeof *workers,
+                  MYF(MY_ZEROFILL))))
+    return true;
+
+  while (n_alloced < threads)
+  {
+    Load_data_worker *w= &workers[n_alloced];
+    w->parser= this;
+    w->id= n_alloced++;
+    w->file= -1;
+    w->read_info= &read_info;
+    for (uint j= 0; j < LOAD_DATA_BATCHES; j++)
+    {
+      if (!(w->batches[j].buf= (uchar*) my_malloc(PSI_INSTRUMENT_ME,
+                                                  LOAD_DATA_BATCH_SIZE,
+                                                  MYF(0))))
+        return true;
+      w->batches[j].size= LOAD_DATA_BATCH_SIZE;
+    }
+    if (!split)
+      continue;
+    /* Each thread reads its chunks through its own descriptor */
+    w->read_info= NULL;
+    if ((w->file= mysql_file_open(key_file_load, read_info.file_name,
+                                  O_RDONLY, MYF(0))) < 0 ||
+        !(w->read_info= new READ_INFO(thd, w->file, read_info)) ||
+        w->read_info->error)
+      return true;
+  }
+
+  /* The threads read n_workers after it has been set */
+  mysql_mutex_lock(&lock);
+  for (; n_workers < threads; n_workers++)
+    if (mysql_thread_create(key_thread_load_data_parser,
+                            &workers[n_workers].thread_id, NULL,
+                            load_data_parser_thread, &workers[n_workers]))
+      break;
+  mysql_mutex_unlock(&lock);
+  return !n_workers;
+}
+
+
+/** Make room for 'length' more bytes in a batch. Runs in the parser. */
+
+bool Load_data_parser::reserve(Load_data_batch *batch, size_t length)
+{
+  if (batch->length + length <= batch->size)
+    return false;
+  size_t size= MY_MAX(batch->size * 2, batch->length + length);
+  uchar *buf= (uchar*) my_realloc(PSI_INSTRUMENT_ME, batch->buf, size,
+                                  MYF(0));
+  if (!buf)
+    return true;
+  batch->buf= buf;
+  batch->size= size;
+  return false;
+}
+
+
+/**
+  Parse rows into a batch, in the same way as read_sep_field() does.
+  Only rows that start before the file position 'end' are parsed.
+  Sets batch->end when the chunk, the file or the parsing has ended.
+*/
+
+void Load_data_parser::parse_batch(READ_INFO &info, Load_data_batch *batch,
+                                   my_off_t end)
+{
+  batch->length= 0;
+  batch->rows= 0;
+  batch->end= batch->error= false;
+
+  while (batch->rows < LOAD_DATA_BATCH_ROWS &&
+         batch->length < LOAD_DATA_BATCH_SIZE)
+  {
+    size_t row_start= batch->length;
+    uint fields= 0;
+    uchar flags= 0;
+
+    if (info.position() >= end)
+    {
+      /* The row belongs to the next chunk */
+      batch->end= true;
+      break;
+    }
+
+    if (reserve(batch, 5))
+      goto error;
+    batch->length+= 5;
+
+    while (fields < field_count && !info.read_field())
+    {
+      uchar *pos= info.row_start;
+      uint length= (uint) (info.row_end - pos);
+      uchar *to;
+
+      if (reserve(batch, length + 6))
+        goto error;
+      to= batch->buf + batch->length;
+      to[0]= (!info.enclosed &&
+              (enclosed_length && length == 4 &&
+               !memcmp(pos, STRING_WITH_LEN("NULL")))) ||
+             (length == 1 && info.found_null);
+      int4store(to + 1, length);
+      memcpy(to + 5, pos, length);
+      to[5 + length]= 0;
+      batch->length+= length + 6;
+      fields++;
+    }
+    if (unlikely(info.error))
+      goto error;
+    if (!fields)
+    {
+      /* Have not read any field, thus input file is simply ended */
+      batch->length= row_start;
+      batch->end= true;
+      break;
+    }
+
+    if (info.next_line())
+      flags|= LOAD_ROW_LAST;
+    else if (info.line_cuted)
+      flags|= LOAD_ROW_LINE_CUTED;
+    batch->buf[row_start]= flags;
+    int4store(batch->buf + row_start + 1, fields);
+    batch->rows++;
+    if (flags & LOAD_ROW_LAST)
+    {
+      batch->end= true;
+      break;
+    }
+  }
+  batch->position= info.position();
+  return;
+
+error:
+  batch->error= batch->end= true;
+  batch->position= info.position();
+}
+
+
+/**
+  A parser thread: parse the chunks of the thread in turn until the file
+  ends. Each chunk ends with a batch that has the end flag set.
+*/
+
+void Load_data_parser::run(Load_data_worker *w)
+{
+  uint i= 0;
+
+  mysql_mutex_lock(&lock);
+  const uint stride= n_workers;
+  mysql_mutex_unlock(&lock);
+
+  for (ulonglong c= w->id; has_chunk(c); c+= stride)
+  {
+    my_off_t start= start_pos + c * chunk_size;
+    my_off_t end= split ? start + chunk_size : ~(my_off_t) 0;
+    /* Find the first row that starts in the chunk */
+    bool no_rows= split && (c ? w->read_info->seek_line(start)
+                              : w->read_info->seek(start));
+    Load_data_batch *batch;
+
+    do
+    {
+      batch= &w->batches[i];
+      bool stop;
+
+      mysql_mutex_lock(&lock);
+      while (batch->ready && !abort)
+        mysql_cond_wait(&cond, &lock);
+      stop= abort;
+      mysql_mutex_unlock(&lock);
+      if (stop)
+        return;
+
+      if (no_rows)
+      {
+        batch->length= 0;
+        batch->rows= 0;
+        batch->end= true;
+        batch->error= w->read_info->error;
+        batch->position= w->read_info->position();
+      }
+      else
+        parse_batch(*w->read_info, batch, end);
+
+      mysql_mutex_lock(&lock);
+      batch->ready= true;
+      mysql_cond_broadcast(&cond);
+      mysql_mutex_unlock(&lock);
+      i= (i + 1) % LOAD_DATA_BATCHES;
+      if (batch->error)
+        return;
+    } while (!batch->end);
+  }
+}
+
+
+/** Wait until the next batch in file order has been parsed. */
+
+Load_data_batch *Load_data_parser::next_batch()
+{
+  Load_data_worker *w= &workers[chunk % n_workers];
+  Load_data_batch *batch= &w->batches[w->next];
+  mysql_mutex_lock(&lock);
+  while (!batch->ready)
+    mysql_cond_wait(&cond, &lock);
+  mysql_mutex_unlock(&lock);
+  return batch;
+}
+
+
+/**
+  Give the batch returned by next_batch() back to its parser.
+
+  @return true if it was the last batch of the file
+*/
+
+bool Load_data_parser::release_batch()
+{
+  Load_data_worker *w= &workers[chunk % n_workers];
+  Load_data_batch *batch= &w->batches[w->next];
+  const bool end= batch->end;
+
+  mysql_mutex_lock(&lock);
+  batch->ready= false;
+  mysql_cond_broadcast(&cond);
+  mysql_mutex_unlock(&lock);
+  w->next= (w->next + 1) % LOAD_DATA_BATCHES;
+  return end && !has_chunk(++chunk);
+}
+
+
+/**
+  Insert the rows parsed by a Load_data_parser.
+
+  Does the same as the row loop of read_sep_field(), with the fields
+  taken from the batches instead of from READ_INFO.
+*/
+
+static int
+read_parsed_rows(THD *thd, COPY_INFO &info, TABLE_LIST *table_list,
+                 List<Item> &fields_vars, List<Item> &set_fields,
+                 List<Item> &set_values, READ_INFO &read_info,
+                 Load_data_parser &parser, bool ignore_check_option_errors)
+{
+  List_iterator_fast<Item> it(fields_vars);
+  Item *item;
+  TABLE *table= table_list->table;
+  bool err, progress_reports;
+  DBUG_ENTER("read_parsed_rows");
+
+  progress_reports= thd->progress.max_counter != ~(my_off_t) 0;
+
+  for (;;)
+  {
+    Load_data_batch *batch= parser.next_batch();
+    const uchar *pos= batch->buf;
+
+    for (uint row= 0; row < batch->rows; row++)
+    {
+      uint flags= pos[0];
+      uint fields= uint4korr(pos + 1);
+      pos+= 5;
+
+      if (thd->killed)
+      {
+        thd->send_kill_message();
+        DBUG_RETURN(1);
+      }
+      restore_record(table, s->default_values);
+
+      for (it.rewind(); fields; fields--)
+      {
+        uint length= uint4korr(pos + 1);
+        Load_data_outvar *dst= (item= it++)->get_load_data_outvar_or_error();
+        DBUG_ASSERT(dst);
+
+        if (pos[0] ? dst->load_data_set_null(thd, &read_info) :
+            dst->load_data_set_value(thd, (const char *) pos + 5, length,
+                                     &read_info))
+          DBUG_RETURN(1);
+        pos+= length + 6;
+      }
+
+      if (unlikely(thd->is_error()))
+        DBUG_RETURN(1);
+
+      while ((item= it++))
+      {
+        Load_data_outvar *dst= item->get_load_data_outvar_or_error();
+        DBUG_ASSERT(dst);
+        if (unlikely(dst->load_data_set_no_data(thd, &read_info)))
+          DBUG_RETURN(1);
+      }
+
+      if (unlikely(thd->killed) ||
+          unlikely(fill_record_n_invoke_before_triggers(thd, table,
+                                          set_fields, set_values,
+                                          ignore_check_option_errors,
+                                          TRG_EVENT_INSERT)))
+        DBUG_RETURN(1);
+
+      switch (table_list->view_check_option(thd,
+                                            ignore_check_option_errors)) {
+      case VIEW_CHECK_SKIP:
+        continue;
+      case VIEW_CHECK_ERROR:
+        DBUG_RETURN(-1);
+      }
+
+      err= write_record(thd, table, &info);
+      table->auto_increment_field_not_null= FALSE;
+      if (err)
+        DBUG_RETURN(1);
+      if (flags & LOAD_ROW_LAST)
+        break;
+      if (flags & LOAD_ROW_LINE_CUTED)
+      {
+        thd->cuted_fields++;			/* To long row */
+        push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+                            ER_WARN_TOO_MANY_RECORDS,
+                            ER_THD(thd, ER_WARN_TOO_MANY_RECORDS),
+                            thd->get_stmt_da()->current_row_for_warning());
+        if (thd->killed)
+          DBUG_RETURN(1);
+      }
+      thd->get_stmt_da()->inc_current_row_for_warning();
+    }
+
+    if (progress_reports)
+    {
+      thd->progress.counter= batch->position;
+      thd_progress_report(thd, thd->progress.counter,
+                          thd->progress.max_counter);
+    }
+    if (unlikely(batch->error))
+    {
+      /* The parser thread has no THD to report the error to */
+      if (!thd->is_error())
+        my_error(ER_OUT_OF_RESOURCES, MYF(0));
+      DBUG_RETURN(1);
+    }
+    if (parser.release_batch())
+      DBUG_RETURN(0);
+  }
+}
+
+
 static int
 read_sep_field(THD *thd, COPY_INFO &info, TABLE_LIST *table_list,
                List<Item> &fields_vars, List<Item> &set_fields,
@@ -1153,6 +1744,15 @@ read_sep_field(THD *thd, COPY_INFO &info, TABLE_LIST *table_list,
   if ((thd->progress.max_counter= read_info.file_length()) == ~(my_off_t) 0)
     progress_reports= 0;
 
+  if (read_info.parser_threads && !skip_lines)
+  {
+    Load_data_parser parser(read_info, fields_vars.elements, enclosed_length);
+    if (!parser.start(thd))
+      DBUG_RETURN(read_parsed_rows(thd, info, table_list, fields_vars,
+                                   set_fields, set_values, read_info, parser,
+                                   ignore_check_option_errors));
+  }
+
   for (;;it.rewind())
   {
     if (thd->killed)
@@ -1416,14 +2016,18 @@ READ_INFO::READ_INFO(THD *thd, File file_par,
                      const Load_data_param &param,
 		     String &field_term, String &line_start, String &line_term,
 		     String &enclosed_par, int escape, bool get_it_from_net,
-		     bool is_fifo)
+		     bool is_fifo, uint parser_threads_arg,
+                     const char *file_name_arg)
   :Load_data_param(param),
    file(file_par),
    m_field_term(field_term), m_line_term(line_term), m_line_start(line_start),
    escape_char(escape), found_end_of_line(false), eof(false),
-   error(false), line_cuted(false), found_null(false)
+   error(false), line_cuted(false), found_null(false),
+   parser_threads(parser_threads_arg), file_name(file_name_arg)
 {
-  data.set_thread_specific();
+  /* The parser threads have no THD to account thread specific memory to */
+  if (!parser_threads)
+    data.set_thread_specific();
   /*
     Field and line terminators must be interpreted as sequence of unsigned char.
     Otherwise, non-ascii terminators will be negative on some platforms,
@@ -1472,6 +2076,37 @@ READ_INFO::READ_INFO(THD *thd, File file_par,
 }
 
 
+/**
+  A READ_INFO for a Load_data_parser thread that parses a part of the same
+  file through another descriptor. LOAD DATA LOCAL, named pipes and the
+  copying to the binary log are not supported.
+*/
+
+READ_INFO::READ_INFO(THD *thd, File file_par, const READ_INFO &from)
+  :Load_data_param(from),
+   file(file_par),
+   m_field_term(from.m_field_term), m_line_term(from.m_line_term),
+   m_line_start(from.m_line_start),
+   enclosed_char(from.enclosed_char), escape_char(from.escape_char),
+   found_end_of_line(false), start_of_line(from.m_line_start.length() != 0),
+   eof(false), level(0),
+   error(false), line_cuted(false), found_null(false), enclosed(false),
+   parser_threads(from.parser_threads), file_name(NULL)
+{
+  DBUG_ASSERT(parser_threads);
+  uint length= MY_MAX(charset()->mbmaxlen, MY_MAX(m_field_term.length(),
+                                                  m_line_term.length())) + 1;
+  set_if_bigger(length, m_line_start.length());
+  stack= stack_pos= (int*) thd->alloc(sizeof(int) * length);
+
+  bzero((char*) &cache, sizeof(cache));
+  if (!stack || data.reserve((size_t) m_fixed_length) ||
+      init_io_cache(&cache, file, 0, READ_CACHE, 0L, 1,
+                    MYF(MY_WME | MY_THREAD_SPECIFIC)))
+    error= 1;
+}
+
+
 READ_INFO::~READ_INFO()
 {
   ::end_io_cache(&cache);
@@ -2195,6 +2195,18 @@ send_event_to_slave(binlog_send_info *info, Log_event_type event_type,
       return NULL;
   }
 
+  /*
+    A slave that does not understand Transaction_payload_log_event can not
+    replicate the transaction at all, as the events are only in the payload.
+  */
+  if (unlikely(event_type == TRANSACTION_PAYLOAD_EVENT) &&
+      mariadb_slave_capability < MARIA_SLAVE_CAPABILITY_TRANSACTION_PAYLOAD)
+  {
+    info->error= ER_MASTER_FATAL_ERROR_READING_BINLOG;
+    return "Slave does not support compressed transactions "
+           "(binlog_transaction_compression)";
+  }
+
   /*
     Do not send binlog checkpoint or gtid list events to a slave that does not
     understand it.
@@ -2885,6 +2897,340 @@ static my_off_t get_binlog_end_pos(binlog_send_info *info,
   return 0;
 }
 
+/*
+  Binlog dump cache (--binlog-dump-cache-size)
+
+  Dump threads that tail the same binlog read the same bytes. With the
+  cache enabled, they read the binlog files in blocks of
+  BINLOG_DUMP_BLOCK_SIZE bytes that are shared between all dump threads
+  and replaced in LRU order, so that each block is read from the file
+  only once.
+
+  A binlog file is only ever appended to while it is being dumped, so
+  the bytes in a cached block never change; a block that was read before
+  the end of the file was written is extended when a dump thread needs
+  more of it. The exception is the first block of each file, because the
+  LOG_EVENT_BINLOG_IN_USE_F flag of the Format_description_log_event is
+  cleared in place when the file is closed. The first block is never
+  cached. RESET MASTER invalidates the cache, because it reuses the file
+  names.
+*/
+
+static constexpr size_t BINLOG_DUMP_BLOCK_SIZE= 65536;
+
+struct binlog_dump_block
+{
+  /* Binlog file number and block number; the hash key */
+  ulonglong key[2];
+  binlog_dump_block *lru_prev, *lru_next;
+  /* Number of dump threads that are copying from the block */
+  uint refs;
+  /* Number of valid bytes in data[] */
+  size_t length;
+  /* Whether a dump thread is reading data from the file into data[] */
+  bool loading;
+  /* Whether the block is not in the cache, and will be freed when unpinned */
+  bool orphan;
+  uchar data[BINLOG_DUMP_BLOCK_SIZE];
+};
+
+static struct binlog_dump_cache_st
+{
+  mysql_mutex_t lock;
+  mysql_cond_t cond;
+  HASH hash;
+  /* All blocks in the hash, most recently used first */
+  binlog_dump_block *lru_first, *lru_last;
+  size_t n_blocks, max_blocks;
+  bool inited;
+} binlog_dump_cache;
+
+/* IO_CACHE of a dump thread, reading through the binlog dump cache */
+struct BINLOG_DUMP_IO_CACHE : public IO_CACHE
+{
+  ulonglong file_no;
+};
+
+
+void binlog_dump_cache_init()
+{
+  binlog_dump_cache.max_blocks=
+    (size_t) (opt_binlog_dump_cache_size / BINLOG_DUMP_BLOCK_SIZE);
+  if (!binlog_dump_cache.max_blocks)
+    return;
+  mysql_mutex_init(key_LOCK_binlog_dump_cache, &binlog_dump_cache.lock,
+                   MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_COND_binlog_dump_cache, &binlog_dump_cache.cond, NULL);
+  my_hash_init(PSI_INSTRUMENT_ME, &binlog_dump_cache.hash, &my_charset_bin,
+               (ulong) binlog_dump_cache.max_blocks,
+               offsetof(binlog_dump_block, key),
+               sizeof(binlog_dump_block::key), NULL, NULL, 0);
+  binlog_dump_cache.lru_first= binlog_dump_cache.lru_last= NULL;
+  binlog_dump_cache.n_blocks= 0;
+  binlog_dump_cache.inited= true;
+}
+
+
+static void binlog_dump_lru_remove(binlog_dump_block *b)
+{
+  if (b->lru_prev)
+    b->lru_prev->lru_next= b->lru_next;
+  else
+    binlog_dump_cache.lru_first= b->lru_next;
+  if (b->lru_next)
+    b->lru_next->lru_prev= b->lru_prev;
+  else
+    binlog_dump_cache.lru_last= b->lru_prev;
+}
+
+
+static void binlog_dump_lru_push(binlog_dump_block *b)
+{
+  b->lru_prev= NULL;
+  if ((b->lru_next= binlog_dump_cache.lru_first))
+    b->lru_next->lru_prev= b;
+  else
+    binlog_dump_cache.lru_last= b;
+  binlog_dump_cache.lru_first= b;
+}
+
+
+/* Remove a block from the cache; free it unless it is in use. */
+static void binlog_dump_block_remove(binlog_dump_block *b)
+{
+  mysql_mutex_assert_owner(&binlog_dump_cache.lock);
+  binlog_dump_lru_remove(b);
+  my_hash_delete(&binlog_dump_cache.hash, (uchar*) b);
+  binlog_dump_cache.n_blocks--;
+  if (b->refs)
+    b->orphan= true;
+  else
+    my_free(b);
+}
+
+
+void binlog_dump_cache_invalidate()
+{
+  if (!binlog_dump_cache.inited)
+    return;
+  mysql_mutex_lock(&binlog_dump_cache.lock);
+  while (binlog_dump_cache.lru_first)
+    binlog_dump_block_remove(binlog_dump_cache.lru_first);
+  mysql_mutex_unlock(&binlog_dump_cache.lock);
+}
+
+
+void binlog_dump_cache_free()
+{
+  if (!binlog_dump_cache.inited)
+    return;
+  binlog_dump_cache_invalidate();
+  my_hash_free(&binlog_dump_cache.hash);
+  mysql_cond_destroy(&binlog_dump_cache.cond);
+  mysql_mutex_destroy(&binlog_dump_cache.lock);
+  binlog_dump_cache.inited= false;
+}
+
+
+static void binlog_dump_block_unpin(binlog_dump_block *b)
+{
+  mysql_mutex_lock(&binlog_dump_cache.lock);
+  if (!--b->refs && b->orphan)
+    my_free(b);
+  mysql_mutex_unlock(&binlog_dump_cache.lock);
+}
+
+
+/**
+  Get a pinned block of a binlog file, reading it from the file as needed.
+
+  @param file     the binlog file
+  @param file_no  number of the binlog file
+  @param block_no block number within the file
+  @param need     number of bytes that the caller wants to be valid
+
+  @return the block, with at least need bytes valid unless the file is
+          shorter
+  @retval NULL on read error or out of memory
+*/
+static binlog_dump_block *
+binlog_dump_block_get(File file, ulonglong file_no, ulonglong block_no,
+                      size_t need)
+{
+  const ulonglong key[2]= { file_no, block_no };
+  binlog_dump_block *b;
+  size_t have;
+
+  mysql_mutex_lock(&binlog_dump_cache.lock);
+  for (;;)
+  {
+    b= block_no
+      ? (binlog_dump_block*) my_hash_search(&binlog_dump_cache.hash,
+                                            (const uchar*) key, sizeof key)
+      : NULL;
+    if (!b || !b->loading)
+      break;
+    mysql_cond_wait(&binlog_dump_cache.cond, &binlog_dump_cache.lock);
+  }
+
+  if (b)
+  {
+    b->refs++;
+    binlog_dump_lru_remove(b);
+    binlog_dump_lru_push(b);
+    if (b->length >= need)
+    {
+      binlog_dump_cache_hit++;
+      mysql_mutex_unlock(&binlog_dump_cache.lock);
+      return b;
+    }
+  }
+  else
+  {
+    /* Reuse the least recently used block that nobody is copying from. */
+    if (block_no && binlog_dump_cache.n_blocks >= binlog_dump_cache.max_blocks)
+      for (b= binlog_dump_cache.lru_last; b; b= b->lru_prev)
+        if (!b->refs)
+        {
+          binlog_dump_block_remove(b);
+          break;
+        }
+    if (!(b= (binlog_dump_block*) my_malloc(PSI_INSTRUMENT_ME, sizeof *b,
+                                            MYF(MY_WME))))
+    {
+      mysql_mutex_unlock(&binlog_dump_cache.lock);
+      return NULL;
+    }
+    b->key[0]= file_no;
+    b->key[1]= block_no;
+    b->refs= 1;
+    b->length= 0;
+    b->loading= false;
+    b->orphan= true;
+    if (block_no && binlog_dump_cache.n_blocks < binlog_dump_cache.max_blocks &&
+        !my_hash_insert(&binlog_dump_cache.hash, (uchar*) b))
+    {
+      b->orphan= false;
+      binlog_dump_cache.n_blocks++;
+      binlog_dump_lru_push(b);
+    }
+  }
+
+  /*
+    Readers only look at the first b->length bytes, so the rest of the block
+    can be filled without holding the mutex.
+  */
+  binlog_dump_cache_miss++;
+  b->loading= true;
+  have= b->length;
+  mysql_mutex_unlock(&binlog_dump_cache.lock);
+
+  size_t length= mysql_file_pread(file, b->data + have,
+                                  BINLOG_DUMP_BLOCK_SIZE - have,
+                                  block_no * BINLOG_DUMP_BLOCK_SIZE + have,
+                                  MYF(MY_WME));
+
+  mysql_mutex_lock(&binlog_dump_cache.lock);
+  if (length != (size_t) -1)
+    b->length= have + length;
+  b->loading= false;
+  mysql_cond_broadcast(&binlog_dump_cache.cond);
+  mysql_mutex_unlock(&binlog_dump_cache.lock);
+
+  if (length == (size_t) -1)
+  {
+    binlog_dump_block_unpin(b);
+    return NULL;
+  }
+  return b;
+}
+
+
+/**
+  IO_CACHE::read_function of a dump thread when the binlog dump cache is
+  enabled. The contract is that of _my_b_cache_read(): read Count bytes
+  following the contents of info->buffer, and refill info->buffer.
+*/
+static int binlog_dump_cache_read(IO_CACHE *info, uchar *Buffer, size_t Count)
+{
+  const ulonglong file_no= static_cast<BINLOG_DUMP_IO_CACHE*>(info)->file_no;
+  my_off_t pos= info->pos_in_file + (size_t) (info->read_end - info->buffer);
+  size_t copied= 0;
+
+  for (;;)
+  {
+    const ulonglong block_no= pos / BINLOG_DUMP_BLOCK_SIZE;
+    const my_off_t block_start= block_no * BINLOG_DUMP_BLOCK_SIZE;
+    size_t offset= (size_t) (pos - block_start);
+    size_t end= BINLOG_DUMP_BLOCK_SIZE;
+    if (info->end_of_file < block_start + end)
+      end= (size_t) (info->end_of_file > pos ? info->end_of_file - block_start
+                                              : offset);
+    binlog_dump_block *b= NULL;
+
+    if (end > offset &&
+        !(b= binlog_dump_block_get(info->file, file_no, block_no, end)))
+    {
+      info->error= -1;
+      return 1;
+    }
+    if (b && b->length < end)
+      end= MY_MAX(b->length, offset);
+
+    size_t length= MY_MIN(end - offset, Count);
+    if (length)
+      memcpy(Buffer, b->data + offset, length);
+    Buffer+= length;
+    Count-= length;
+    copied+= length;
+    offset+= length;
+    pos+= length;
+
+    /* Either the request was satisfied, or the block was exhausted. */
+    DBUG_ASSERT(!Count || end == offset);
+    /* Refill the buffer with the rest of the block. */
+    size_t fill= MY_MIN(end - offset, info->buffer_length);
+    if (fill)
+      memcpy(info->buffer, b->data + offset, fill);
+    if (b)
+      binlog_dump_block_unpin(b);
+    info->pos_in_file= pos;
+    info->read_pos= info->buffer;
+    info->read_end= info->buffer + fill;
+    if (!Count)
+      return 0;
+    if (end < BINLOG_DUMP_BLOCK_SIZE)
+    {
+      /* End of file */
+      info->error= (int) copied;
+      return 1;
+    }
+  }
+}
+
+
+/**
+  Open a binlog file for a dump thread, reading through the binlog dump
+  cache if it is enabled.
+*/
+static File open_binlog_for_dump(BINLOG_DUMP_IO_CACHE *log,
+                                 const char *log_file_name,
+                                 const char **errmsg)
+{
+  File file= open_binlog(log, log_file_name, errmsg);
+  if (file >= 0 && binlog_dump_cache.inited)
+  {
+    log->file_no= strtoull(fn_ext(log_file_name) + 1, NULL, 10);
+    /* Discard what was read by check_binlog_magic(). */
+    my_off_t pos= my_b_tell(log);
+    log->read_function= binlog_dump_cache_read;
+    log->pos_in_file= pos;
+    log->read_pos= log->read_end= log->buffer;
+  }
+  return file;
+}
+
+
 /**
  * This function sends events from one binlog file
  * but only up until end_pos
@@ -3063,7 +3409,7 @@ void mysql_binlog_send(THD* thd, char* log_ident, my_off_t pos,
   LOG_INFO linfo;
   ulong ev_offset;
 
-  IO_CACHE log;
+  BINLOG_DUMP_IO_CACHE log;
   File file = -1;
   String* const packet= &thd->packet;
 
@@ -3154,7 +3500,7 @@ void mysql_binlog_send(THD* thd, char* log_ident, my_off_t pos,
       goto err;
     }
 
-    if ((file=open_binlog(&log, linfo.log_file_name, &info->errmsg)) < 0)
+    if ((file=open_binlog_for_dump(&log, linfo.log_file_name, &info->errmsg)) < 0)
     {
       info->error= ER_MASTER_FATAL_ERROR_READING_BINLOG;
       goto err;
@@ -58,6 +58,9 @@ struct LOAD_FILE_IO_CACHE : public IO_CACHE
 int log_loaded_block(IO_CACHE* file, uchar *Buffer, size_t Count);
 int init_replication_sys_vars();
 void mysql_binlog_send(THD* thd, char* log_ident, my_off_t pos, ushort flags);
+void binlog_dump_cache_init();
+void binlog_dump_cache_free();
+void binlog_dump_cache_invalidate();
 
 #ifdef HAVE_PSI_INTERFACE
 extern PSI_mutex_key key_LOCK_slave_state, key_LOCK_binlog_state;
@@ -2713,6 +2713,52 @@ JOIN::optimize_inner()
 }
 
 
+/**
+  Tell the storage engine how many rows of a full-text search will be read.
+
+  For
+    SELECT ... FROM t WHERE MATCH(a) AGAINST('x')
+    ORDER BY MATCH(a) AGAINST('x') DESC LIMIT n
+  the rows are read by the full-text search, no other condition can
+  reject them, and they are sorted on the relevance. Only the n best
+  ranked documents can be returned, so that the engine does not have
+  to rank the rest.
+
+  In boolean mode the WHERE condition rejects the documents whose
+  relevance is 0, and query expansion ranks the documents found by
+  another search, so neither gets the hint.
+*/
+
+static void set_ft_limit_hint(JOIN *join)
+{
+  const ha_rows limit= join->unit->lim.get_select_limit();
+
+  if (!limit || limit == HA_POS_ERROR || join->unit->lim.is_with_ties() ||
+      join->unit->is_unit_op() ||
+      join->table_count != 1 || join->const_tables ||
+      join->join_tab->type != JT_FT ||
+      !join->order || join->order->next ||
+      join->order->direction != ORDER::ORDER_DESC ||
+      join->group_list || join->having || join->select_distinct ||
+      join->tmp_table_param.sum_func_count ||
+      join->select_lex->have_window_funcs() ||
+      (join->select_options & OPTION_FOUND_ROWS) ||
+      !join->conds || join->conds->type() != Item::FUNC_ITEM ||
+      ((Item_func*) join->conds)->functype() != Item_func::FT_FUNC)
+    return;
+
+  Item_func_match *match= (Item_func_match*) join->conds;
+  if ((match->match_flags & (FT_BOOL | FT_EXPAND)) ||
+      !(*join->order->item)->real_item()->eq(match, true))
+    return;
+
+  /* The search is initialized by the last one of the equal functions */
+  while (match->master)
+    match= match->master;
+  match->limit_hint= limit;
+}
+
+
 int JOIN::optimize_stage2()
 {
   ulonglong select_opts_for_readinfo;
@@ -3267,8 +3313,12 @@ int JOIN::optimize_stage2()
 
   /* Perform FULLTEXT search before all regular searches */
   if (!(select_options & SELECT_DESCRIBE))
+  {
+    if (select_lex->ftfunc_list->elements)
+      set_ft_limit_hint(this);
     if (init_ftfuncs(thd, select_lex, MY_TEST(order)))
       DBUG_RETURN(1);
+  }
 
   /*
     It's necessary to check const part of HAVING cond as
@@ -29923,6 +29973,7 @@ bool JOIN_TAB::save_explain_data(Explain_table_access *eta,
   tracker= &eta->tracker;
   jbuf_tracker= &eta->jbuf_tracker;
   jbuf_loops_tracker= &eta->jbuf_loops_tracker;
+  jbuf_spill_tracker= &eta->jbuf_spill_tracker;
   jbuf_unpack_tracker= &eta->jbuf_unpack_tracker;
 
   /* Enable the table access time tracker only for "ANALYZE stmt" */
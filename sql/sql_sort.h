@@ -576,6 +576,8 @@ class Sort_param {
 
   uchar *unique_buff;
   bool not_killable;
+  /* Connection that owns a parallel merge pass, see merge_many_buff() */
+  THD *merge_owner;
   String tmp_buffer;
   // The fields below are used only by Unique class.
   qsort2_cmp compare;
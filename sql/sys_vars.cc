@@ -558,6 +558,16 @@ Sys_binlog_file_cache_size(
        CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(IO_SIZE*2, SIZE_T_MAX), DEFAULT(IO_SIZE*4), BLOCK_SIZE(IO_SIZE));
 
+static Sys_var_ulonglong Sys_binlog_dump_cache_size(
+       "binlog_dump_cache_size",
+       "The size of the cache of binary log blocks that is shared by all "
+       "threads that send the binary log to slaves. Each block is read from "
+       "the file once, no matter how many slaves read it. Blocks are 64K; 0 "
+       "disables the cache",
+       READ_ONLY GLOBAL_VAR(opt_binlog_dump_cache_size),
+       CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, SIZE_T_MAX), DEFAULT(0), BLOCK_SIZE(65536));
+
 static Sys_var_on_access_global<Sys_var_ulonglong,
                              PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_STMT_CACHE_SIZE>
 Sys_binlog_stmt_cache_size(
@@ -1534,6 +1544,19 @@ static Sys_var_mybool Sys_local_infile(
        "local_infile", "Enable LOAD DATA LOCAL INFILE",
        GLOBAL_VAR(opt_local_infile), CMD_LINE(OPT_ARG), DEFAULT(TRUE));
 
+static Sys_var_uint Sys_load_data_parser_threads(
+       "load_data_parser_threads",
+       "Number of threads that parse the file of LOAD DATA INFILE, while the "
+       "connection thread inserts the rows that are already parsed. More "
+       "than one thread is only used when the file can be split at line "
+       "terminators: no FIELDS ENCLOSED BY, FIELDS ESCAPED BY '' and no "
+       "LINES STARTING BY. Otherwise one thread parses the whole file. "
+       "0 means that the connection thread parses the file. Not used for "
+       "LOAD DATA LOCAL, LOAD XML, fixed-size rows, named pipes, or when the "
+       "statement is binary logged in statement format",
+       SESSION_VAR(load_data_parser_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 64), DEFAULT(0), BLOCK_SIZE(1));
+
 static Sys_var_ulong Sys_lock_wait_timeout(
        "lock_wait_timeout",
        "Timeout in seconds to wait for a lock before returning an error.",
@@ -1568,6 +1591,40 @@ Sys_log_bin_compress_min_len(
   GLOBAL_VAR(opt_bin_log_compress_min_len),
   CMD_LINE(OPT_ARG), VALID_RANGE(10, 1024), DEFAULT(256), BLOCK_SIZE(1));
 
+static bool check_binlog_transaction_compression(sys_var *self, THD *thd,
+                                                 set_var *var)
+{
+#ifndef HAVE_ZSTD
+  if (var->save_result.ulonglong_value)
+  {
+    my_error(ER_FEATURE_DISABLED, MYF(0), "binlog_transaction_compression",
+             "zstd");
+    return true;
+  }
+#endif
+  return false;
+}
+
+static Sys_var_on_access_global<Sys_var_mybool,
+                            PRIV_SET_SYSTEM_GLOBAL_VAR_LOG_BIN_COMPRESS>
+Sys_binlog_transaction_compression(
+  "binlog_transaction_compression",
+  "Compress all events of a transaction together with zstd, into a single "
+  "Transaction_payload event. Slaves and mariadb-binlog must be of a "
+  "version that can read it. Transactions shorter than "
+  "log_bin_compress_min_len are not compressed",
+  GLOBAL_VAR(opt_binlog_transaction_compression), CMD_LINE(OPT_ARG),
+  DEFAULT(FALSE), NO_MUTEX_GUARD, NOT_IN_BINLOG,
+  ON_CHECK(check_binlog_transaction_compression));
+
+static Sys_var_on_access_global<Sys_var_uint,
+                            PRIV_SET_SYSTEM_GLOBAL_VAR_LOG_BIN_COMPRESS>
+Sys_binlog_transaction_compression_level(
+  "binlog_transaction_compression_level",
+  "The zstd compression level used by binlog_transaction_compression",
+  GLOBAL_VAR(opt_binlog_transaction_compression_level), CMD_LINE(REQUIRED_ARG),
+  VALID_RANGE(1, 22), DEFAULT(3), BLOCK_SIZE(1));
+
 static Sys_var_on_access_global<Sys_var_mybool,
                     PRIV_SET_SYSTEM_GLOBAL_VAR_LOG_BIN_TRUST_FUNCTION_CREATORS>
 Sys_trust_function_creators(
@@ -2412,6 +2469,43 @@ Sys_slave_parallel_max_queued(
        VALID_RANGE(0,2147483647), DEFAULT(131072), BLOCK_SIZE(1));
 
 
+static bool
+check_slave_row_prefetch_threads(sys_var *self, THD *thd, set_var *var)
+{
+  return give_error_if_slave_running(0);
+}
+
+static bool
+fix_slave_row_prefetch_threads(sys_var *self, THD *thd, enum_var_type type)
+{
+  bool err;
+
+  mysql_mutex_unlock(&LOCK_global_system_variables);
+  if (!(err= give_error_if_slave_running(0)) &&
+      (err= global_rpl_prefetch_pool.resize(opt_slave_row_prefetch_threads)))
+  {
+    opt_slave_row_prefetch_threads= global_rpl_prefetch_pool.count;
+    my_error(ER_OUT_OF_RESOURCES, MYF(0));
+  }
+  mysql_mutex_lock(&LOCK_global_system_variables);
+
+  return err;
+}
+
+
+static Sys_var_ulong Sys_slave_row_prefetch_threads(
+       "slave_row_prefetch_threads",
+       "If non-zero, number of threads that read ahead the rows that "
+       "replicated row-based UPDATE and DELETE events are going to modify, "
+       "so that a large transaction applied by a single thread waits less "
+       "for disk reads. Uses at most slave_parallel_max_queued bytes for "
+       "queued rows",
+       GLOBAL_VAR(opt_slave_row_prefetch_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0,256), DEFAULT(0), BLOCK_SIZE(1), NO_MUTEX_GUARD,
+       NOT_IN_BINLOG, ON_CHECK(check_slave_row_prefetch_threads),
+       ON_UPDATE(fix_slave_row_prefetch_threads));
+
+
 bool
 Sys_var_slave_parallel_mode::global_update(THD *thd, set_var *var)
 {
@@ -2491,7 +2585,8 @@ Sys_var_slave_parallel_mode::global_value_ptr(THD *thd,
 
 /* The order here must match enum_slave_parallel_mode in mysqld.h. */
 static const char *slave_parallel_mode_names[] = {
-  "none", "minimal", "conservative", "optimistic", "aggressive", NULL
+  "none", "minimal", "conservative", "optimistic", "aggressive", "writeset",
+  NULL
 };
 export TYPELIB slave_parallel_mode_typelib = {
   array_elements(slave_parallel_mode_names)-1,
@@ -2510,6 +2605,9 @@ Sys_slave_parallel_mode(
        "with rollback and retry. \"conservative\" limits parallelism in an "
        "effort to avoid any conflicts. \"aggressive\" tries to maximise the "
        "parallelism, possibly at the cost of increased conflict rate. "
+       "\"writeset\" is like \"optimistic\", but does not start a "
+       "transaction before prior transactions that modified the same rows "
+       "have committed, as recorded by the master in binlog_writeset_size. "
        "\"minimal\" only parallelizes the commit steps of transactions. "
        "\"none\" disables parallel apply completely.",
        GLOBAL_VAR(opt_slave_parallel_mode), NO_CMD_LINE,
@@ -2615,6 +2713,18 @@ Sys_binlog_commit_wait_usec(
        VALID_RANGE(0, ULONG_MAX), DEFAULT(100000), BLOCK_SIZE(1));
 
 
+static Sys_var_ulong Sys_binlog_writeset_size(
+       "binlog_writeset_size",
+       "If non-zero, the GTID event of a row-based transaction is followed "
+       "by hashes of the primary and unique key values that it modified, "
+       "unless there are more than this many, or the transaction modified "
+       "tables without a primary key or with foreign keys. A slave using "
+       "slave_parallel_mode=writeset uses them to apply non-conflicting "
+       "transactions in parallel.",
+       GLOBAL_VAR(opt_binlog_writeset_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, UINT_MAX16), DEFAULT(0), BLOCK_SIZE(1));
+
+
 static bool fix_max_join_size(sys_var *self, THD *thd, enum_var_type type)
 {
   SV *sv= type == OPT_GLOBAL ? &global_system_variables : &thd->variables;
@@ -2748,6 +2858,14 @@ static Sys_var_ulong Sys_net_buffer_length(
        VALID_RANGE(1024, 1024*1024), DEFAULT(16384), BLOCK_SIZE(1024),
        NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(check_net_buffer_length));
 
+static Sys_var_uint Sys_net_compression_level(
+       "net_compression_level",
+       "zlib compression level of the packets that the server sends with "
+       "the compressed protocol. 1 is the fastest, 9 gives the best "
+       "compression",
+       SESSION_VAR(net_compression_level), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, 9), DEFAULT(6), BLOCK_SIZE(1));
+
 static bool fix_net_read_timeout(sys_var *self, THD *thd, enum_var_type type)
 {
   if (type != OPT_GLOBAL)
@@ -3809,6 +3927,15 @@ static Sys_var_ulonglong Sys_sort_buffer(
        VALID_RANGE(MIN_SORT_MEMORY, SIZE_T_MAX), DEFAULT(MAX_SORT_MEMORY),
        BLOCK_SIZE(1));
 
+static Sys_var_uint Sys_sort_merge_threads(
+       "sort_merge_threads",
+       "Number of threads used for the intermediate merge passes of a "
+       "filesort that does not fit in sort_buffer_size. The sort buffer is "
+       "divided between the threads, so no extra sort memory is used. "
+       "1 means that all merging is done by the connection thread",
+       SESSION_VAR(sort_merge_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, 64), DEFAULT(1), BLOCK_SIZE(1));
+
 export sql_mode_t expand_sql_mode(sql_mode_t sql_mode)
 {
   if (sql_mode & MODE_ANSI)
@@ -6772,6 +6899,15 @@ static Sys_var_mybool Sys_replicate_annotate_row_events(
        CMD_LINE(OPT_ARG), DEFAULT(TRUE));
 #endif
 
+static Sys_var_uint Sys_join_buffer_spill_partitions(
+       "join_buffer_spill_partitions",
+       "Maximum number of partitions into which a hashed join buffer that "
+       "does not fit in join_buffer_size is spilled to temporary files, so "
+       "that the joined table is scanned once rather than once per refill "
+       "of the buffer. 0 disables spilling",
+       SESSION_VAR(join_buff_spill_partitions), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 128), DEFAULT(0), BLOCK_SIZE(1));
+
 static Sys_var_ulonglong Sys_join_buffer_space_limit(
        "join_buffer_space_limit",
        "The limit of the space for all join buffers used by a query",
@@ -29,6 +29,11 @@
 #include <sql_plist.h>
 #include <threadpool.h>
 #include <algorithm>
+#ifdef HAVE_THREADPOOL_URING
+#include <mutex>
+#include <poll.h>
+#include <sys/syscall.h>
+#endif
 #ifdef _WIN32
 #include "threadpool_winsockets.h"
 #define OPTIONAL_IO_POLL_READ_PARAM this
@@ -36,6 +41,7 @@
 #define OPTIONAL_IO_POLL_READ_PARAM 0
 #endif
 
+#ifndef HAVE_THREADPOOL_URING
 static void io_poll_close(TP_file_handle fd)
 {
 #ifdef _WIN32
@@ -44,6 +50,7 @@ static void io_poll_close(TP_file_handle fd)
   close(fd);
 #endif
 }
+#endif
 
 /** Maximum number of native events a listener can read in one go */
 #define MAX_EVENTS 1024
@@ -168,9 +175,233 @@ static void print_pool_blocked_message(bool);
  native_event_get_userdata() function.
 
  On Linux: epoll_wait()
+
+ Linux builds with WITH_THREADPOOL_URING use io_uring instead of epoll,
+ see below.
+*/
+
+#if defined (__linux__) && defined(HAVE_THREADPOOL_URING)
+/*
+  io_uring flavour of the Linux implementation.
+
+  Sockets are watched with one-shot IORING_OP_POLL_ADD requests, which have
+  the same semantics as EPOLLONESHOT: the request completes once, and is
+  re-armed with io_poll_start_read() after the command was handled. A
+  completed request does not refer to the socket anymore, and connections
+  only change group or close while they are being handled, so there is
+  nothing to cancel in io_poll_disassociate_fd().
+
+  The gain over epoll is on the completion side. Completions are read from
+  the completion ring shared with the kernel, so the non-blocking poll done
+  by a worker before it goes to sleep costs no system call, and a listener
+  reaps a whole batch of completions per wakeup.
+
+  Submissions are batched as well. io_poll_start_read() only queues the
+  request, and the next io_poll_wait() submits everything queued so far
+  with one system call. A queued request is no later than a submitted one
+  whose completion nobody reaps yet: until some thread polls the ring,
+  neither would be noticed. Only when the listener is already blocked in
+  the kernel, the request is submitted right away.
+
+  liburing rings are single producer, single consumer. The submission and
+  completion sides are protected by separate mutexes, which are never held
+  while waiting. The listener waits with io_uring_enter() and takes the
+  completion mutex only to peek at the ring and to advance it. Workers only
+  try to lock it, and find nothing if they fail, as the thread holding it
+  picks the events up.
+
+  TP_file_handle of the poll descriptor is an index in tp_urings[].
+*/
+
+/* Requests queued between two polls; a full queue is submitted at once */
+#define TP_URING_SQ_ENTRIES 256
+/*
+  There is one pending completion per idle connection at most. The
+  completion queue may overflow, the kernel then keeps the completions
+  until there is space (IORING_FEAT_NODROP).
 */
+#define TP_URING_CQ_ENTRIES 4096
 
-#if defined (__linux__)
+struct tp_uring_t
+{
+  struct io_uring ring;
+  std::mutex sq_mutex;
+  std::mutex cq_mutex;
+  /* Whether the listener waits in the kernel, protected by sq_mutex */
+  bool waiting;
+};
+
+static tp_uring_t *tp_urings;
+static uint tp_uring_count;
+
+static int tp_uring_init(uint n)
+{
+  tp_urings= new (std::nothrow) tp_uring_t[n];
+  tp_uring_count= 0;
+  return tp_urings ? 0 : -1;
+}
+
+static void tp_uring_end()
+{
+  delete[] tp_urings;
+  tp_urings= NULL;
+}
+
+static TP_file_handle io_poll_create()
+{
+  struct io_uring_params params;
+  int ret;
+
+  if (tp_uring_count >= threadpool_max_size)
+  {
+    errno= EMFILE;
+    return INVALID_HANDLE_VALUE;
+  }
+  memset(&params, 0, sizeof(params));
+  params.flags= IORING_SETUP_CQSIZE;
+  params.cq_entries= TP_URING_CQ_ENTRIES;
+  ret= io_uring_queue_init_params(TP_URING_SQ_ENTRIES,
+                                  &tp_urings[tp_uring_count].ring, &params);
+  if (ret < 0)
+  {
+    errno= -ret;
+    return INVALID_HANDLE_VALUE;
+  }
+  if (!(params.features & IORING_FEAT_NODROP))
+  {
+    /* Lost completions would leave connections hanging forever */
+    io_uring_queue_exit(&tp_urings[tp_uring_count].ring);
+    errno= ENOTSUP;
+    return INVALID_HANDLE_VALUE;
+  }
+  tp_urings[tp_uring_count].waiting= false;
+  return (TP_file_handle) tp_uring_count++;
+}
+
+
+static void io_poll_close(TP_file_handle pollfd)
+{
+  io_uring_queue_exit(&tp_urings[pollfd].ring);
+}
+
+
+/* Submit the queued requests. The caller holds sq_mutex. */
+static int tp_uring_submit(tp_uring_t *uring)
+{
+  int ret;
+  do
+  {
+    ret= io_uring_submit(&uring->ring);
+  }
+  while (ret == -EINTR);
+  if (ret < 0)
+  {
+    errno= -ret;
+    return -1;
+  }
+  return 0;
+}
+
+
+int io_poll_start_read(TP_file_handle pollfd, TP_file_handle fd, void *data, void *)
+{
+  tp_uring_t *uring= &tp_urings[pollfd];
+  std::lock_guard<std::mutex> lock(uring->sq_mutex);
+  struct io_uring_sqe *sqe= io_uring_get_sqe(&uring->ring);
+
+  if (!sqe)
+  {
+    if (tp_uring_submit(uring))
+      return -1;
+    sqe= io_uring_get_sqe(&uring->ring);
+    if (!sqe)
+    {
+      errno= EBUSY;
+      return -1;
+    }
+  }
+  io_uring_prep_poll_add(sqe, fd, POLLIN|POLLRDHUP);
+  io_uring_sqe_set_data(sqe, data);
+  /* Otherwise, the next io_poll_wait() submits the request */
+  return uring->waiting ? tp_uring_submit(uring) : 0;
+}
+
+
+int io_poll_associate_fd(TP_file_handle pollfd, TP_file_handle fd, void *data, void*)
+{
+  return io_poll_start_read(pollfd, fd, data, 0);
+}
+
+
+int io_poll_disassociate_fd(TP_file_handle, TP_file_handle)
+{
+  return 0;
+}
+
+
+/*
+  Reap completions. Only infinite and zero timeouts are used. With the
+  infinite one, the caller is the listener: it blocks in the kernel without
+  holding any mutex, and the completions it waited for can be taken by a
+  worker in the meantime, so it peeks again after every wakeup.
+*/
+int io_poll_wait(TP_file_handle pollfd, native_event *native_events, int maxevents,
+                 int timeout_ms)
+{
+  tp_uring_t *uring= &tp_urings[pollfd];
+  struct io_uring_cqe *cqes[MAX_EVENTS];
+  unsigned cnt;
+
+  DBUG_ASSERT(timeout_ms == -1 || timeout_ms == 0);
+  DBUG_ASSERT(maxevents <= MAX_EVENTS);
+
+  for (;;)
+  {
+    {
+      std::lock_guard<std::mutex> lock(uring->sq_mutex);
+      if (tp_uring_submit(uring))
+        return -1;
+    }
+
+    if (timeout_ms)
+      uring->cq_mutex.lock();
+    else if (!uring->cq_mutex.try_lock())
+      return 0;
+    cnt= io_uring_peek_batch_cqe(&uring->ring, cqes, maxevents);
+    for (unsigned i= 0; i < cnt; i++)
+      native_events[i]= *cqes[i];
+    io_uring_cq_advance(&uring->ring, cnt);
+    uring->cq_mutex.unlock();
+    if (cnt || !timeout_ms)
+      return (int) cnt;
+
+    /*
+      Requests queued from now on are submitted by their threads, the
+      ones queued before are submitted here.
+    */
+    uring->sq_mutex.lock();
+    uring->waiting= true;
+    int ret= tp_uring_submit(uring);
+    uring->sq_mutex.unlock();
+    if (!ret &&
+        syscall(__NR_io_uring_enter, uring->ring.ring_fd, 0, 1,
+                IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR)
+      ret= -1;
+    uring->sq_mutex.lock();
+    uring->waiting= false;
+    uring->sq_mutex.unlock();
+    if (ret)
+      return -1;
+  }
+}
+
+
+static void *native_event_get_userdata(native_event *event)
+{
+  return io_uring_cqe_get_data(event);
+}
+
+#elif defined (__linux__)
 #ifndef EPOLLRDHUP
 /* Early 2.6 kernel did not have EPOLLRDHUP */
 #define EPOLLRDHUP 0
@@ -1017,6 +1248,9 @@ void thread_group_destroy(thread_group_t *thread_group)
   {
     my_free(all_groups);
     all_groups= 0;
+#ifdef HAVE_THREADPOOL_URING
+    tp_uring_end();
+#endif
   }
 }
 
@@ -1589,6 +1823,16 @@ int TP_pool_generic::init()
     sql_print_error("Allocation failed");
     DBUG_RETURN(-1);
   }
+#ifdef HAVE_THREADPOOL_URING
+  if (tp_uring_init(threadpool_max_size))
+  {
+    my_free(all_groups);
+    all_groups= 0;
+    threadpool_max_size= 0;
+    sql_print_error("Allocation failed");
+    DBUG_RETURN(-1);
+  }
+#endif
   PSI_register(mutex);
   PSI_register(cond);
   PSI_register(thread);
@@ -36,7 +36,10 @@ typedef int TP_file_handle;
 #define  INVALID_HANDLE_VALUE -1
 #endif
 
-#ifdef __linux__
+#if defined(__linux__) && defined(HAVE_THREADPOOL_URING)
+#include <liburing.h>
+typedef struct io_uring_cqe native_event;
+#elif defined(__linux__)
 #include <sys/epoll.h>
 typedef struct epoll_event native_event;
 #elif defined(HAVE_KQUEUE)
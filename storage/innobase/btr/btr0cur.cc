@@ -1804,6 +1804,80 @@ dberr_t btr_cur_search_to_nth_level(ulint level,
   goto search_loop;
 }
 
+uint32_t btr_cur_leaf_page_no_hint(const dict_index_t &index,
+                                   const dtuple_t &tuple)
+{
+  ut_ad(index.is_btree());
+  ut_ad(dtuple_check_typed(&tuple));
+
+  const fil_space_t *space= index.table->space;
+  if (!space || index.page == FIL_NULL)
+    return FIL_NULL;
+
+  const ulint zip_size= space->zip_size();
+  mem_heap_t *heap= nullptr;
+  rec_offs offsets_[REC_OFFS_NORMAL_SIZE];
+  rec_offs *offsets= offsets_;
+  rec_offs_init(offsets_);
+
+  page_cur_t page_cur;
+  page_cur.index= const_cast<dict_index_t*>(&index);
+  uint32_t page_no= index.page;
+  uint32_t height= ULINT32_UNDEFINED;
+  mtr_t mtr;
+  mtr.start();
+
+  for (;;)
+  {
+    /* Each node pointer page is released before its child is looked
+    up. The child may have been freed or reused by then; such pages
+    are rejected by the checks below, and anything else merely yields
+    a useless prefetch. */
+    buf_block_t *block=
+      buf_page_get_gen(page_id_t{index.table->space_id, page_no}, zip_size,
+                       RW_S_LATCH, nullptr, BUF_GET_IF_IN_POOL, &mtr);
+    if (!block)
+    {
+    not_found:
+      page_no= FIL_NULL;
+      break;
+    }
+
+    const page_t *page= block->page.frame;
+    if (!!page_is_comp(page) != index.table->not_redundant() ||
+        btr_page_get_index_id(page) != index.id ||
+        !fil_page_index_page_check(page))
+      goto not_found;
+
+    const uint32_t level= btr_page_get_level(page);
+    if (height != ULINT32_UNDEFINED && level + 1 != height)
+      goto not_found;
+    height= level;
+    if (!level)
+      /* The root page is a leaf page. */
+      break;
+
+    page_cur.block= block;
+    ulint up_match= 0, low_match= 0;
+    if (page_cur_search_with_match(&tuple, PAGE_CUR_LE, &up_match, &low_match,
+                                   &page_cur, nullptr) ||
+        !page_rec_is_user_rec(page_cur.rec))
+      goto not_found;
+
+    offsets= rec_get_offsets(page_cur.rec, page_cur.index, offsets, 0,
+                             ULINT_UNDEFINED, &heap);
+    page_no= btr_node_ptr_get_child_page_no(page_cur.rec, offsets);
+    mtr.release_last_page();
+    if (level == 1)
+      break;
+  }
+
+  mtr.commit();
+  if (UNIV_LIKELY_NULL(heap))
+    mem_heap_free(heap);
+  return page_no;
+}
+
 dberr_t btr_cur_t::open_leaf(bool first, dict_index_t *index,
                              btr_latch_mode latch_mode, mtr_t *mtr)
 {
@@ -190,7 +190,19 @@ static void btr_search_disable_ref_count(dict_table_t *table)
 {
   for (dict_index_t *index= dict_table_get_first_index(table); index;
        index= dict_table_get_next_index(index))
+  {
     index->search_info->ref_count= 0;
+    index->search_info->n_nodes= 0;
+  }
+}
+
+/** Account for removed hash table nodes of an index.
+@param info       search info of the index
+@param n_removed  number of removed nodes */
+static void btr_search_nodes_removed(btr_search_t *info, ulint n_removed)
+{
+  ut_ad(info->n_nodes >= n_removed);
+  info->n_nodes-= n_removed;
 }
 
 /** Lazily free detached metadata when removing the last reference. */
@@ -455,16 +467,18 @@ __attribute__((nonnull))
 /**
 Insert an entry into the hash table. If an entry with the same fold number
 is found, its node is updated to point to the new data, and no new node
-is inserted.
+is inserted. The node may have been owned by another index in the same
+partition; it is then accounted to the index of the new data.
 @param table hash table
 @param heap  memory heap
+@param info  search info of the index, for accounting the nodes
 @param fold  folded value of the record
 @param block buffer block containing the record
 @param data  the record
 @retval true on success
 @retval false if no more memory could be allocated */
 static bool ha_insert_for_fold(hash_table_t *table, mem_heap_t* heap,
-                               ulint fold,
+                               btr_search_t *info, ulint fold,
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
                                buf_block_t *block, /*!< buffer block of data */
 #endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
@@ -482,6 +496,17 @@ static bool ha_insert_for_fold(hash_table_t *table, mem_heap_t* heap,
   {
     if (prev->fold == fold)
     {
+      /* The caller holds the partition latch in exclusive mode, which
+      prevents the block of prev->data from losing its hash index. */
+      const dict_index_t *prev_index=
+        buf_pool.block_from_ahi(prev->data)->index;
+      ut_ad(prev_index);
+      if (prev_index->search_info != info)
+      {
+        ut_ad(prev_index->search_info->n_nodes);
+        prev_index->search_info->n_nodes--;
+        info->n_nodes++;
+      }
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
       buf_block_t *prev_block= prev->block;
       ut_a(prev_block->page.frame == page_align(prev->data));
@@ -509,6 +534,7 @@ static bool ha_insert_for_fold(hash_table_t *table, mem_heap_t* heap,
 
   node->fold= fold;
   node->next= nullptr;
+  info->n_nodes++;
 
   ha_node_t *prev= static_cast<ha_node_t*>(cell->node);
   if (!prev)
@@ -573,15 +599,19 @@ __attribute__((nonnull))
 /** Delete all pointers to a page.
 @param table     hash table
 @param heap      memory heap
-@param page      record to be deleted */
-static void ha_remove_all_nodes_to_page(hash_table_t *table, mem_heap_t *heap,
-                                        ulint fold, const page_t *page)
+@param page      record to be deleted
+@return number of deleted nodes */
+static ulint ha_remove_all_nodes_to_page(hash_table_t *table, mem_heap_t *heap,
+                                         ulint fold, const page_t *page)
 {
+  ulint n_removed= 0;
+
   for (ha_node_t *node= ha_chain_get_first(table, fold); node; )
   {
     if (page_align(ha_node_get_data(node)) == page)
     {
       ha_delete_hash_node(table, heap, node);
+      n_removed++;
       /* The deletion may compact the heap of nodes and move other nodes! */
       node= ha_chain_get_first(table, fold);
     }
@@ -594,6 +624,7 @@ static void ha_remove_all_nodes_to_page(hash_table_t *table, mem_heap_t *heap,
        node= ha_chain_get_next(node))
     ut_ad(page_align(ha_node_get_data(node)) != page);
 #endif /* UNIV_DEBUG */
+  return n_removed;
 }
 
 /** Delete a record if found.
@@ -655,7 +686,7 @@ static bool ha_search_and_update_if_found(hash_table_t *table, ulint fold,
 
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
 #else
-# define ha_insert_for_fold(t,h,f,b,d) ha_insert_for_fold(t,h,f,d)
+# define ha_insert_for_fold(t,h,i,f,b,d) ha_insert_for_fold(t,h,i,f,d)
 # define ha_search_and_update_if_found(table,fold,data,new_block,new_data) \
 	ha_search_and_update_if_found(table,fold,data,new_data)
 #endif
@@ -728,7 +759,8 @@ btr_search_update_hash_ref(
 			mem_heap_free(heap);
 		}
 
-		ha_insert_for_fold(&part->table, part->heap, fold, block, rec);
+		ha_insert_for_fold(&part->table, part->heap,
+				   index->search_info, fold, block, rec);
 
 		MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
 	}
@@ -1355,9 +1387,13 @@ void btr_search_drop_page_hash_index(buf_block_t* block,
 		goto retry;
 	}
 
-	for (ulint i = 0; i < n_cached; i++) {
-		ha_remove_all_nodes_to_page(&part->table, part->heap,
-					    folds[i], page);
+	{
+		ulint n_removed = 0;
+		for (ulint i = 0; i < n_cached; i++) {
+			n_removed += ha_remove_all_nodes_to_page(
+				&part->table, part->heap, folds[i], page);
+		}
+		btr_search_nodes_removed(index->search_info, n_removed);
 	}
 
 	switch (index->search_info->ref_count--) {
@@ -1602,6 +1638,7 @@ btr_search_build_page_hash_index(
 		auto part = btr_search_sys.get_part(*index);
 		for (ulint i = 0; i < n_cached; i++) {
 			ha_insert_for_fold(&part->table, part->heap,
+					   index->search_info,
 					   folds[i], block, recs[i]);
 		}
 	}
@@ -1799,6 +1836,7 @@ void btr_search_update_hash_on_delete(btr_cur_t *cursor)
 
 		if (ha_search_and_delete_if_found(&part->table, part->heap,
 						  fold, rec)) {
+			btr_search_nodes_removed(index->search_info, 1);
 			MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_REMOVED);
 		} else {
 			MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_REMOVE_NOT_FOUND);
@@ -1985,6 +2023,7 @@ void btr_search_update_hash_on_insert(btr_cur_t *cursor,
 
 			part = btr_search_sys.get_part(*index);
 			ha_insert_for_fold(&part->table, part->heap,
+					   index->search_info,
 					   ins_fold, block, ins_rec);
 			MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
 		}
@@ -2007,9 +2046,11 @@ void btr_search_update_hash_on_insert(btr_cur_t *cursor,
 
 		if (!left_side) {
 			ha_insert_for_fold(&part->table, part->heap,
+					   index->search_info,
 					   fold, block, rec);
 		} else {
 			ha_insert_for_fold(&part->table, part->heap,
+					   index->search_info,
 					   ins_fold, block, ins_rec);
 		}
 		MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
@@ -2031,6 +2072,7 @@ void btr_search_update_hash_on_insert(btr_cur_t *cursor,
 			}
 
 			ha_insert_for_fold(&part->table, part->heap,
+					   index->search_info,
 					   ins_fold, block, ins_rec);
 			MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
 		}
@@ -2052,9 +2094,11 @@ void btr_search_update_hash_on_insert(btr_cur_t *cursor,
 
 		if (!left_side) {
 			ha_insert_for_fold(&part->table, part->heap,
+					   index->search_info,
 					   ins_fold, block, ins_rec);
 		} else {
 			ha_insert_for_fold(&part->table, part->heap,
+					   index->search_info,
 					   next_fold, block, next_rec);
 		}
 		MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
@@ -2069,6 +2113,28 @@ void btr_search_update_hash_on_insert(btr_cur_t *cursor,
 	}
 }
 
+/** Report the adaptive hash index usage of an index.
+@param index  index tree
+@param pages  number of leaf pages that are pointed to by the hash index
+@param nodes  number of hash table nodes that point to the index
+@return memory used by the hash table nodes, in bytes */
+ulint btr_search_index_usage(const dict_index_t &index,
+                             ulint &pages, ulint &nodes)
+{
+  pages= nodes= 0;
+  if (!btr_search_enabled)
+    return 0;
+  auto part= btr_search_sys.get_part(index);
+  part->latch.rd_lock(SRW_LOCK_CALL);
+  if (btr_search_enabled)
+  {
+    pages= index.search_info->ref_count;
+    nodes= index.search_info->n_nodes;
+  }
+  part->latch.rd_unlock();
+  return nodes * sizeof(ha_node_t);
+}
+
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
 __attribute__((nonnull))
 /** @return whether a range of the cells is valid */
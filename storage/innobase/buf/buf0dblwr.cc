@@ -54,6 +54,10 @@ void buf_dblwr_t::init()
     mysql_mutex_init(buf_dblwr_mutex_key, &mutex, nullptr);
     pthread_cond_init(&cond, nullptr);
     block_size= FSP_EXTENT_SIZE;
+    n_shards= shards
+      ? 1U << my_bit_log2_uint32(std::min<uint32_t>(shards, MAX_SHARDS))
+      : 1;
+    shard_size= 2 * block_size / n_shards;
   }
 }
 
@@ -63,18 +67,19 @@ inline void buf_dblwr_t::init(const byte *header)
 {
   ut_ad(!active_slot->first_free);
   ut_ad(!active_slot->reserved);
-  ut_ad(!batch_running);
+  ut_ad(!batches_running);
 
   block1= page_id_t(0, mach_read_from_4(header + TRX_SYS_DOUBLEWRITE_BLOCK1));
   block2= page_id_t(0, mach_read_from_4(header + TRX_SYS_DOUBLEWRITE_BLOCK2));
 
-  const uint32_t buf_size= 2 * block_size;
-  for (int i= 0; i < 2; i++)
+  for (uint32_t i= 0; i <= n_shards; i++)
   {
+    /* init_or_load_pages() reads both blocks to slots[0].write_buf */
+    const uint32_t buf_size= i ? shard_size : 2 * block_size;
     slots[i].write_buf= static_cast<byte*>
       (aligned_malloc(buf_size << srv_page_size_shift, srv_page_size));
     slots[i].buf_block_arr= static_cast<element*>
-      (ut_zalloc_nokey(buf_size * sizeof(element)));
+      (ut_zalloc_nokey(shard_size * sizeof(element)));
   }
   active_slot= &slots[0];
 }
@@ -468,10 +473,10 @@ void buf_dblwr_t::close()
 
   ut_ad(!active_slot->reserved);
   ut_ad(!active_slot->first_free);
-  ut_ad(!batch_running);
+  ut_ad(!batches_running);
 
   pthread_cond_destroy(&cond);
-  for (int i= 0; i < 2; i++)
+  for (uint32_t i= 0; i <= n_shards; i++)
   {
     aligned_free(slots[i].write_buf);
     ut_free(slots[i].buf_block_arr);
@@ -481,8 +486,40 @@ void buf_dblwr_t::close()
   memset((void*) this, 0, sizeof *this);
 }
 
-/** Update the doublewrite buffer on write completion. */
-void buf_dblwr_t::write_completed()
+inline buf_dblwr_t::slot *buf_dblwr_t::find_batch(const buf_page_t *bpage)
+{
+  mysql_mutex_assert_owner(&mutex);
+  slot *found= nullptr;
+  element *e= nullptr;
+
+  /* The same page may be waited for by several batches, if it was
+  written again before write_completed() was invoked. Pick the oldest. */
+  for (uint32_t i= 0; i <= n_shards; i++)
+  {
+    slot &s= slots[i];
+    if (!s.batch || s.flushing_buffered_writes ||
+        (found && found->batch < s.batch))
+      continue;
+    for (ulint j= 0; j < s.first_free; j++)
+    {
+      if (!s.buf_block_arr[j].written &&
+          s.buf_block_arr[j].request.bpage == bpage)
+      {
+        found= &s;
+        e= &s.buf_block_arr[j];
+        break;
+      }
+    }
+  }
+
+  ut_a(found);
+  e->written= true;
+  return found;
+}
+
+/** Update the doublewrite buffer on write completion.
+@param bpage  the page that was written */
+void buf_dblwr_t::write_completed(const buf_page_t *bpage)
 {
   ut_ad(this == &buf_dblwr);
   ut_ad(!srv_read_only_mode);
@@ -490,8 +527,8 @@ void buf_dblwr_t::write_completed()
   mysql_mutex_lock(&mutex);
 
   ut_ad(is_created());
-  ut_ad(batch_running);
-  slot *flush_slot= active_slot == &slots[0] ? &slots[1] : &slots[0];
+  ut_ad(batches_running);
+  slot *flush_slot= find_batch(bpage);
   ut_ad(flush_slot->reserved);
   ut_ad(flush_slot->reserved <= flush_slot->first_free);
 
@@ -502,9 +539,11 @@ void buf_dblwr_t::write_completed()
     fil_flush_file_spaces();
     mysql_mutex_lock(&mutex);
 
-    /* We can now reuse the doublewrite memory buffer: */
+    /* We can now reuse the doublewrite memory buffer and the shard: */
     flush_slot->first_free= 0;
-    batch_running= false;
+    flush_slot->batch= 0;
+    shards_running&= ~(1U << flush_slot->shard);
+    batches_running--;
     pthread_cond_broadcast(&cond);
   }
 
@@ -572,34 +611,48 @@ static void buf_dblwr_check_block(const buf_page_t *bpage)
 }
 #endif /* UNIV_DEBUG */
 
-bool buf_dblwr_t::flush_buffered_writes(const ulint size)
+bool buf_dblwr_t::flush_buffered_writes_low()
 {
   mysql_mutex_assert_owner(&mutex);
-  ut_ad(size == block_size);
 
   for (;;)
   {
     if (!active_slot->first_free)
       return false;
-    if (!batch_running)
+    if (batches_running < n_shards)
       break;
     my_cond_wait(&cond, &mutex.m_mutex);
   }
 
   ut_ad(active_slot->reserved == active_slot->first_free);
-  ut_ad(!flushing_buffered_writes);
+  ut_ad(!active_slot->batch);
 
-  /* Disallow anyone else to start another batch of flushing. */
   slot *flush_slot= active_slot;
-  /* Switch the active slot */
-  active_slot= active_slot == &slots[0] ? &slots[1] : &slots[0];
+  /* Switch the active slot to one whose batch is not running. There are
+  n_shards + 1 slots, and at most n_shards batches are running. */
+  for (active_slot= &slots[0];
+       active_slot->batch || active_slot == flush_slot; active_slot++)
+    ut_ad(active_slot < &slots[n_shards]);
   ut_a(active_slot->first_free == 0);
-  batch_running= true;
+  batches_running++;
+  flush_slot->batch= ++batches_started;
+  /* Write the batch to a shard that no other batch is using */
+  for (flush_slot->shard= 0; shards_running & 1U << flush_slot->shard;
+       flush_slot->shard++)
+    ut_ad(flush_slot->shard < n_shards);
+  shards_running|= 1U << flush_slot->shard;
   const ulint old_first_free= flush_slot->first_free;
   auto write_buf= flush_slot->write_buf;
-  const bool multi_batch= block1 + static_cast<uint32_t>(size) != block2 &&
-    old_first_free > size;
-  flushing_buffered_writes= 1 + multi_batch;
+  /* The shard starts at this page of block1 followed by block2 */
+  const uint32_t start= flush_slot->shard * shard_size;
+  const ulint size= start < block_size ? block_size - start : 0;
+  const bool multi_batch= block1 + block_size != block2 &&
+    size && old_first_free > size;
+  const uint32_t first_page_no= start < block_size ||
+    block1 + block_size == block2
+    ? block1.page_no() + start
+    : block2.page_no() + (start - block_size);
+  flush_slot->flushing_buffered_writes= 1 + multi_batch;
   /* Now safe to release the mutex. */
   mysql_mutex_unlock(&mutex);
 #ifdef UNIV_DEBUG
@@ -617,14 +670,17 @@ bool buf_dblwr_t::flush_buffered_writes(const ulint size)
     ut_d(buf_dblwr_check_page_lsn(*bpage, write_buf + len2));
   }
 #endif /* UNIV_DEBUG */
-  const IORequest request{nullptr, nullptr, fil_system.sys_space->chain.start,
+  /* The first page identifies the batch in
+  flush_buffered_writes_completed() */
+  const IORequest request{flush_slot->buf_block_arr[0].request.bpage, nullptr,
+                          fil_system.sys_space->chain.start,
                           IORequest::DBLWR_BATCH};
   ut_a(fil_system.sys_space->acquire());
   if (multi_batch)
   {
     fil_system.sys_space->reacquire();
     os_aio(request, write_buf,
-           os_offset_t{block1.page_no()} << srv_page_size_shift,
+           os_offset_t{first_page_no} << srv_page_size_shift,
            size << srv_page_size_shift);
     os_aio(request, write_buf + (size << srv_page_size_shift),
            os_offset_t{block2.page_no()} << srv_page_size_shift,
@@ -632,7 +688,7 @@ bool buf_dblwr_t::flush_buffered_writes(const ulint size)
   }
   else
     os_aio(request, write_buf,
-           os_offset_t{block1.page_no()} << srv_page_size_shift,
+           os_offset_t{first_page_no} << srv_page_size_shift,
            old_first_free << srv_page_size_shift);
   return true;
 }
@@ -650,21 +706,32 @@ void buf_dblwr_t::flush_buffered_writes_completed(const IORequest &request)
   ut_ad(this == &buf_dblwr);
   ut_ad(is_created());
   ut_ad(!srv_read_only_mode);
-  ut_ad(!request.bpage);
+  ut_ad(request.bpage);
   ut_ad(request.node == fil_system.sys_space->chain.start);
   ut_ad(request.type == IORequest::DBLWR_BATCH);
   mysql_mutex_lock(&mutex);
-  ut_ad(batch_running);
-  ut_ad(flushing_buffered_writes);
-  ut_ad(flushing_buffered_writes <= 2);
+  ut_ad(batches_running);
   writes_completed++;
-  if (UNIV_UNLIKELY(--flushing_buffered_writes))
+
+  /* The pages of a batch are write-fixed until the batch has been
+  written to the doublewrite buffer, so the first page is unique among
+  such batches. */
+  slot *flush_slot= &slots[0];
+  while (!flush_slot->flushing_buffered_writes ||
+         flush_slot->buf_block_arr[0].request.bpage != request.bpage)
+  {
+    flush_slot++;
+    ut_a(flush_slot <= &slots[n_shards]);
+  }
+
+  ut_ad(flush_slot->batch);
+  ut_ad(flush_slot->flushing_buffered_writes <= 2);
+  if (UNIV_UNLIKELY(--flush_slot->flushing_buffered_writes))
   {
     mysql_mutex_unlock(&mutex);
     return;
   }
 
-  slot *const flush_slot= active_slot == &slots[0] ? &slots[1] : &slots[0];
   ut_ad(flush_slot->reserved == flush_slot->first_free);
   /* increment the doublewrite flushed pages counter */
   pages_written+= flush_slot->first_free;
@@ -731,7 +798,7 @@ void buf_dblwr_t::flush_buffered_writes()
 
   ut_ad(!srv_read_only_mode);
 
-  if (!flush_buffered_writes(block_size))
+  if (!flush_buffered_writes_low())
     mysql_mutex_unlock(&mutex);
 }
 
@@ -749,17 +816,15 @@ void buf_dblwr_t::add_to_batch(const IORequest &request, size_t size)
   ut_ad(request.node->space->referenced());
   ut_ad(!srv_read_only_mode);
 
-  const ulint buf_size= 2 * block_size;
-
   mysql_mutex_lock(&mutex);
 
   for (;;)
   {
-    ut_ad(active_slot->first_free <= buf_size);
-    if (active_slot->first_free != buf_size)
+    ut_ad(active_slot->first_free <= shard_size);
+    if (active_slot->first_free != shard_size)
       break;
 
-    if (flush_buffered_writes(buf_size / 2))
+    if (flush_buffered_writes_low())
       mysql_mutex_lock(&mutex);
   }
 
@@ -776,12 +841,11 @@ void buf_dblwr_t::add_to_batch(const IORequest &request, size_t size)
   non-pointer parameters that are passed to the _aligned templates. */
   ut_ad(!request.bpage->zip_size() || request.bpage->zip_size() == size);
   ut_ad(active_slot->reserved == active_slot->first_free);
-  ut_ad(active_slot->reserved < buf_size);
+  ut_ad(active_slot->reserved < shard_size);
   new (active_slot->buf_block_arr + active_slot->first_free++)
-    element{request.doublewritten(), size};
+    element{request.doublewritten(), size, false};
   active_slot->reserved= active_slot->first_free;
 
-  if (active_slot->first_free != buf_size ||
-      !flush_buffered_writes(buf_size / 2))
+  if (active_slot->first_free != shard_size || !flush_buffered_writes_low())
     mysql_mutex_unlock(&mutex);
 }
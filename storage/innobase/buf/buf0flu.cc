@@ -34,6 +34,7 @@ Created 11/11/1995 Heikki Tuuri
 #include "buf0buf.h"
 #include "buf0checksum.h"
 #include "buf0dblwr.h"
+#include "buf0track.h"
 #include "srv0start.h"
 #include "page0zip.h"
 #include "fil0fil.h"
@@ -354,7 +355,7 @@ void buf_page_write_complete(const IORequest &request, bool error)
     {
       ut_ad(state < buf_page_t::WRITE_FIX_REINIT);
       ut_ad(persistent);
-      buf_dblwr.write_completed();
+      buf_dblwr.write_completed(bpage);
     }
   }
 }
@@ -774,6 +775,9 @@ bool buf_page_t::flush(fil_space_t *space)
 
   /* Increment the I/O operation count used for selecting LRU policy. */
   buf_LRU_stat_inc_io();
+  if (UNIV_UNLIKELY(buf_track.is_enabled()) &&
+      space->purpose == FIL_TYPE_TABLESPACE)
+    buf_track.add(id());
   mysql_mutex_unlock(&buf_pool.mutex);
 
   IORequest::Type type= IORequest::WRITE_ASYNC;
@@ -1949,6 +1953,9 @@ static bool log_checkpoint_low(lsn_t oldest_lsn, lsn_t end_lsn)
   ut_ad(flush_lsn >= end_lsn + SIZE_OF_FILE_CHECKPOINT);
   log_sys.latch.wr_unlock();
   log_write_up_to(flush_lsn, true);
+  /* The pages that were written before the checkpoint must be durably
+  recorded before the checkpoint header is written. */
+  buf_track.write();
   log_sys.latch.wr_lock(SRW_LOCK_CALL);
   if (log_sys.last_checkpoint_lsn >= oldest_lsn)
     goto do_nothing;
@@ -398,6 +398,88 @@ ulint buf_read_ahead_random(const page_id_t page_id, ulint zip_size)
   return count;
 }
 
+/** Issue asynchronous reads of pages that the caller is about to access.
+Pages that already reside in the buffer pool are skipped.
+NOTE: the calling thread may own latches on pages: to avoid deadlocks
+this function must be written such that it cannot end up waiting for
+these latches!
+@param space_id  tablespace identifier
+@param page_nos  page numbers, in the order they will be accessed
+@param n         number of elements in page_nos
+@param zip_size  ROW_FORMAT=COMPRESSED page size, or 0
+@return number of page read requests issued */
+ulint buf_read_ahead_pages(uint32_t space_id, const uint32_t *page_nos,
+                           ulint n, ulint zip_size)
+{
+  if (!n || space_id >= SRV_TMP_SPACE_ID)
+    /* Disable the read-ahead for temporary tablespace */
+    return 0;
+
+  if (srv_startup_is_before_trx_rollback_phase)
+    /* No read-ahead to avoid thread deadlocks */
+    return 0;
+
+  if (os_aio_pending_reads_approx() >
+      buf_pool.curr_size / BUF_READ_AHEAD_PEND_LIMIT)
+    return 0;
+
+  fil_space_t *space= fil_space_t::get(space_id);
+  if (!space)
+    return 0;
+
+  ulint count= 0;
+  buf_block_t *block= nullptr;
+  if (UNIV_LIKELY(!zip_size))
+  {
+  allocate_block:
+    if (UNIV_UNLIKELY(!(block= buf_read_acquire())))
+      goto func_exit;
+  }
+  else if (recv_recovery_is_on())
+  {
+    zip_size|= 1;
+    goto allocate_block;
+  }
+
+  for (ulint i= 0; i < n; i++)
+  {
+    if (space->is_stopping())
+      break;
+    const page_id_t page_id{space_id, page_nos[i]};
+    buf_pool_t::hash_chain &chain=
+      buf_pool.page_hash.cell_get(page_id.fold());
+    if (buf_pool.page_hash_contains(page_id, chain))
+      continue;
+    space->reacquire();
+    if (buf_read_page_low(page_id, zip_size, chain, space, block) ==
+        DB_SUCCESS)
+    {
+      count++;
+      ut_ad(!block);
+      if ((UNIV_LIKELY(!zip_size) || (zip_size & 1)) &&
+          UNIV_UNLIKELY(!(block= buf_read_acquire())))
+        break;
+    }
+  }
+
+  if (count)
+  {
+    DBUG_PRINT("ib_buf", ("prefetch %zu pages from %s",
+                          count, space->chain.start->name));
+    mysql_mutex_lock(&buf_pool.mutex);
+    /* The prefetch is considered one I/O operation for the purpose of
+    LRU policy decision. */
+    buf_LRU_stat_inc_io();
+    buf_pool.stat.n_ra_pages_read+= count;
+    mysql_mutex_unlock(&buf_pool.mutex);
+  }
+
+func_exit:
+  space->release();
+  buf_read_release(block);
+  return count;
+}
+
 /** High-level function which reads a page from a file to buf_pool
 if it is not already there. Sets the io_fix and an exclusive lock
 on the buffer frame. The flag is cleared and the x-lock
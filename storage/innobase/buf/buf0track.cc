@@ -0,0 +1,238 @@
+/*****************************************************************************
+
+Copyright (c) 2024, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file buf/buf0track.cc
+Changed page tracking (innodb_track_changed_pages)
+*******************************************************/
+
+#include "buf0track.h"
+#include "fil0fil.h"
+#include "log0log.h"
+#include "srv0srv.h"
+#include "mach0data.h"
+#include "log.h"
+#include <algorithm>
+
+/** Changed page tracking */
+buf_track_t buf_track;
+
+bool buf_track_t::create(lsn_t lsn) noexcept
+{
+  mysql_mutex_assert_owner(&mutex);
+  ut_ad(file == OS_FILE_CLOSED);
+  snprintf(path, sizeof path, "%s/" CHANGED_PAGES_FILE_PREFIX LSN_PF,
+           fil_path_to_mysql_datadir, lsn);
+
+  /* A file by this name can only exist if no log was written after
+  it was created. Anything that it contains is covered by the previous
+  files. */
+  os_file_delete_if_exists(innodb_data_file_key, path, nullptr);
+
+  bool success;
+  file= os_file_create_simple_no_error_handling(innodb_data_file_key, path,
+                                                OS_FILE_CREATE,
+                                                OS_FILE_READ_WRITE, false,
+                                                &success);
+  if (!success)
+  {
+    file= OS_FILE_CLOSED;
+    sql_print_error("InnoDB: Cannot create %s", path);
+    return false;
+  }
+
+  byte header[CHANGED_PAGES_HEADER_SIZE];
+  mach_write_to_4(header, CHANGED_PAGES_MAGIC);
+  mach_write_to_4(header + 4, CHANGED_PAGES_VERSION);
+  mach_write_to_8(header + 8, lsn);
+  mach_write_to_4(header + 16, my_crc32c(0, header, 16));
+
+  if (os_file_write(IORequestWrite, path, file, header, 0, sizeof header) !=
+      DB_SUCCESS || !os_file_flush(file))
+  {
+    sql_print_error("InnoDB: Cannot write %s", path);
+    return false;
+  }
+
+  start_lsn= lsn;
+  size= sizeof header;
+  return true;
+}
+
+bool buf_track_t::append(uint32_t type, const std::vector<page_id_t> &pages,
+                         lsn_t lsn) noexcept
+{
+  mysql_mutex_assert_owner(&mutex);
+  ut_ad(file != OS_FILE_CLOSED);
+  const size_t len= CHANGED_PAGES_RECORD_SIZE + pages.size() * 8 + 4;
+  byte *buf= static_cast<byte*>(ut_malloc_nokey(len));
+  if (!buf)
+    return false;
+
+  byte *b= buf;
+  mach_write_to_4(b, type);
+  mach_write_to_4(b + 4, uint32_t(pages.size()));
+  mach_write_to_8(b + 8, lsn);
+  b+= CHANGED_PAGES_RECORD_SIZE;
+  for (const page_id_t id : pages)
+  {
+    mach_write_to_4(b, id.space());
+    mach_write_to_4(b + 4, id.page_no());
+    b+= 8;
+  }
+  mach_write_to_4(b, my_crc32c(0, buf, size_t(b - buf)));
+
+  const bool ok= os_file_write(IORequestWrite, path, file, buf, size, len) ==
+    DB_SUCCESS && os_file_flush(file);
+  ut_free(buf);
+  if (ok)
+    size+= len;
+  else
+    sql_print_error("InnoDB: Cannot write %s", path);
+  return ok;
+}
+
+void buf_track_t::disable() noexcept
+{
+  mysql_mutex_assert_owner(&mutex);
+  mysql_mutex_lock(&buf_pool.mutex);
+  enabled= false;
+  pending.clear();
+  mysql_mutex_unlock(&buf_pool.mutex);
+  /* mariadb-backup refuses to use the tracking files unless
+  innodb_track_changed_pages=ON. Remove the incomplete file as well. */
+  srv_track_changed_pages= false;
+  if (file != OS_FILE_CLOSED)
+  {
+    os_file_close(file);
+    file= OS_FILE_CLOSED;
+    os_file_delete_if_exists(innodb_data_file_key, path, nullptr);
+  }
+  sql_print_error("InnoDB: Disabling innodb_track_changed_pages");
+}
+
+void buf_track_t::add_space(uint32_t id) noexcept
+{
+  mysql_mutex_lock(&buf_pool.mutex);
+  if (enabled)
+    pending.emplace_back(id, FIL_NULL);
+  mysql_mutex_unlock(&buf_pool.mutex);
+}
+
+void buf_track_t::start(lsn_t lsn) noexcept
+{
+  ut_ad(!srv_read_only_mode);
+  ut_ad(!initialized);
+  if (!srv_track_changed_pages)
+    return;
+  mysql_mutex_init(PSI_NOT_INSTRUMENTED, &mutex, nullptr);
+  mysql_mutex_lock(&mutex);
+  /* A concurrent log checkpoint may invoke write(). */
+  initialized.store(true, std::memory_order_release);
+  if (!create(lsn))
+    disable();
+  else
+  {
+    mysql_mutex_lock(&buf_pool.mutex);
+    enabled= true;
+    mysql_mutex_unlock(&buf_pool.mutex);
+    sql_print_information("InnoDB: Tracking changed pages in %s", path);
+  }
+  mysql_mutex_unlock(&mutex);
+}
+
+void buf_track_t::write() noexcept
+{
+  if (!initialized.load(std::memory_order_acquire))
+    return;
+  std::vector<page_id_t> pages;
+  mysql_mutex_lock(&mutex);
+  mysql_mutex_lock(&buf_pool.mutex);
+  pages.swap(pending);
+  mysql_mutex_unlock(&buf_pool.mutex);
+  /* Any page that was noted in buf_page_t::flush() before the swap
+  carries a FIL_PAGE_LSN that does not exceed the current LSN. */
+  const lsn_t lsn= log_sys.get_lsn();
+
+  if (file != OS_FILE_CLOSED && !pages.empty())
+  {
+    std::sort(pages.begin(), pages.end());
+    pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+    if (!append(CHANGED_PAGES_INTERVAL, pages, lsn))
+      disable();
+    else if (size >= CHANGED_PAGES_FILE_MAX && lsn > start_lsn)
+    {
+      pages.clear();
+      if (!append(CHANGED_PAGES_CLOSE, pages, lsn))
+        disable();
+      else
+      {
+        os_file_close(file);
+        file= OS_FILE_CLOSED;
+        if (!create(lsn))
+          disable();
+      }
+    }
+  }
+
+  mysql_mutex_unlock(&mutex);
+}
+
+void buf_track_t::shutdown(lsn_t lsn) noexcept
+{
+  if (!initialized)
+    return;
+  std::vector<page_id_t> pages;
+  mysql_mutex_lock(&mutex);
+  mysql_mutex_lock(&buf_pool.mutex);
+  pages.swap(pending);
+  enabled= false;
+  mysql_mutex_unlock(&buf_pool.mutex);
+
+  if (file != OS_FILE_CLOSED)
+  {
+    std::sort(pages.begin(), pages.end());
+    pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+    if ((!pages.empty() && !append(CHANGED_PAGES_INTERVAL, pages, lsn)) ||
+        !append(CHANGED_PAGES_CLOSE, {}, lsn))
+      disable();
+    else
+    {
+      os_file_close(file);
+      file= OS_FILE_CLOSED;
+    }
+  }
+
+  mysql_mutex_unlock(&mutex);
+}
+
+void buf_track_t::close() noexcept
+{
+  if (!initialized)
+    return;
+  if (file != OS_FILE_CLOSED)
+  {
+    os_file_close(file);
+    file= OS_FILE_CLOSED;
+  }
+  enabled= false;
+  pending.clear();
+  pending.shrink_to_fit();
+  mysql_mutex_destroy(&mutex);
+  initialized.store(false, std::memory_order_relaxed);
+}
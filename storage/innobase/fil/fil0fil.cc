@@ -2984,18 +2984,18 @@ void IORequest::write_complete(int io_error) const
   fil_space_t *space= node->space;
   ut_ad(is_write());
 
-  if (!bpage)
+  if (type == IORequest::DBLWR_BATCH)
   {
     ut_ad(!srv_read_only_mode);
-    if (type == IORequest::DBLWR_BATCH)
-    {
-      buf_dblwr.flush_buffered_writes_completed(*this);
-      /* Above, we already invoked os_file_flush() on the
-      doublewrite buffer if needed. */
-      goto func_exit;
-    }
-    else
-      ut_ad(type == IORequest::WRITE_ASYNC);
+    buf_dblwr.flush_buffered_writes_completed(*this);
+    /* Above, we already invoked os_file_flush() on the
+    doublewrite buffer if needed. */
+    goto func_exit;
+  }
+  else if (!bpage)
+  {
+    ut_ad(!srv_read_only_mode);
+    ut_ad(type == IORequest::WRITE_ASYNC);
   }
   else
     buf_page_write_complete(*this, io_error);
@@ -87,6 +87,11 @@ static const ulint FTS_CACHE_SIZE_UPPER_LIMIT_IN_MB = 1024;
 /** Time to sleep after DEADLOCK error before retrying operation. */
 static const std::chrono::milliseconds FTS_DEADLOCK_RETRY_WAIT(100);
 
+/** Initial capacity of fts_tokenizer_word_t::nodes in the cache.
+A cached word gets another node only when its ilist exceeds
+FTS_ILIST_MAX_SIZE or when the word is added to during a SYNC. */
+static constexpr ulint FTS_CACHE_WORD_NODES_INIT = 1;
+
 /** InnoDB default stopword list:
 There are different versions of stopwords, the stop words listed
 below comes from "Google Stopword" list. Reference:
@@ -555,9 +560,13 @@ fts_index_cache_init(
 
 	ut_a(index_cache->words == NULL);
 
+	/* The words and their nodes vectors are allocated from the sync
+	heap, and so are the tree nodes: they are all freed at once at
+	the end of a SYNC, by fts_cache_clear(). */
 	index_cache->words = rbt_create_arg_cmp(
 		sizeof(fts_tokenizer_word_t), innobase_fts_text_cmp,
-		(void*) index_cache->charset);
+		(void*) index_cache->charset,
+		static_cast<mem_heap_t*>(allocator->arg));
 
 	ut_a(index_cache->doc_stats == NULL);
 
@@ -985,10 +994,11 @@ fts_words_free(
 {
 	const ib_rbt_node_t*	rbt_node;
 
-	/* Free the resources held by a word. */
+	/* Free the resources held by a word. The tree nodes themselves
+	are allocated from the sync heap, see fts_index_cache_init(). */
 	for (rbt_node = rbt_first(words);
 	     rbt_node != NULL;
-	     rbt_node = rbt_first(words)) {
+	     rbt_node = rbt_next(words, rbt_node)) {
 
 		ulint			i;
 		fts_tokenizer_word_t*	word;
@@ -1004,9 +1014,6 @@ fts_words_free(
 			ut_free(fts_node->ilist);
 			fts_node->ilist = NULL;
 		}
-
-		/* NOTE: We are responsible for free'ing the node */
-		ut_free(rbt_remove_node(words, rbt_node));
 	}
 }
 
@@ -1157,7 +1164,8 @@ fts_tokenizer_word_get(
 		heap = static_cast<mem_heap_t*>(cache->sync_heap->arg);
 
 		new_word.nodes = ib_vector_create(
-			cache->sync_heap, sizeof(fts_node_t), 4);
+			cache->sync_heap, sizeof(fts_node_t),
+			FTS_CACHE_WORD_NODES_INIT);
 
 		fts_string_dup(&new_word.text, text, heap);
 
@@ -1168,7 +1176,7 @@ fts_tokenizer_word_get(
 		cache->total_size += sizeof(new_word)
 			+ sizeof(ib_rbt_node_t)
 			+ text->f_len
-			+ (sizeof(fts_node_t) * 4)
+			+ (sizeof(fts_node_t) * FTS_CACHE_WORD_NODES_INIT)
 			+ sizeof(*new_word.nodes);
 
 		ut_ad(rbt_validate(index_cache->words));
@@ -3955,6 +3963,11 @@ fts_sync_add_deleted_cache(
 }
 
 /** Write the words and ilist to disk.
+The nodes to write are collected while holding cache->lock. If
+unlock_cache holds, they are written without holding cache->lock,
+so that concurrent DML will not wait for the INSERT of each node.
+The collected nodes remain valid: fts_cache_add_doc() will not append
+to a synced node, and the memory is only freed by fts_sync_commit().
 @param[in,out]	trx		transaction
 @param[in]	index_cache	index cache
 @param[in]	unlock_cache	whether unlock cache when write node
@@ -3971,22 +3984,30 @@ fts_sync_write_words(
 	ulint		n_words = 0;
 	const ib_rbt_node_t* rbt_node;
 	dberr_t		error = DB_SUCCESS;
-	ibool		print_error = FALSE;
 	dict_table_t*	table = index_cache->index->table;
 
+	/** A node to be written to an auxiliary INDEX table */
+	struct sync_node_t {
+		/** the word */
+		fts_string_t*	text;
+		/** the node */
+		fts_node_t*	node;
+		/** the auxiliary INDEX table, see fts_select_index() */
+		ulint		selected;
+	};
+
 	FTS_INIT_INDEX_TABLE(
 		&fts_table, NULL, FTS_INDEX_TABLE, index_cache->index);
 
 	n_words = rbt_size(index_cache->words);
 
-	/* We iterate over the entire tree, even if there is an error,
-	since we want to free the memory used during caching. */
+	std::vector<sync_node_t> to_write;
+	to_write.reserve(n_words);
+
 	for (rbt_node = rbt_first(index_cache->words);
 	     rbt_node;
 	     rbt_node = rbt_next(index_cache->words, rbt_node)) {
 
-		ulint			i;
-		ulint			selected;
 		fts_tokenizer_word_t*	word;
 
 		word = rbt_value(fts_tokenizer_word_t, rbt_node);
@@ -3996,62 +4017,62 @@ fts_sync_write_words(
 			std::this_thread::sleep_for(
 				std::chrono::milliseconds(300)););
 
-		selected = fts_select_index(
+		const ulint selected = fts_select_index(
 			index_cache->charset, word->text.f_str,
 			word->text.f_len);
 
-		fts_table.suffix = fts_get_suffix(selected);
-
-		/* We iterate over all the nodes even if there was an error */
-		for (i = 0; i < ib_vector_size(word->nodes); ++i) {
+		for (ulint i = 0; i < ib_vector_size(word->nodes); ++i) {
 
 			fts_node_t* fts_node = static_cast<fts_node_t*>(
 				ib_vector_get(word->nodes, i));
 
-			if (fts_node->synced) {
-				continue;
-			} else {
+			if (!fts_node->synced) {
 				fts_node->synced = true;
+				to_write.push_back({&word->text, fts_node,
+						    selected});
 			}
+		}
 
-			/*FIXME: we need to handle the error properly. */
-			if (error == DB_SUCCESS) {
-				if (unlock_cache) {
-					mysql_mutex_unlock(
-						&table->fts->cache->lock);
-				}
+		n_nodes += ib_vector_size(word->nodes);
+	}
 
-				error = fts_write_node(
-					trx,
-					&index_cache->ins_graph[selected],
-					&fts_table, &word->text, fts_node);
+	if (to_write.empty()) {
+		return(DB_SUCCESS);
+	}
 
-				DEBUG_SYNC_C("fts_write_node");
-				DBUG_EXECUTE_IF("fts_write_node_crash",
-					DBUG_SUICIDE(););
+	if (unlock_cache) {
+		mysql_mutex_unlock(&table->fts->cache->lock);
+	}
 
-				DBUG_EXECUTE_IF(
-					"fts_instrument_sync_sleep",
-					std::this_thread::sleep_for(
-						std::chrono::seconds(1)););
+	for (const sync_node_t& n : to_write) {
+		fts_table.suffix = fts_get_suffix(n.selected);
 
-				if (unlock_cache) {
-					mysql_mutex_lock(
-						&table->fts->cache->lock);
-				}
-			}
-		}
+		error = fts_write_node(
+			trx, &index_cache->ins_graph[n.selected],
+			&fts_table, n.text, n.node);
 
-		n_nodes += ib_vector_size(word->nodes);
+		DEBUG_SYNC_C("fts_write_node");
+		DBUG_EXECUTE_IF("fts_write_node_crash",
+			DBUG_SUICIDE(););
+
+		DBUG_EXECUTE_IF(
+			"fts_instrument_sync_sleep",
+			std::this_thread::sleep_for(
+				std::chrono::seconds(1)););
 
-		if (UNIV_UNLIKELY(error != DB_SUCCESS) && !print_error) {
+		if (UNIV_UNLIKELY(error != DB_SUCCESS)) {
+			/*FIXME: we need to handle the error properly. */
 			ib::error() << "(" << error << ") writing"
 				" word node to FTS auxiliary index table "
 				<< table->name;
-			print_error = TRUE;
+			break;
 		}
 	}
 
+	if (unlock_cache) {
+		mysql_mutex_lock(&table->fts->cache->lock);
+	}
+
 	if (UNIV_UNLIKELY(fts_enable_diag_print)) {
 		printf("Avg number of nodes: %lf\n",
 		       (double) n_nodes / (double) (n_words > 1 ? n_words : 1));
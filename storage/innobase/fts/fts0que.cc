@@ -36,6 +36,7 @@ Completed 2011/7/10 Sunny and Jimmy Yang
 #include "fts0plugin.h"
 #include "fts0vlc.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <vector>
 
@@ -148,6 +149,10 @@ struct fts_query_t {
 	byte		visiting_sub_exp; /*!< count of nested
 					fts_ast_visit_sub_exp() */
 
+	ulint		limit;		/*!< Number of best ranked documents
+					that will be read, or
+					ULINT_UNDEFINED */
+
 	st_mysql_ftparser*	parser;	/*!< fts plugin parser */
 };
 
@@ -267,6 +272,8 @@ struct fts_word_freq_t {
 					of type fts_doc_freq_t */
 	ib_uint64_t	doc_count;	/*!< Total number of documents that
 					contain this word */
+	ulint		max_freq;	/*!< Highest frequency of the word
+					in any of the documents */
 	double		idf;		/*!< Inverse document frequency */
 };
 
@@ -500,6 +507,24 @@ fts_query_compare_rank(
 	return(1);
 }
 
+/** Compare two fts_ranking_t for a binary heap whose top element
+is the first one in the order of fts_query_compare_rank().
+@return whether r1 is to be returned after r2 */
+static bool fts_query_rank_heap_less(const fts_ranking_t *r1,
+                                     const fts_ranking_t *r2)
+{
+  return fts_query_compare_rank(r1, r2) > 0;
+}
+
+/** Compare two fts_ranking_t for a binary heap whose top element
+is the last one in the order of fts_query_compare_rank().
+@return whether r1 is to be returned before r2 */
+static bool fts_query_rank_heap_greater(const fts_ranking_t *r1,
+                                        const fts_ranking_t *r2)
+{
+  return fts_query_compare_rank(r1, r2) < 0;
+}
+
 /*******************************************************************//**
 Create words in ranking */
 static
@@ -3303,6 +3328,10 @@ fts_query_filter_doc_ids(
 			doc_freq->freq = freq;
 		}
 
+		if (doc_freq->freq > word_freq->max_freq) {
+			word_freq->max_freq = doc_freq->freq;
+		}
+
 		/* Skip the end of word position marker. */
 		++ptr;
 
@@ -3564,6 +3593,87 @@ fts_query_calculate_ranking(
 	}
 }
 
+/** Rank only the documents that can be among the query->limit best ones.
+
+Each word contributes at most max_freq * idf * idf to the rank of
+a document. Before a document is ranked, the sum of these maxima over
+its words is compared with the rank of the worst one of the best
+documents found so far. If it is not higher, the document cannot
+replace any of them and its exact rank is not calculated.
+
+@param query   query state
+@param result  empty result
+@return result with the query->limit best ranked documents */
+static fts_result_t *fts_query_rank_top(fts_query_t *query,
+                                        fts_result_t *result)
+{
+  const size_t n_words= query->word_vector->size();
+  std::vector<fts_rank_t, ut_allocator<fts_rank_t> > max_rank(n_words);
+  std::vector<fts_ranking_t*, ut_allocator<fts_ranking_t*> > top;
+
+  ut_ad(query->limit);
+  ut_ad(query->limit < rbt_size(query->doc_ids));
+  ut_ad(!rbt_size(result->rankings_by_id));
+
+  for (size_t pos= 0; pos < n_words; pos++)
+  {
+    ib_rbt_bound_t parent;
+    if (!rbt_search(query->word_freqs, &parent, &query->word_vector->at(pos)))
+    {
+      const fts_word_freq_t *word_freq=
+        rbt_value(fts_word_freq_t, parent.last);
+      /* The same expression as in fts_query_calculate_ranking(),
+      so that the bound is never below the rank. */
+      double weight= double(word_freq->max_freq) * word_freq->idf;
+      max_rank[pos]= fts_rank_t(weight * word_freq->idf);
+    }
+  }
+
+  top.reserve(query->limit);
+
+  /* Because the documents are visited in ascending order of doc_id,
+  a document whose rank equals that of top.front() is returned after it. */
+  for (const ib_rbt_node_t *node= rbt_first(query->doc_ids); node;
+       node= rbt_next(query->doc_ids, node))
+  {
+    fts_ranking_t *ranking= rbt_value(fts_ranking_t, node);
+
+    if (top.size() == query->limit)
+    {
+      fts_rank_t bound= ranking->rank;
+      ulint pos= 0;
+      fts_string_t word;
+      while (fts_ranking_words_get_next(query, ranking, &pos, &word))
+        bound+= max_rank[pos - 1];
+      if (bound <= top.front()->rank)
+        continue;
+    }
+
+    fts_query_calculate_ranking(query, ranking);
+    ranking->words= nullptr;
+
+    if (top.size() < query->limit)
+    {
+      top.push_back(ranking);
+      std::push_heap(top.begin(), top.end(), fts_query_rank_heap_greater);
+    }
+    else if (fts_query_rank_heap_greater(ranking, top.front()))
+    {
+      std::pop_heap(top.begin(), top.end(), fts_query_rank_heap_greater);
+      top.back()= ranking;
+      std::push_heap(top.begin(), top.end(), fts_query_rank_heap_greater);
+    }
+  }
+
+  for (const fts_ranking_t *ranking : top)
+  {
+    rbt_insert(result->rankings_by_id, ranking, ranking);
+    query->total_size+= SIZEOF_RBT_NODE_ADD + sizeof(fts_ranking_t);
+  }
+
+  return result;
+}
+
 /*****************************************************************//**
 Add ranking to the result set. */
 static
@@ -3718,6 +3828,11 @@ fts_query_prepare_result(
 
 	ut_a(rbt_size(query->doc_ids) > 0);
 
+	if (result_is_null && query->limit
+	    && query->limit < rbt_size(query->doc_ids)) {
+		DBUG_RETURN(fts_query_rank_top(query, result));
+	}
+
 	for (node = rbt_first(query->doc_ids);
 	     node;
 	     node = rbt_next(query->doc_ids, node)) {
@@ -3930,6 +4045,8 @@ fts_query_can_optimize(
 @param[in]	flags		FTS search mode
 @param[in]	query_str	FTS query
 @param[in]	query_len	FTS query string len in bytes
+@param[in]	limit		number of best ranked documents that
+				will be read, or ULINT_UNDEFINED
 @param[in,out]	result		result doc ids
 @return DB_SUCCESS if successful otherwise error code */
 dberr_t
@@ -3939,6 +4056,7 @@ fts_query(
 	uint		flags,
 	const byte*	query_str,
 	ulint		query_len,
+	ulint		limit,
 	fts_result_t**	result)
 {
 	fts_query_t	query;
@@ -3964,6 +4082,7 @@ fts_query(
 	query.trx = query_trx;
 	query.index = index;
 	query.boolean_mode = boolean_mode;
+	query.limit = limit;
 	query.deleted = fts_doc_ids_create();
 	query.cur_node = NULL;
 
@@ -4156,10 +4275,7 @@ fts_query_free_result(
 			rbt_free(result->rankings_by_id);
 			result->rankings_by_id = NULL;
 		}
-		if (result->rankings_by_rank != NULL) {
-			rbt_free(result->rankings_by_rank);
-			result->rankings_by_rank = NULL;
-		}
+		ut_free(result->rankings_by_rank);
 
 		ut_free(result);
 		result = NULL;
@@ -4174,33 +4290,49 @@ fts_query_sort_result_on_rank(
 	fts_result_t*	result)		/*!< out: result instance to sort.*/
 {
 	const ib_rbt_node_t*	node;
-	ib_rbt_t*		ranked;
+	ulint			n = 0;
 
 	ut_a(result->rankings_by_id != NULL);
-	if (result->rankings_by_rank) {
-		rbt_free(result->rankings_by_rank);
-	}
+	ut_free(result->rankings_by_rank);
 
-	ranked = rbt_create(sizeof(fts_ranking_t), fts_query_compare_rank);
+	result->rankings_by_rank = static_cast<const fts_ranking_t**>(
+		ut_malloc_nokey(rbt_size(result->rankings_by_id)
+				* sizeof *result->rankings_by_rank));
 
-	/* We need to free any instances of fts_doc_freq_t that we
-	may have allocated. */
 	for (node = rbt_first(result->rankings_by_id);
 	     node;
 	     node = rbt_next(result->rankings_by_id, node)) {
 
-		fts_ranking_t*	ranking;
+		const fts_ranking_t*	ranking;
 
 		ranking = rbt_value(fts_ranking_t, node);
 
 		ut_a(ranking->words == NULL);
 
-		rbt_insert(ranked, ranking, ranking);
+		result->rankings_by_rank[n++] = ranking;
 	}
 
+	/* Building the heap takes linear time. Each fetched row
+	costs a logarithmic number of comparisons, so that a query with
+	a small LIMIT does not pay for sorting all the documents. */
+	std::make_heap(result->rankings_by_rank,
+		       result->rankings_by_rank + n,
+		       fts_query_rank_heap_less);
+
 	/* Reset the current node too. */
 	result->current = NULL;
-	result->rankings_by_rank = ranked;
+	result->n_rankings_by_rank = n;
+}
+
+const fts_ranking_t *fts_query_result_next(fts_result_t *result)
+{
+  if (!result->n_rankings_by_rank)
+    return result->current= nullptr;
+  std::pop_heap(result->rankings_by_rank,
+                result->rankings_by_rank + result->n_rankings_by_rank,
+                fts_query_rank_heap_less);
+  return result->current=
+    result->rankings_by_rank[--result->n_rankings_by_rank];
 }
 
 /*******************************************************************//**
@@ -887,6 +887,18 @@ static MYSQL_THDVAR_UINT(lock_wait_timeout, PLUGIN_VAR_RQCMDARG,
   "Timeout in seconds an InnoDB transaction may wait for a lock before being rolled back. The value 100000000 is infinite timeout.",
   NULL, NULL, 50, 0, 100000000, 0);
 
+static MYSQL_THDVAR_UINT(clustered_read_ahead, PLUGIN_VAR_RQCMDARG,
+  "Maximum number of secondary index records on a leaf page for which"
+  " the clustered index leaf pages are read ahead when a scan needs full"
+  " rows; 0 disables the read-ahead.",
+  NULL, NULL, 0, 0, 256, 0);
+
+static MYSQL_THDVAR_UINT(ddl_threads, PLUGIN_VAR_RQCMDARG,
+  "Maximum number of threads that sort and load the non-unique secondary"
+  " indexes of ALTER TABLE concurrently, one index per thread. Each index"
+  " is still built by a single thread.",
+  NULL, NULL, 1, 1, 64, 0);
+
 static MYSQL_THDVAR_STR(ft_user_stopword_table,
   PLUGIN_VAR_OPCMDARG|PLUGIN_VAR_MEMALLOC,
   "User supplied stopword table name, effective in the session level.",
@@ -1808,6 +1820,16 @@ thd_lock_wait_timeout(
 	return(THDVAR(thd, lock_wait_timeout));
 }
 
+uint thd_clustered_read_ahead(THD *thd)
+{
+  return THDVAR(thd, clustered_read_ahead);
+}
+
+uint thd_ddl_threads(THD *thd)
+{
+  return THDVAR(thd, ddl_threads);
+}
+
 /** Get the value of innodb_tmpdir.
 @param[in]	thd	thread handle, or NULL to query
 			the global innodb_tmpdir.
@@ -9566,6 +9588,20 @@ ha_innobase::ft_init_ext(
 	uint			flags,	/* in: */
 	uint			keynr,	/* in: */
 	String*			key)	/* in: */
+{
+	return ft_init_ext_with_hints(flags, keynr, key, HA_POS_ERROR);
+}
+
+/** Initialize FT index scan
+@param flags  FT_BOOL, FT_SORTED, FT_EXPAND
+@param keynr  index number
+@param key    query string
+@param limit  number of best ranked rows that the caller will read,
+or HA_POS_ERROR
+@return FT_INFO structure if successful or NULL */
+FT_INFO*
+ha_innobase::ft_init_ext_with_hints(uint flags, uint keynr, String* key,
+				    ha_rows limit)
 {
 	NEW_FT_INFO*		fts_hdl = NULL;
 	dict_index_t*		index;
@@ -9654,8 +9690,10 @@ ha_innobase::ft_init_ext(
 	const byte*	q = reinterpret_cast<const byte*>(
 		const_cast<char*>(query));
 
-	// FIXME: support ft_init_ext_with_hints(), pass LIMIT
-	dberr_t	error = fts_query(trx, index, flags, q, query_len, &result);
+	dberr_t	error = fts_query(trx, index, flags, q, query_len,
+				  limit < ULINT_UNDEFINED
+				  ? ulint(limit) : ULINT_UNDEFINED,
+				  &result);
 
 	if (error != DB_SUCCESS) {
 		my_error(convert_error_code_to_mysql(error, 0, NULL), MYF(0));
@@ -9768,15 +9806,12 @@ ha_innobase::ft_read(
 			calculation. */
 
 			fts_query_sort_result_on_rank(result);
-
-			result->current = const_cast<ib_rbt_node_t*>(
-				rbt_first(result->rankings_by_rank));
+			fts_query_result_next(result);
 		} else {
 			ut_a(result->current == NULL);
 		}
 	} else {
-		result->current = const_cast<ib_rbt_node_t*>(
-			rbt_next(result->rankings_by_rank, result->current));
+		fts_query_result_next(result);
 	}
 
 next_record:
@@ -9790,11 +9825,8 @@ ha_innobase::ft_read(
 		if (ft_prebuilt->read_just_key) {
 #ifdef MYSQL_STORE_FTS_DOC_ID
 			if (m_prebuilt->fts_doc_id_in_read_set) {
-				fts_ranking_t* ranking;
-				ranking = rbt_value(fts_ranking_t,
-						    result->current);
 				innobase_fts_store_docid(
-					table, ranking->doc_id);
+					table, result->current->doc_id);
 			}
 #endif
 			table->status= 0;
@@ -9811,10 +9843,7 @@ ha_innobase::ft_read(
 		/* Switch to the FTS doc id index */
 		m_prebuilt->index = index;
 
-		fts_ranking_t*	ranking = rbt_value(
-			fts_ranking_t, result->current);
-
-		search_doc_id = ranking->doc_id;
+		search_doc_id = result->current->doc_id;
 
 		/* We pass a pointer of search_doc_id because it will be
 		converted to storage byte order used in the search
@@ -9836,11 +9865,7 @@ ha_innobase::ft_read(
 			table->status = 0;
 			break;
 		case DB_RECORD_NOT_FOUND:
-			result->current = const_cast<ib_rbt_node_t*>(
-				rbt_next(result->rankings_by_rank,
-					 result->current));
-
-			if (!result->current) {
+			if (!fts_query_result_next(result)) {
 				/* exhaust the result set, should return
 				HA_ERR_END_OF_FILE just like
 				ha_innobase::general_fetch() and/or
@@ -18214,7 +18239,7 @@ innobase_fts_retrieve_ranking(
 
 	ft_prebuilt = reinterpret_cast<NEW_FT_INFO*>(fts_hdl)->ft_prebuilt;
 
-	fts_ranking_t*  ranking = rbt_value(fts_ranking_t, result->current);
+	const fts_ranking_t* ranking = result->current;
 	ft_prebuilt->fts_doc_id= ranking->doc_id;
 
 	return(ranking->rank);
@@ -18331,11 +18356,7 @@ innobase_fts_retrieve_docid(
 	result = reinterpret_cast<NEW_FT_INFO *>(fts_hdl)->ft_result;
 
 	if (ft_prebuilt->read_just_key) {
-
-		fts_ranking_t* ranking =
-			rbt_value(fts_ranking_t, result->current);
-
-		return(ranking->doc_id);
+		return(result->current->doc_id);
 	}
 
 	return(ft_prebuilt->fts_doc_id);
@@ -18829,6 +18850,13 @@ static MYSQL_SYSVAR_ENUM(doublewrite, buf_dblwr.use,
   nullptr, innodb_doublewrite_update, true,
   &innodb_doublewrite_typelib);
 
+static MYSQL_SYSVAR_UINT(doublewrite_shards, buf_dblwr.shards,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of parts (rounded down to a power of 2) that the doublewrite"
+  " buffer is split into, each written by a separate batch of page writes,"
+  " with that many batches in progress concurrently.",
+  nullptr, nullptr, 1, 1, buf_dblwr_t::MAX_SHARDS, 0);
+
 static MYSQL_SYSVAR_BOOL(use_atomic_writes, srv_use_atomic_writes,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
   "Enable atomic writes, instead of using the doublewrite buffer, for files "
@@ -18979,6 +19007,13 @@ static MYSQL_SYSVAR_BOOL(flush_sync, srv_flush_sync,
   "Allow IO bursts at the checkpoints ignoring io_capacity setting.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(track_changed_pages, srv_track_changed_pages,
+  PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
+  "Record the pages written to persistent tablespaces in"
+  " ib_changed_pages_* files, so that mariadb-backup --incremental"
+  " can skip the pages that were not changed.",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_ULONG(flushing_avg_loops,
   srv_flushing_avg_loops,
   PLUGIN_VAR_RQCMDARG,
@@ -19744,6 +19779,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(temp_data_file_path),
   MYSQL_SYSVAR(data_home_dir),
   MYSQL_SYSVAR(doublewrite),
+  MYSQL_SYSVAR(doublewrite_shards),
   MYSQL_SYSVAR(stats_include_delete_marked),
   MYSQL_SYSVAR(use_atomic_writes),
   MYSQL_SYSVAR(fast_shutdown),
@@ -19782,6 +19818,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(adaptive_flushing_lwm),
   MYSQL_SYSVAR(adaptive_flushing),
   MYSQL_SYSVAR(flush_sync),
+  MYSQL_SYSVAR(track_changed_pages),
   MYSQL_SYSVAR(flushing_avg_loops),
   MYSQL_SYSVAR(max_purge_lag),
   MYSQL_SYSVAR(max_purge_lag_delay),
@@ -19812,6 +19849,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(status_file),
   MYSQL_SYSVAR(strict_mode),
   MYSQL_SYSVAR(sort_buffer_size),
+  MYSQL_SYSVAR(ddl_threads),
   MYSQL_SYSVAR(online_alter_log_max_size),
   MYSQL_SYSVAR(sync_spin_loops),
   MYSQL_SYSVAR(spin_wait_delay),
@@ -19825,6 +19863,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
 #endif /* HAVE_LIBNUMA */
   MYSQL_SYSVAR(random_read_ahead),
   MYSQL_SYSVAR(read_ahead_threshold),
+  MYSQL_SYSVAR(clustered_read_ahead),
   MYSQL_SYSVAR(read_only),
   MYSQL_SYSVAR(read_only_compressed),
   MYSQL_SYSVAR(instant_alter_column_allowed),
@@ -19927,7 +19966,9 @@ i_s_innodb_sys_foreign,
 i_s_innodb_sys_foreign_cols,
 i_s_innodb_sys_tablespaces,
 i_s_innodb_sys_virtual,
-i_s_innodb_tablespaces_encryption
+i_s_innodb_tablespaces_encryption,
+i_s_innodb_adaptive_hash_indexes,
+i_s_innodb_purge_table_stats
 maria_declare_plugin_end;
 
 /** @brief Adjust some InnoDB startup parameters based on file contents
@@ -160,6 +160,8 @@ class ha_innobase final : public handler
 	int ft_init() override;
 	void ft_end() override { rnd_end(); }
 	FT_INFO *ft_init_ext(uint flags, uint inx, String* key) override;
+	FT_INFO *ft_init_ext_with_hints(uint flags, uint inx, String* key,
+					ha_rows limit) override;
 	int ft_read(uchar* buf) override;
 
 	void position(const uchar *record) override;
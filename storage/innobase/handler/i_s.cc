@@ -44,12 +44,14 @@ Created July 18, 2007 Vasil Dimov
 #include "srv0start.h"
 #include "trx0i_s.h"
 #include "trx0trx.h"
+#include "trx0purge.h"
 #include "srv0mon.h"
 #include "pars0pars.h"
 #include "fts0types.h"
 #include "fts0opt.h"
 #include "fts0priv.h"
 #include "btr0btr.h"
+#include "btr0sea.h"
 #include "page0zip.h"
 #include "fil0fil.h"
 #include "fil0crypt.h"
@@ -4927,6 +4929,288 @@ struct st_maria_plugin	i_s_innodb_sys_tablestats =
 	MariaDB_PLUGIN_MATURITY_STABLE
 };
 
+namespace Show {
+/**  ADAPTIVE_HASH_INDEXES  ****************************************/
+/* Fields of the dynamic table INFORMATION_SCHEMA.ADAPTIVE_HASH_INDEXES */
+static ST_FIELD_INFO innodb_adaptive_hash_indexes_fields_info[]=
+{
+#define AHI_INDEX_ID		0
+  Column("INDEX_ID", ULonglong(), NOT_NULL),
+
+#define AHI_DATABASE_NAME	1
+  Column("DATABASE_NAME", Varchar(NAME_CHAR_LEN), NOT_NULL),
+
+#define AHI_TABLE_NAME		2
+  Column("TABLE_NAME", Varchar(NAME_CHAR_LEN), NOT_NULL),
+
+#define AHI_INDEX_NAME		3
+  Column("INDEX_NAME", Varchar(NAME_CHAR_LEN), NOT_NULL),
+
+#define AHI_HASHED_PAGES	4
+  Column("HASHED_PAGES", ULonglong(), NOT_NULL),
+
+#define AHI_HASH_NODES		5
+  Column("HASH_NODES", ULonglong(), NOT_NULL),
+
+#define AHI_MEMORY_USED		6
+  Column("MEMORY_USED", ULonglong(), NOT_NULL),
+
+  CEnd()
+};
+} // namespace Show
+
+#ifdef BTR_CUR_HASH_ADAPT
+/** Populate information_schema.innodb_adaptive_hash_indexes with
+the hashed indexes of a table.
+@param[in]	thd		connection
+@param[in]	table		InnoDB table metadata
+@param[in,out]	table_to_fill	INFORMATION_SCHEMA.INNODB_ADAPTIVE_HASH_INDEXES
+@return 0 on success */
+static int i_s_ahi_fill_table(THD *thd, const dict_table_t *table,
+                              TABLE *table_to_fill)
+{
+  Field **fields= table_to_fill->field;
+  char db_utf8[MAX_DB_UTF8_LEN];
+  char table_utf8[MAX_TABLE_UTF8_LEN];
+  bool names_converted= false;
+
+  for (const dict_index_t *index= dict_table_get_first_index(table); index;
+       index= dict_table_get_next_index(index))
+  {
+    ulint pages, nodes;
+    const ulint memory= btr_search_index_usage(*index, pages, nodes);
+    if (!pages && !nodes)
+      continue;
+
+    if (!names_converted)
+    {
+      dict_fs2utf8(table->name.m_name, db_utf8, sizeof db_utf8,
+                   table_utf8, sizeof table_utf8);
+      names_converted= true;
+    }
+
+    OK(fields[AHI_INDEX_ID]->store(longlong(index->id), true));
+    OK(field_store_string(fields[AHI_DATABASE_NAME], db_utf8));
+    OK(field_store_string(fields[AHI_TABLE_NAME], table_utf8));
+    OK(field_store_string(fields[AHI_INDEX_NAME], index->name));
+    OK(fields[AHI_HASHED_PAGES]->store(pages, true));
+    OK(fields[AHI_HASH_NODES]->store(nodes, true));
+    OK(fields[AHI_MEMORY_USED]->store(memory, true));
+    OK(schema_table_store_record(thd, table_to_fill));
+  }
+
+  return 0;
+}
+#endif /* BTR_CUR_HASH_ADAPT */
+
+/** Fill information_schema.innodb_adaptive_hash_indexes with the
+adaptive hash index usage of the indexes in the data dictionary cache.
+@return 0 on success */
+static int i_s_adaptive_hash_indexes_fill(THD *thd, TABLE_LIST *tables, Item*)
+{
+  DBUG_ENTER("i_s_adaptive_hash_indexes_fill");
+  RETURN_IF_INNODB_NOT_STARTED(tables->schema_table_name.str);
+
+  /* deny access to user without PROCESS_ACL privilege */
+  if (check_global_access(thd, PROCESS_ACL))
+    DBUG_RETURN(0);
+
+  int err= 0;
+#ifdef BTR_CUR_HASH_ADAPT
+  if (!btr_search_enabled)
+    DBUG_RETURN(0);
+
+  dict_sys.freeze(SRW_LOCK_CALL);
+
+  for (const dict_table_t *table= UT_LIST_GET_FIRST(dict_sys.table_LRU);
+       table && !err; table= UT_LIST_GET_NEXT(table_LRU, table))
+    err= i_s_ahi_fill_table(thd, table, tables->table);
+
+  for (const dict_table_t *table= UT_LIST_GET_FIRST(dict_sys.table_non_LRU);
+       table && !err; table= UT_LIST_GET_NEXT(table_LRU, table))
+    err= i_s_ahi_fill_table(thd, table, tables->table);
+
+  dict_sys.unfreeze();
+#endif /* BTR_CUR_HASH_ADAPT */
+  DBUG_RETURN(err);
+}
+
+/** Bind the dynamic table INFORMATION_SCHEMA.innodb_adaptive_hash_indexes
+@param[in,out]	p	table schema object
+@return 0 on success */
+static int innodb_adaptive_hash_indexes_init(void *p)
+{
+  DBUG_ENTER("innodb_adaptive_hash_indexes_init");
+  ST_SCHEMA_TABLE *schema= static_cast<ST_SCHEMA_TABLE*>(p);
+
+  schema->fields_info= Show::innodb_adaptive_hash_indexes_fields_info;
+  schema->fill_table= i_s_adaptive_hash_indexes_fill;
+
+  DBUG_RETURN(0);
+}
+
+struct st_maria_plugin	i_s_innodb_adaptive_hash_indexes =
+{
+	/* the plugin type (a MYSQL_XXX_PLUGIN value) */
+	/* int */
+	MYSQL_INFORMATION_SCHEMA_PLUGIN,
+
+	/* pointer to type-specific plugin descriptor */
+	/* void* */
+	&i_s_info,
+
+	/* plugin name */
+	/* const char* */
+	"INNODB_ADAPTIVE_HASH_INDEXES",
+
+	/* plugin author (for SHOW PLUGINS) */
+	/* const char* */
+	plugin_author,
+
+	/* general descriptive text (for SHOW PLUGINS) */
+	/* const char* */
+	"InnoDB adaptive hash index usage per index",
+
+	/* the plugin license (PLUGIN_LICENSE_XXX) */
+	/* int */
+	PLUGIN_LICENSE_GPL,
+
+	/* the function to invoke when plugin is loaded */
+	/* int (*)(void*); */
+	innodb_adaptive_hash_indexes_init,
+
+	/* the function to invoke when plugin is unloaded */
+	/* int (*)(void*); */
+	i_s_common_deinit,
+
+	i_s_version, nullptr, nullptr, PACKAGE_VERSION,
+	MariaDB_PLUGIN_MATURITY_STABLE
+};
+
+namespace Show {
+/**  PURGE_TABLE_STATS  ********************************************/
+/* Fields of the dynamic table INFORMATION_SCHEMA.INNODB_PURGE_TABLE_STATS */
+static ST_FIELD_INFO innodb_purge_table_stats_fields_info[]=
+{
+#define PURGE_TABLE_STATS_TABLE_ID	0
+  Column("TABLE_ID", ULonglong(), NOT_NULL),
+
+#define PURGE_TABLE_STATS_NAME		1
+  Column("NAME", Varchar(NAME_CHAR_LEN), NULLABLE),
+
+#define PURGE_TABLE_STATS_RECORDS	2
+  Column("RECORDS", ULonglong(), NOT_NULL),
+
+#define PURGE_TABLE_STATS_BATCHES	3
+  Column("BATCHES", ULonglong(), NOT_NULL),
+
+#define PURGE_TABLE_STATS_LAST_RECORDS	4
+  Column("LAST_BATCH_RECORDS", ULonglong(), NOT_NULL),
+
+#define PURGE_TABLE_STATS_LAST_TIME	5
+  Column("LAST_BATCH_TIME", Datetime(0), NOT_NULL),
+
+#define PURGE_TABLE_STATS_LAST_TRX_NO	6
+  Column("LAST_TRX_NO", ULonglong(), NOT_NULL),
+
+#define PURGE_TABLE_STATS_SPLIT		7
+  Column("SPLIT", SLong(1), NOT_NULL),
+
+  CEnd()
+};
+} // namespace Show
+
+/** Fill information_schema.innodb_purge_table_stats with the
+undo log records that the purge of history handled for each table.
+@return 0 on success */
+static int i_s_purge_table_stats_fill(THD *thd, TABLE_LIST *tables, Item*)
+{
+  DBUG_ENTER("i_s_purge_table_stats_fill");
+  RETURN_IF_INNODB_NOT_STARTED(tables->schema_table_name.str);
+
+  /* deny access to user without PROCESS_ACL privilege */
+  if (check_global_access(thd, PROCESS_ACL))
+    DBUG_RETURN(0);
+
+  Field **fields= tables->table->field;
+  const auto stats= purge_sys.get_table_stats();
+
+  dict_sys.freeze(SRW_LOCK_CALL);
+  auto _ = make_scope_exit([]() { dict_sys.unfreeze(); });
+
+  for (const auto &s : stats)
+  {
+    OK(fields[PURGE_TABLE_STATS_TABLE_ID]->store(s.first, true));
+    const dict_table_t *table= dict_sys.find_table(s.first);
+    OK(field_store_string(fields[PURGE_TABLE_STATS_NAME],
+                          table ? table->name.m_name : nullptr));
+    OK(fields[PURGE_TABLE_STATS_RECORDS]->store(s.second.n_recs, true));
+    OK(fields[PURGE_TABLE_STATS_BATCHES]->store(s.second.n_batches, true));
+    OK(fields[PURGE_TABLE_STATS_LAST_RECORDS]->
+       store(s.second.last_batch_recs, true));
+    OK(field_store_time_t(fields[PURGE_TABLE_STATS_LAST_TIME],
+                          s.second.last_batch_time));
+    OK(fields[PURGE_TABLE_STATS_LAST_TRX_NO]->
+       store(s.second.last_trx_no, true));
+    OK(fields[PURGE_TABLE_STATS_SPLIT]->store(s.second.split, true));
+    OK(schema_table_store_record(thd, tables->table));
+  }
+
+  DBUG_RETURN(0);
+}
+
+/** Bind the dynamic table INFORMATION_SCHEMA.innodb_purge_table_stats
+@param[in,out]	p	table schema object
+@return 0 on success */
+static int innodb_purge_table_stats_init(void *p)
+{
+  DBUG_ENTER("innodb_purge_table_stats_init");
+  ST_SCHEMA_TABLE *schema= static_cast<ST_SCHEMA_TABLE*>(p);
+
+  schema->fields_info= Show::innodb_purge_table_stats_fields_info;
+  schema->fill_table= i_s_purge_table_stats_fill;
+
+  DBUG_RETURN(0);
+}
+
+struct st_maria_plugin	i_s_innodb_purge_table_stats =
+{
+	/* the plugin type (a MYSQL_XXX_PLUGIN value) */
+	/* int */
+	MYSQL_INFORMATION_SCHEMA_PLUGIN,
+
+	/* pointer to type-specific plugin descriptor */
+	/* void* */
+	&i_s_info,
+
+	/* plugin name */
+	/* const char* */
+	"INNODB_PURGE_TABLE_STATS",
+
+	/* plugin author (for SHOW PLUGINS) */
+	/* const char* */
+	plugin_author,
+
+	/* general descriptive text (for SHOW PLUGINS) */
+	/* const char* */
+	"InnoDB purge of history per table",
+
+	/* the plugin license (PLUGIN_LICENSE_XXX) */
+	/* int */
+	PLUGIN_LICENSE_GPL,
+
+	/* the function to invoke when plugin is loaded */
+	/* int (*)(void*); */
+	innodb_purge_table_stats_init,
+
+	/* the function to invoke when plugin is unloaded */
+	/* int (*)(void*); */
+	i_s_common_deinit,
+
+	i_s_version, nullptr, nullptr, PACKAGE_VERSION,
+	MariaDB_PLUGIN_MATURITY_STABLE
+};
+
 namespace Show {
 /**  SYS_INDEXES  **************************************************/
 /* Fields of the dynamic table INFORMATION_SCHEMA.SYS_INDEXES */
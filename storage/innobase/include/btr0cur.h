@@ -139,6 +139,17 @@ dberr_t btr_cur_search_to_nth_level(ulint level,
                                     rw_lock_type_t rw_latch,
                                     btr_cur_t *cursor, mtr_t *mtr);
 
+/** Determine the leaf page that a search would be positioned on,
+without accessing the leaf page itself. Only non-leaf pages that reside
+in the buffer pool are looked at, and they are not latched in a coupled
+fashion, so the result is only a hint for prefetching.
+@param index   B-tree index
+@param tuple   search tuple, with n_fields_cmp excluding node pointer fields
+@return leaf page number
+@retval FIL_NULL if the leaf page could not be determined */
+uint32_t btr_cur_leaf_page_no_hint(const dict_index_t &index,
+                                   const dtuple_t &tuple);
+
 /*************************************************************//**
 Tries to perform an insert to a page in an index tree, next to cursor.
 It is assumed that mtr holds an x-latch on the page. The operation does
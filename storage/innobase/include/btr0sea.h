@@ -126,6 +126,14 @@ void btr_search_update_hash_on_insert(btr_cur_t *cursor,
 			using btr_cur_search_, the record is not yet deleted.*/
 void btr_search_update_hash_on_delete(btr_cur_t *cursor);
 
+/** Report the adaptive hash index usage of an index.
+@param index  index tree
+@param pages  number of leaf pages that are pointed to by the hash index
+@param nodes  number of hash table nodes that point to the index
+@return memory used by the hash table nodes, in bytes */
+ulint btr_search_index_usage(const dict_index_t &index,
+                             ulint &pages, ulint &nodes);
+
 /** Validates the search system.
 @param thd   connection, for checking if CHECK TABLE has been killed
 @return true if ok */
@@ -205,6 +213,11 @@ struct btr_search_t{
 				Protected by search latch except
 				when during initialization in
 				btr_search_info_create(). */
+	ulint	n_nodes;	/*!< Number of hash table nodes that
+				point to records of this index; this
+				is approximate, because a fold value
+				collision may let a node be reused by
+				another index. Protected by search latch. */
 
 	/*---------------------- @{ */
 	uint16_t n_fields;	/*!< recommended prefix length for hash search:
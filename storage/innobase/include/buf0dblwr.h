@@ -32,12 +32,18 @@ Created 2011/12/19 Inaam Rana
 /** Doublewrite control struct */
 class buf_dblwr_t
 {
+public:
+  /** Maximum value of innodb_doublewrite_shards */
+  static constexpr unsigned MAX_SHARDS= 8;
+private:
   struct element
   {
     /** asynchronous write request */
     IORequest request;
     /** payload size in bytes */
     size_t size;
+    /** whether the write to the data file has completed */
+    bool written;
   };
 
   struct slot
@@ -51,6 +57,12 @@ class buf_dblwr_t
     byte* write_buf;
     /** buffer blocks to be written via write_buf */
     element* buf_block_arr;
+    /** number of expected flush_buffered_writes_completed() calls */
+    unsigned flushing_buffered_writes;
+    /** the shard of the persistent doublewrite buffer being written */
+    unsigned shard;
+    /** sequence number of the batch, or 0 if no batch is running */
+    ulint batch;
   };
 
   /** the page number of the first doublewrite block (block_size pages) */
@@ -60,22 +72,29 @@ class buf_dblwr_t
 
   /** mutex protecting the data members below */
   mysql_mutex_t mutex;
-  /** condition variable for !batch_running */
+  /** condition variable for batches_running changes */
   pthread_cond_t cond;
-  /** whether a batch is being written from the doublewrite buffer */
-  bool batch_running;
-  /** number of expected flush_buffered_writes_completed() calls */
-  unsigned flushing_buffered_writes;
+  /** number of batches being written from the doublewrite buffer */
+  unsigned batches_running;
+  /** bitmap of the shards that are being written */
+  unsigned shards_running;
+  /** sequence number of the latest batch */
+  ulint batches_started;
   /** number of flush_buffered_writes_completed() calls */
   ulint writes_completed;
   /** number of pages written by flush_buffered_writes_completed() */
   ulint pages_written;
 
-  slot slots[2];
+  /** one slot for each shard, plus one being filled */
+  slot slots[MAX_SHARDS + 1];
   slot *active_slot;
 
   /** Size of the doublewrite block in pages */
   uint32_t block_size;
+  /** Number of shards (a power of 2) that block1 and block2 are split into */
+  uint32_t n_shards;
+  /** Size of a shard in pages */
+  uint32_t shard_size;
 
 public:
   /** Values of use */
@@ -89,13 +108,19 @@ class buf_dblwr_t
   };
   /** The value of innodb_doublewrite */
   ulong use;
+  /** The value of innodb_doublewrite_shards */
+  uint shards;
 private:
   /** Initialise the persistent storage of the doublewrite buffer.
   @param header   doublewrite page header in the TRX_SYS page */
   inline void init(const byte *header);
 
   /** Flush possible buffered writes to persistent storage. */
-  bool flush_buffered_writes(const ulint size);
+  bool flush_buffered_writes_low();
+
+  /** @return the running batch that is waiting for the write of a page
+  @param bpage  page that was written to its data file */
+  inline slot *find_batch(const buf_page_t *bpage);
 
 public:
   /** Initialise the doublewrite buffer data structures. */
@@ -131,15 +156,17 @@ class buf_dblwr_t
   /** Process and remove the double write buffer pages for all tablespaces. */
   void recover();
 
-  /** Update the doublewrite buffer on data page write completion. */
-  void write_completed();
+  /** Update the doublewrite buffer on data page write completion.
+  @param bpage  the page that was written */
+  void write_completed(const buf_page_t *bpage);
   /** Flush possible buffered writes to persistent storage.
   It is very important to call this function after a batch of writes has been
   posted, and also when we may have to wait for a page latch!
   Otherwise a deadlock of threads can occur. */
   void flush_buffered_writes();
   /** Update the doublewrite buffer on write batch completion
-  @param request  the completed batch write request */
+  @param request  the completed batch write request, with the first page
+                  of the batch as request.bpage */
   void flush_buffered_writes_completed(const IORequest &request);
 
   /** Schedule a page write. If the doublewrite memory buffer is full,
@@ -181,7 +208,7 @@ class buf_dblwr_t
   void wait_flush_buffered_writes()
   {
     mysql_mutex_lock(&mutex);
-    while (batch_running)
+    while (batches_running)
       my_cond_wait(&cond, &mutex.m_mutex);
     mysql_mutex_unlock(&mutex);
   }
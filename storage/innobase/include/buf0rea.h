@@ -67,6 +67,19 @@ wants to access
 @return number of page read requests issued */
 ulint buf_read_ahead_random(const page_id_t page_id, ulint zip_size);
 
+/** Issue asynchronous reads of pages that the caller is about to access.
+Pages that already reside in the buffer pool are skipped.
+NOTE: the calling thread may own latches on pages: to avoid deadlocks
+this function must be written such that it cannot end up waiting for
+these latches!
+@param space_id  tablespace identifier
+@param page_nos  page numbers, in the order they will be accessed
+@param n         number of elements in page_nos
+@param zip_size  ROW_FORMAT=COMPRESSED page size, or 0
+@return number of page read requests issued */
+ulint buf_read_ahead_pages(uint32_t space_id, const uint32_t *page_nos,
+                           ulint n, ulint zip_size);
+
 /** Applies linear read-ahead if in the buf_pool the page is a border page of
 a linear read-ahead area and all the pages in the area have been accessed.
 Does not read any page if the read-ahead mechanism is not activated. Note
@@ -0,0 +1,138 @@
+/*****************************************************************************
+
+Copyright (c) 2024, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/buf0track.h
+Changed page tracking (innodb_track_changed_pages)
+
+Every page that buf_page_t::flush() writes to a persistent tablespace
+is noted in memory. Before a log checkpoint header is written,
+the pages that were noted since the previous checkpoint are appended to
+a tracking file as one interval, tagged with the current LSN.
+Thus, any page that contains changes older than the latest checkpoint
+is guaranteed to be covered by the tracking files. mariadb-backup
+uses the files to read only the changed pages for --incremental.
+
+Each server startup creates the file ib_changed_pages_<start LSN> in
+the data directory. A file is rotated once it grows beyond
+CHANGED_PAGES_FILE_MAX; the new file starts at the end LSN of the
+previous one. On normal shutdown, a close record is appended.
+A chain of files is usable for an incremental backup from LSN x
+if its first file starts at or before x, each file is closed at the
+start LSN of the next file, and the last file is still being written.
+
+File format (all integers big-endian):
+header: magic(4), version(4), start LSN(8), CRC-32C of the preceding(4)
+record: type(4), number of pages(4), end LSN(8),
+number of pages * (tablespace id(4), page number(4)),
+CRC-32C of the preceding bytes of the record(4)
+A page number FIL_NULL refers to the entire tablespace.
+*******************************************************/
+
+#pragma once
+
+#include "buf0buf.h"
+#include "os0file.h"
+
+/** Prefix of changed page tracking file names */
+#define CHANGED_PAGES_FILE_PREFIX "ib_changed_pages_"
+/** Identifies a changed page tracking file */
+constexpr uint32_t CHANGED_PAGES_MAGIC= 0x69626370; /* "ibcp" */
+/** Format version of a changed page tracking file */
+constexpr uint32_t CHANGED_PAGES_VERSION= 1;
+/** Size of the file header, in bytes */
+constexpr size_t CHANGED_PAGES_HEADER_SIZE= 20;
+/** Size of the fixed part of a record, excluding the pages and checksum */
+constexpr size_t CHANGED_PAGES_RECORD_SIZE= 16;
+/** Record type: pages that were written before the end LSN */
+constexpr uint32_t CHANGED_PAGES_INTERVAL= 1;
+/** Record type: no pages will be written to this file after the end LSN */
+constexpr uint32_t CHANGED_PAGES_CLOSE= 2;
+/** A tracking file will be rotated after it exceeds this many bytes */
+constexpr os_offset_t CHANGED_PAGES_FILE_MAX= 64U << 20;
+
+/** Changed page tracking */
+class buf_track_t
+{
+  /** whether innodb_track_changed_pages is active */
+  bool enabled= false;
+  /** whether start() initialized mutex */
+  std::atomic<bool> initialized{false};
+  /** pages written since the previous interval; protected by
+  buf_pool.mutex */
+  std::vector<page_id_t> pending;
+  /** serializes the writes to the tracking file */
+  mysql_mutex_t mutex;
+  /** the tracking file; protected by mutex */
+  pfs_os_file_t file= OS_FILE_CLOSED;
+  /** path name of the tracking file; protected by mutex */
+  char path[FN_REFLEN];
+  /** start LSN of the tracking file; protected by mutex */
+  lsn_t start_lsn;
+  /** size of the tracking file; protected by mutex */
+  os_offset_t size;
+
+  /** Create a tracking file.
+  @param lsn  start LSN of the file
+  @return whether the file was created */
+  bool create(lsn_t lsn) noexcept;
+  /** Append a record to the tracking file.
+  @param type   CHANGED_PAGES_INTERVAL or CHANGED_PAGES_CLOSE
+  @param pages  sorted, distinct pages that were written
+  @param lsn    end LSN
+  @return whether the record was durably written */
+  bool append(uint32_t type, const std::vector<page_id_t> &pages, lsn_t lsn)
+    noexcept;
+  /** Stop tracking after a failure. */
+  void disable() noexcept;
+public:
+  /** @return whether changed pages are being tracked */
+  bool is_enabled() const noexcept { return enabled; }
+
+  /** Note that a page is being written.
+  @param id   page identifier */
+  void add(page_id_t id)
+  {
+    ut_ad(enabled);
+    mysql_mutex_assert_owner(&buf_pool.mutex);
+    pending.push_back(id);
+  }
+
+  /** Note that a tablespace file was written to outside the buffer pool.
+  @param id   tablespace identifier */
+  void add_space(uint32_t id) noexcept;
+
+  /** Start tracking if innodb_track_changed_pages is set.
+  @param lsn  log_sys.get_lsn() at startup */
+  void start(lsn_t lsn) noexcept;
+
+  /** Durably write the pages that have been written since the
+  previous invocation. Must be invoked before a log checkpoint
+  header is written. */
+  void write() noexcept;
+
+  /** Write out the pending pages and a close record on shutdown.
+  @param lsn  the shutdown LSN */
+  void shutdown(lsn_t lsn) noexcept;
+
+  /** Close the tracking file and free the memory. */
+  void close() noexcept;
+};
+
+/** Changed page tracking */
+extern buf_track_t buf_track;
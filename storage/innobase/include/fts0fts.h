@@ -274,12 +274,18 @@ struct fts_ranking_t {
 
 /** Query result. */
 struct fts_result_t {
-	ib_rbt_node_t*	current;	/*!< Current element */
+	const fts_ranking_t*
+			current;	/*!< Current element */
 
 	ib_rbt_t*	rankings_by_id;	/*!< RB tree of type fts_ranking_t
 					indexed by doc id */
-	ib_rbt_t*	rankings_by_rank;/*!< RB tree of type fts_ranking_t
-					indexed by rank */
+	const fts_ranking_t**
+			rankings_by_rank;/*!< Binary heap of the elements of
+					rankings_by_id that have not been
+					returned yet, ordered by rank */
+	ulint		n_rankings_by_rank;
+					/*!< Number of elements in
+					rankings_by_rank */
 };
 
 /** This is used to generate the FTS auxiliary table name, we need the
@@ -525,6 +531,8 @@ fts_commit(
 @param[in]	flags		FTS search mode
 @param[in]	query_str	FTS query
 @param[in]	query_len	FTS query string len in bytes
+@param[in]	limit		number of best ranked documents that
+				will be read, or ULINT_UNDEFINED
 @param[in,out]	result		result doc ids
 @return DB_SUCCESS if successful otherwise error code */
 dberr_t
@@ -534,6 +542,7 @@ fts_query(
 	uint		flags,
 	const byte*	query_str,
 	ulint		query_len,
+	ulint		limit,
 	fts_result_t**	result)
 	MY_ATTRIBUTE((warn_unused_result));
 
@@ -548,13 +557,23 @@ fts_retrieve_ranking(
 						doc_id */
 
 /******************************************************************//**
-FTS Query sort result, returned by fts_query() on fts_ranking_t::rank. */
+FTS Query sort result, returned by fts_query() on fts_ranking_t::rank.
+The result is ordered lazily by fts_query_result_next(), so that
+a query that only fetches the first few rows will not sort
+all the matching documents. */
 void
 fts_query_sort_result_on_rank(
 /*==========================*/
 	fts_result_t*	result);		/*!< out: result instance
 						to sort.*/
 
+/** Advance to the next best ranked document in a result that was
+prepared by fts_query_sort_result_on_rank().
+@param result  query result
+@return result->current, the next document
+@retval nullptr if all documents have been returned */
+const fts_ranking_t *fts_query_result_next(fts_result_t *result);
+
 /******************************************************************//**
 FTS Query free result, returned by fts_query(). */
 void
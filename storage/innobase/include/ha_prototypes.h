@@ -240,6 +240,17 @@ thd_lock_wait_timeout(
 	THD*	thd);	/*!< in: thread handle, or NULL to query
 			the global innodb_lock_wait_timeout */
 
+/** Get the value of innodb_clustered_read_ahead.
+@param thd  connection
+@return maximum number of secondary index records whose clustered index
+leaf pages are read ahead on each secondary index leaf page */
+uint thd_clustered_read_ahead(THD *thd);
+
+/** Get the value of innodb_ddl_threads.
+@param thd  connection
+@return maximum number of threads that build secondary indexes concurrently */
+uint thd_ddl_threads(THD *thd);
+
 /******************************************************************//**
 compare two character string case insensitively according to their charset. */
 int
@@ -236,6 +236,10 @@ struct recv_sys_t
   lsn_t file_checkpoint;
   /** the time when progress was last reported */
   time_t progress_time;
+  /** number of threads that are applying log records to a page */
+  Atomic_relaxed<uint32_t> n_applying;
+  /** maximum of n_applying since create() */
+  Atomic_relaxed<uint32_t> max_applying;
 
   using map = std::map<const page_id_t, page_recv_t,
                        std::less<const page_id_t>,
@@ -634,6 +634,14 @@ struct row_prebuilt_t {
 					fetched row in fetch_cache */
 	ulint		n_fetch_cached;	/*!< number of not yet fetched rows
 					in fetch_cache */
+	uint32_t	clust_read_ahead_page;
+					/*!< the secondary index leaf page
+					for which clustered index leaf pages
+					were last read ahead, or 0 */
+	uint32_t	clust_read_ahead_skip;
+					/*!< number of secondary index leaf
+					pages to pass before attempting
+					the next clustered index read-ahead */
 	mem_heap_t*	blob_heap;	/*!< in SELECTS BLOB fields are copied
 					to this heap */
 	mem_heap_t*	old_vers_heap;	/*!< memory heap where a previous
@@ -35,6 +35,7 @@ Created 3/14/1997 Heikki Tuuri
 #include "mysqld.h"
 #include <queue>
 #include <unordered_map>
+#include <unordered_set>
 
 class MDL_ticket;
 
@@ -93,6 +94,9 @@ struct purge_node_t
 
   /** map of table identifiers to table handles and meta-data locks */
   std::unordered_map<table_id_t, std::pair<dict_table_t*,MDL_ticket*>> tables;
+  /** identifiers of the tables that were split across several purge
+  tasks in this batch, and whose meta-data lock is owned by another task */
+  std::unordered_set<table_id_t> shared_tables;
 
   /** Constructor */
   explicit purge_node_t(que_thr_t *parent) :
@@ -222,6 +222,8 @@ extern ulong	srv_flush_log_at_trx_commit;
 extern uint	srv_flush_log_at_timeout;
 extern my_bool	srv_adaptive_flushing;
 extern my_bool	srv_flush_sync;
+/** innodb_track_changed_pages */
+extern my_bool	srv_track_changed_pages;
 
 /** Requested size in bytes */
 extern ulint		srv_buf_pool_size;
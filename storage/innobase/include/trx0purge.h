@@ -29,6 +29,7 @@ Created 3/26/1996 Heikki Tuuri
 #include "trx0sys.h"
 #include "que0types.h"
 #include "srw_lock.h"
+#include "row0types.h"
 
 #include <queue>
 #include <unordered_map>
@@ -279,6 +280,69 @@ class purge_sys_t
     uint32_t last;
   } truncate_undo_space;
 
+  /** Purge statistics of a table,
+  for INFORMATION_SCHEMA.INNODB_PURGE_TABLE_STATS */
+  struct table_stats
+  {
+    /** number of undo log records that were handed to purge */
+    ulonglong n_recs;
+    /** number of purge batches that covered the table */
+    ulonglong n_batches;
+    /** sequence number of the latest purge batch that covered the table */
+    ulonglong last_batch;
+    /** number of undo log records in the latest such batch */
+    ulint last_batch_recs;
+    /** transaction end identifier of the latest undo log record */
+    trx_id_t last_trx_no;
+    /** start time of the latest such batch */
+    time_t last_batch_time;
+    /** whether the latest such batch split the table across purge tasks */
+    bool split;
+  };
+
+  /** Accounting of a table within a purge batch */
+  struct batch_table
+  {
+    /** the purge task that owns the table handle and meta-data lock */
+    purge_node_t *owner;
+    /** number of undo log records */
+    ulint n_recs;
+    /** transaction end identifier of the latest undo log record */
+    trx_id_t last_trx_no;
+    /** whether the table was found */
+    bool found;
+    /** whether the records are distributed among all purge tasks */
+    bool split;
+  };
+private:
+  /** Protects m_table_stats */
+  srw_mutex table_stats_latch;
+  /** Per-table purge statistics; only modified by the purge coordinator */
+  std::unordered_map<table_id_t, table_stats> m_table_stats;
+  /** number of completed purge batches */
+  ulonglong m_n_batches;
+  /** number of undo log records in the latest purge batch */
+  ulint m_last_batch_recs;
+public:
+  /** Determine whether the undo log records of a table should be
+  distributed among all purge tasks by the PRIMARY KEY. This is the case
+  when the table accounted for more than its fair share of the
+  previous purge batch.
+  This is only to be called by the purge coordinator.
+  @param id       table identifier
+  @param n_tasks  number of purge tasks
+  @return whether the table should be split across the purge tasks */
+  bool is_hot(table_id_t id, ulint n_tasks) const;
+
+  /** Update the per-table statistics at the end of a purge batch.
+  This is only to be called by the purge coordinator.
+  @param tables  the tables that were covered by the batch */
+  void update_table_stats(const std::unordered_map<table_id_t, batch_table>
+                          &tables);
+
+  /** @return a copy of the per-table purge statistics */
+  std::vector<std::pair<table_id_t, table_stats>> get_table_stats();
+
   /** Create the instance */
   void create();
 
@@ -78,6 +78,15 @@ trx_undo_rec_get_row_ref(
 	mem_heap_t*	heap)	/*!< in: memory heap from which the memory
 				needed is allocated */
 	MY_ATTRIBUTE((nonnull));
+/** Compute a hash value of the row reference of an undo log record.
+@param undo_rec  undo log record
+@param index     clustered index of the table
+@param fold      hash value of the PRIMARY KEY or DB_ROW_ID
+@return whether the undo log record refers to a single row */
+bool trx_undo_rec_get_row_ref_fold(const trx_undo_rec_t *undo_rec,
+                                   const dict_index_t &index,
+                                   uint32_t *fold)
+  MY_ATTRIBUTE((nonnull, warn_unused_result));
 /**********************************************************************//**
 Reads from an undo log update record the system field values of the old
 version.
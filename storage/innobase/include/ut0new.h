@@ -843,6 +843,7 @@ constexpr const char* const auto_event_names[] =
   "buf0dump",
   "buf0lru",
   "buf0rea",
+  "buf0track",
   "dict0dict",
   "dict0mem",
   "dict0stats",
@@ -44,6 +44,7 @@ Created 2007-03-20 Sunny Bains
 #endif
 
 struct ib_rbt_node_t;
+struct mem_block_info_t;
 typedef void (*ib_rbt_print_node)(const ib_rbt_node_t* node);
 typedef int (*ib_rbt_compare)(const void* p1, const void* p2);
 typedef int (*ib_rbt_arg_compare)(const void*, const void* p1, const void* p2);
@@ -83,6 +84,13 @@ struct	ib_rbt_t {
 						with argument */
 	ulint		sizeof_value;		/* Sizeof the item in bytes */
 	void*		cmp_arg;		/* Compare func argument */
+	mem_block_info_t*
+			heap;			/* If not NULL, the data nodes
+						are allocated from this heap
+						and freed only together with
+						it, not by rbt_free(),
+						rbt_delete() or the caller
+						of rbt_remove_node() */
 };
 
 /** The result of searching for a key in the tree, this is useful for
@@ -132,7 +140,10 @@ rbt_create_arg_cmp(
 	size_t		sizeof_value,		/*!< in: size in bytes */
 	ib_rbt_arg_compare
 			compare,		/*!< in: comparator */
-	void*	cmp_arg);		/*!< in: compare fn arg */
+	void*	cmp_arg,		/*!< in: compare fn arg */
+	mem_block_info_t*
+		heap = NULL);		/*!< in: heap for the data nodes,
+					or NULL to use ut_malloc() */
 /**********************************************************************//**
 Delete a node from the red black tree, identified by key */
 ibool
@@ -143,7 +154,8 @@ rbt_delete(
 	const void*	key);			/* in: key to delete */
 /**********************************************************************//**
 Remove a node from the red black tree, NOTE: This function will not delete
-the node instance, THAT IS THE CALLERS RESPONSIBILITY.
+the node instance, THAT IS THE CALLERS RESPONSIBILITY (unless tree->heap
+is set).
 @return the deleted node with the const. */
 ib_rbt_node_t*
 rbt_remove_node(
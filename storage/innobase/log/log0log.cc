@@ -32,6 +32,7 @@ Created 12/9/1995 Heikki Tuuri
 #include "log0crypt.h"
 #include "buf0buf.h"
 #include "buf0flu.h"
+#include "buf0track.h"
 #include "lock0lock.h"
 #include "log0recv.h"
 #include "fil0fil.h"
@@ -1257,6 +1258,10 @@ ATTRIBUTE_COLD void logs_empty_and_mark_files_at_shutdown()
 
 	srv_shutdown_lsn = lsn;
 
+	if (!srv_read_only_mode) {
+		buf_track.shutdown(lsn);
+	}
+
 	/* Make some checks that the server really is quiet */
 	ut_ad(!srv_any_background_activity());
 
@@ -1348,6 +1348,8 @@ void recv_sys_t::create()
 	file_checkpoint = 0;
 
 	progress_time = time(NULL);
+	n_applying = 0;
+	max_applying = 0;
 	ut_ad(pages.empty());
 	pages_it = pages.end();
 	recv_max_page_lsn = 0;
@@ -3307,6 +3309,26 @@ ATTRIBUTE_COLD void recv_sys_t::set_corrupt_fs()
   found_corrupt_fs= true;
 }
 
+/** Note that a read completion callback starts applying log to a page. */
+static void recv_apply_start()
+{
+  const uint32_t n= recv_sys.n_applying.fetch_add(1) + 1;
+  uint32_t max= recv_sys.max_applying;
+  while (max < n && !recv_sys.max_applying.compare_exchange_strong(max, n));
+  DBUG_EXECUTE_IF("recv_apply_concurrently",
+                  /* Give another thread a chance to start applying */
+                  for (unsigned i= 100; i-- && recv_sys.max_applying < 2; )
+                    std::this_thread::sleep_for(
+                      std::chrono::milliseconds(1)););
+}
+
+/** Note that a read completion callback finished applying log to a page. */
+static void recv_apply_end()
+{
+  ut_d(const uint32_t n=) recv_sys.n_applying.fetch_sub(1);
+  ut_ad(n);
+}
+
 /** Apply any buffered redo log to a page.
 @param space     tablespace
 @param bpage     buffer pool page
@@ -3344,7 +3366,9 @@ bool recv_recover_page(fil_space_t* space, buf_page_t* bpage)
       p->second.being_processed= 1;
       const lsn_t init_lsn{p->second.skip_read ? mlog_init.last(id) : 0};
       mysql_mutex_unlock(&recv_sys.mutex);
+      recv_apply_start();
       success= recv_recover_page(success, mtr, p->second, space, init_lsn);
+      recv_apply_end();
       p->second.being_processed= -1;
       goto func_exit;
     }
@@ -3384,12 +3408,14 @@ void IORequest::fake_read_complete(os_offset_t offset) const
   const lsn_t init_lsn{offset};
   ut_ad(init_lsn > 1);
 
+  recv_apply_start();
   if (recv_recover_page(reinterpret_cast<buf_block_t*>(bpage),
                         mtr, recs, node->space, init_lsn))
   {
     ut_ad(bpage->oldest_modification() || bpage->is_freed());
     bpage->lock.x_unlock(true);
   }
+  recv_apply_end();
   recs.being_processed= -1;
   ut_ad(mtr.has_committed());
 
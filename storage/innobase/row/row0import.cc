@@ -30,6 +30,7 @@ Created 2012-02-08 by Sunny Bains.
 # include "btr0sea.h"
 #endif
 #include "buf0flu.h"
+#include "buf0track.h"
 #include "que0que.h"
 #include "dict0boot.h"
 #include "dict0load.h"
@@ -5009,6 +5010,8 @@ row_import_for_mysql(
 	/* Set tablespace purpose as FIL_TYPE_TABLESPACE,
 	so that rollback can go ahead smoothly */
 	table->space->set_imported();
+	/* The pages were written outside the buffer pool. */
+	buf_track.add_space(table->space_id);
 
 	err = lock_sys_tables(trx);
 	if (err != DB_SUCCESS) {
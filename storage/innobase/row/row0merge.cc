@@ -265,6 +265,8 @@ and then stage->inc() will be called for each record that is processed.
 				the given blob file. It is
 				applicable only for bulk insert
 				operation
+@param[in]	update_progress	whether to update
+				innodb_onlineddl_pct_progress
 @return DB_SUCCESS or error number */
 static	MY_ATTRIBUTE((warn_unused_result))
 dberr_t
@@ -281,7 +283,8 @@ row_merge_insert_index_tuples(
 	row_merge_block_t*	crypt_block,
 	ulint			space,
 	ut_stage_alter_t*	stage= nullptr,
-	merge_file_t*		blob_file= nullptr);
+	merge_file_t*		blob_file= nullptr,
+	bool			update_progress= true);
 
 /** Encode an index record.
 @return size of the record */
@@ -3708,7 +3711,8 @@ row_merge_insert_index_tuples(
 	row_merge_block_t*	crypt_block,
 	ulint			space,
 	ut_stage_alter_t*	stage,
-	merge_file_t*		blob_file)
+	merge_file_t*		blob_file,
+	bool			update_progress)
 {
 	const byte*		b;
 	mem_heap_t*		heap;
@@ -3861,7 +3865,7 @@ row_merge_insert_index_tuples(
 
 		/* Increment innodb_onlineddl_pct_progress status variable */
 		inserted_rows++;
-		if(inserted_rows % 1000 == 0) {
+		if (update_progress && inserted_rows % 1000 == 0) {
 			/* Update progress for each 1000 rows */
 			curr_progress = (inserted_rows >= table_total_rows ||
 				table_total_rows <= 0) ?
@@ -4580,6 +4584,128 @@ row_merge_is_index_usable(
 		   || trx->read_view.changes_visible(index->trx_id)));
 }
 
+/** A secondary index that is sorted and loaded by row_merge_build_task() */
+struct row_merge_build_t
+{
+	/** the index */
+	dict_index_t*	index;
+	/** the unsorted index entries */
+	merge_file_t*	file;
+	/** share of the index in the total progress percentage */
+	double		pct_cost;
+	/** outcome of building the index */
+	dberr_t		error;
+};
+
+/** Indexes that are built concurrently by innodb_ddl_threads tasks.
+Each index is built by one task; a single index is never split. */
+struct row_merge_build_ctx_t
+{
+	/** the ALTER TABLE transaction. It is shared by all tasks, which only
+	read trx->id (for PAGE_MAX_TRX_ID in BtrBulk) and check
+	trx_is_interrupted(). Neither changes while the indexes are built,
+	and the tasks do not acquire locks, write undo log or modify
+	any other field of the transaction. */
+	trx_t*			trx;
+	/** table where rows are read from */
+	const dict_table_t*	old_table;
+	/** location of the temporary files */
+	const char*		path;
+	/** tablespace of the indexes */
+	ulint			space;
+	/** progress percentage at the start of the builds */
+	double			pct_progress;
+	/** the indexes */
+	row_merge_build_t*	builds;
+	/** number of elements in builds[] */
+	ulint			n_builds;
+	/** the next element of builds[] to be claimed by a task */
+	Atomic_counter<ulint>	next;
+	/** protects done_cost and the updates of onlineddl_pct_progress */
+	srw_mutex		progress_mutex;
+	/** sum of pct_cost of the completed builds */
+	double			done_cost;
+};
+
+/** Merge sort and bulk load secondary indexes until none are left.
+Only non-unique indexes are built here, because reporting a duplicate key
+would need the TABLE::record[0] of the ALTER TABLE thread.
+@param arg	row_merge_build_ctx_t */
+static void row_merge_build_task(void* arg)
+{
+	row_merge_build_ctx_t*	ctx = static_cast<row_merge_build_ctx_t*>(arg);
+	ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+	ut_new_pfx_t		block_pfx;
+	ut_new_pfx_t		crypt_pfx;
+	row_merge_block_t*	crypt_block = NULL;
+	pfs_os_file_t		tmpfd = OS_FILE_CLOSED;
+	const size_t		block_size = 3 * srv_sort_buf_size;
+	dberr_t			error = DB_SUCCESS;
+
+	row_merge_block_t*	block = alloc.allocate_large(block_size,
+							     &block_pfx);
+	if (block == NULL) {
+		error = DB_OUT_OF_MEMORY;
+	} else if (srv_encrypt_log) {
+		crypt_block = alloc.allocate_large(block_size, &crypt_pfx);
+		if (crypt_block == NULL) {
+			error = DB_OUT_OF_MEMORY;
+		}
+	}
+
+	if (error == DB_SUCCESS
+	    && !row_merge_tmpfile_if_needed(&tmpfd, ctx->path)) {
+		error = DB_OUT_OF_MEMORY;
+	}
+
+	for (ulint i; (i = ctx->next++) < ctx->n_builds; ) {
+		row_merge_build_t&	b = ctx->builds[i];
+
+		if (error != DB_SUCCESS) {
+			b.error = error;
+			continue;
+		}
+
+		ut_ad(!dict_index_is_unique(b.index));
+		row_merge_dup_t	dup = {b.index, NULL, NULL, 0};
+
+		b.error = row_merge_sort(ctx->trx, &dup, b.file, block,
+					 &tmpfd, false, ctx->pct_progress, 0,
+					 crypt_block, ctx->space, NULL);
+
+		if (b.error == DB_SUCCESS) {
+			BtrBulk	btr_bulk(b.index, ctx->trx);
+
+			b.error = row_merge_insert_index_tuples(
+				b.index, ctx->old_table, b.file->fd, block,
+				NULL, &btr_bulk, b.file->n_rec,
+				ctx->pct_progress, b.pct_cost,
+				crypt_block, ctx->space, NULL, NULL, false);
+
+			b.error = btr_bulk.finish(b.error);
+		}
+
+		/* Each task would report the progress of its own index
+		relative to ctx->pct_progress, making the status variable
+		jump back and forth. Report the completed builds instead. */
+		ctx->progress_mutex.wr_lock();
+		ctx->done_cost += b.pct_cost;
+		onlineddl_pct_progress = ulint((ctx->pct_progress
+						+ ctx->done_cost) * 100);
+		ctx->progress_mutex.wr_unlock();
+	}
+
+	row_merge_file_destroy_low(tmpfd);
+
+	if (block) {
+		alloc.deallocate_large(block, &block_pfx);
+	}
+
+	if (crypt_block) {
+		alloc.deallocate_large(crypt_block, &crypt_pfx);
+	}
+}
+
 /** Build indexes on a table by reading a clustered index, creating a temporary
 file containing index entries, merge sorting these index entries and inserting
 sorted index entries to indexes.
@@ -4645,6 +4771,8 @@ row_merge_build_indexes(
 	fts_psort_t*		psort_info = NULL;
 	fts_psort_t*		merge_info = NULL;
 	bool			fts_psort_initiated = false;
+	row_merge_build_t*	builds = NULL;
+	ulint			n_threads;
 
 	double total_static_cost = 0;
 	double total_dynamic_cost = 0;
@@ -4805,7 +4933,94 @@ row_merge_build_indexes(
 	/* Now we have files containing index entries ready for
 	sorting and inserting. */
 
-	for (ulint k = 0, i = 0; i < n_indexes; i++) {
+	n_threads = thd_ddl_threads(trx->mysql_thd);
+
+	if (n_threads > 1) {
+		row_merge_build_ctx_t	ctx;
+		ulint			n = 0;
+
+		builds = static_cast<row_merge_build_t*>(
+			ut_zalloc_nokey(n_merge_files * sizeof *builds));
+
+		for (ulint k = 0, i = 0; i < n_indexes; i++) {
+			if (dict_index_is_spatial(indexes[i])) {
+				continue;
+			}
+
+			if (!(indexes[i]->type & (DICT_FTS | DICT_UNIQUE
+						  | DICT_CLUSTERED))
+			    && merge_files[k].fd != OS_FILE_CLOSED) {
+				builds[n].index = indexes[i];
+				builds[n].file = &merge_files[k];
+				builds[n].pct_cost = (COST_BUILD_INDEX_STATIC
+					+ (total_dynamic_cost
+					   * static_cast<double>(
+						   merge_files[k].offset)
+					   / static_cast<double>(
+						   total_index_blocks)))
+					/ (total_static_cost
+					   + total_dynamic_cost)
+					* (PCT_COST_MERGESORT_INDEX
+					   + PCT_COST_INSERT_INDEX) * 100;
+				n++;
+			}
+
+			k++;
+		}
+
+		n_threads = std::min(n_threads, n);
+
+		if (n_threads < 2) {
+			ut_free(builds);
+			builds = NULL;
+		} else {
+			if (global_system_variables.log_warnings > 2) {
+				sql_print_information(
+					"InnoDB: Online DDL : Start building"
+					" " ULINTPF " indexes with " ULINTPF
+					" threads", n, n_threads);
+			}
+
+			ctx.trx = trx;
+			ctx.old_table = old_table;
+			ctx.path = thd_innodb_tmpdir(trx->mysql_thd);
+			ctx.space = new_table->space_id;
+			ctx.pct_progress = pct_progress;
+			ctx.builds = builds;
+			ctx.n_builds = n;
+			ctx.next = 0;
+			ctx.progress_mutex.init();
+			ctx.done_cost = 0;
+
+			tpool::waitable_task**	tasks
+				= static_cast<tpool::waitable_task**>(
+					ut_malloc_nokey((n_threads - 1)
+							* sizeof *tasks));
+
+			/* This thread is one of the n_threads. */
+			for (j = 0; j < n_threads - 1; j++) {
+				tasks[j] = new tpool::waitable_task(
+					row_merge_build_task, &ctx);
+				srv_thread_pool->submit_task(tasks[j]);
+			}
+
+			row_merge_build_task(&ctx);
+
+			for (j = 0; j < n_threads - 1; j++) {
+				tasks[j]->wait();
+				delete tasks[j];
+			}
+
+			ut_free(tasks);
+			ctx.progress_mutex.destroy();
+
+			for (j = 0; j < n; j++) {
+				pct_progress += builds[j].pct_cost;
+			}
+		}
+	}
+
+	for (ulint k = 0, i = 0, b = 0; i < n_indexes; i++) {
 		dict_index_t*	sort_idx = indexes[i];
 
 		if (dict_index_is_spatial(sort_idx)) {
@@ -4833,6 +5048,9 @@ row_merge_build_indexes(
 #ifdef FTS_INTERNAL_DIAG_PRINT
 			DEBUG_FTS_SORT_PRINT("FTS_SORT: Complete Insert\n");
 #endif
+		} else if (builds && b < n_merge_files
+			   && builds[b].index == indexes[i]) {
+			error = builds[b++].error;
 		} else if (merge_files[k].fd != OS_FILE_CLOSED) {
 			char	buf[NAME_LEN + 1];
 			row_merge_dup_t	dup = {
@@ -4985,6 +5203,8 @@ row_merge_build_indexes(
 		row_merge_file_destroy(&merge_files[i]);
 	}
 
+	ut_free(builds);
+
 	if (fts_sort_idx) {
 		dict_mem_index_free(fts_sort_idx);
 	}
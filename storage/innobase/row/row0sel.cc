@@ -47,6 +47,8 @@ Created 12/19/1997 Heikki Tuuri
 #include "pars0pars.h"
 #include "row0mysql.h"
 #include "buf0lru.h"
+#include "buf0rea.h"
+#include "ha_prototypes.h"
 #include "srv0srv.h"
 #include "srv0mon.h"
 #include "sql_error.h"
@@ -4315,6 +4317,71 @@ bool row_search_with_covering_prefix(
 	return true;
 }
 
+/** Number of secondary index leaf pages to skip after a clustered index
+read-ahead found all the pages in the buffer pool */
+static constexpr uint32_t CLUST_READ_AHEAD_SKIP= 4;
+/** Maximum value of innodb_clustered_read_ahead */
+static constexpr ulint CLUST_READ_AHEAD_MAX= 256;
+
+/** Read ahead the clustered index leaf pages of the records on a secondary
+index leaf page, starting from the record that the cursor is positioned on,
+when the cursor arrives at a new secondary index leaf page.
+@param prebuilt  prebuilt struct for the table handler
+@param index     secondary index
+@param pcur      cursor on a record of index */
+static void row_sel_clust_read_ahead(row_prebuilt_t *prebuilt,
+                                     dict_index_t *index,
+                                     const btr_pcur_t *pcur)
+{
+  ut_ad(!index->is_clust());
+  ut_ad(prebuilt->need_to_access_clustered);
+
+  THD *thd= prebuilt->trx->mysql_thd;
+  const ulint limit= thd ? thd_clustered_read_ahead(thd) : 0;
+  if (!limit || prebuilt->table->is_temporary() || !prebuilt->table->space)
+    return;
+
+  const buf_block_t *block= btr_pcur_get_block(pcur);
+  const uint32_t page_no= block->page.id().page_no();
+  if (page_no == prebuilt->clust_read_ahead_page)
+    return;
+  prebuilt->clust_read_ahead_page= page_no;
+
+  if (prebuilt->clust_read_ahead_skip)
+  {
+    prebuilt->clust_read_ahead_skip--;
+    return;
+  }
+
+  const dict_index_t *clust_index= dict_table_get_first_index(index->table);
+  uint32_t page_nos[CLUST_READ_AHEAD_MAX];
+  const ulint max_recs= std::min<ulint>(limit, CLUST_READ_AHEAD_MAX);
+  mem_heap_t *heap= mem_heap_create(256);
+  ulint n= 0, n_recs= 0;
+  for (const rec_t *rec= btr_pcur_get_rec(pcur);
+       rec && !page_rec_is_supremum(rec) && n_recs < max_recs;
+       rec= page_rec_get_next_const(rec))
+  {
+    if (page_rec_is_infimum(rec))
+      continue;
+    n_recs++;
+    const dtuple_t *ref= row_build_row_ref(ROW_COPY_POINTERS, index,
+                                           rec, heap);
+    const uint32_t leaf= btr_cur_leaf_page_no_hint(*clust_index, *ref);
+    mem_heap_empty(heap);
+    if (leaf == FIL_NULL ||
+        std::find(page_nos, page_nos + n, leaf) != page_nos + n)
+      continue;
+    page_nos[n++]= leaf;
+  }
+  mem_heap_free(heap);
+
+  if (n && !buf_read_ahead_pages(clust_index->table->space_id, page_nos, n,
+                                 clust_index->table->space->zip_size()))
+    /* The data appears to be in the buffer pool already. */
+    prebuilt->clust_read_ahead_skip= CLUST_READ_AHEAD_SKIP;
+}
+
 /** Searches for rows in the database using cursor.
 Function is mainly used for tables that are shared across connections and
 so it employs technique that can help re-construct the rows that
@@ -5502,6 +5569,10 @@ row_search_mvcc(
 
 		mtr_extra_clust_savepoint = mtr.get_savepoint();
 
+		if (moves_up && !spatial_search) {
+			row_sel_clust_read_ahead(prebuilt, index, pcur);
+		}
+
 		ut_ad(!vrow);
 		/* The following call returns 'offsets' associated with
 		'clust_rec'. Note that 'clust_rec' can be an old version
@@ -163,6 +163,10 @@ my_bool	srv_adaptive_flushing;
 /** innodb_flush_sync; whether to ignore io_capacity at log checkpoints */
 my_bool	srv_flush_sync;
 
+/** innodb_track_changed_pages; whether to record the pages written to
+persistent tablespaces for incremental backups */
+my_bool	srv_track_changed_pages;
+
 /** common thread pool*/
 tpool::thread_pool* srv_thread_pool;
 
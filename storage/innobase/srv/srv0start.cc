@@ -47,6 +47,7 @@ Created 2/16/1996 Heikki Tuuri
 #include "buf0buf.h"
 #include "buf0dblwr.h"
 #include "buf0dump.h"
+#include "buf0track.h"
 #include "os0file.h"
 #include "fil0fil.h"
 #include "fil0crypt.h"
@@ -1742,6 +1743,10 @@ dberr_t srv_start(bool create_new_db)
 	ut_ad(err == DB_SUCCESS);
 	ut_a(sum_of_new_sizes != ULINT_UNDEFINED);
 
+	if (!srv_read_only_mode) {
+		buf_track.start(log_sys.get_lsn());
+	}
+
 	/* Create the doublewrite buffer to a new tablespace */
 	if (!srv_read_only_mode && srv_force_recovery < SRV_FORCE_NO_TRX_UNDO
 	    && !buf_dblwr.create()) {
@@ -2023,6 +2028,7 @@ void innodb_shutdown()
 		logs_empty_and_mark_files_at_shutdown();
 	}
 
+	buf_track.close();
 	os_aio_free();
 	fil_space_t::close_all();
 	/* Exit any remaining threads. */
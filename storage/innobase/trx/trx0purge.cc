@@ -42,6 +42,7 @@ Created 3/26/1996 Heikki Tuuri
 #include <mysql/service_thd_mdl.h>
 #include <mysql/service_wsrep.h>
 #include "log.h"
+#include "debug_sync.h"
 
 /** Maximum allowable purge history length.  <=0 means 'infinite'. */
 ulong		srv_max_purge_lag = 0;
@@ -56,6 +57,14 @@ purge_sys_t	purge_sys;
 my_bool		srv_purge_view_update_only_debug;
 #endif /* UNIV_DEBUG */
 
+/** Minimum number of undo log records of a table in a purge batch
+for distributing the records among all purge tasks in the next batch */
+static constexpr ulint TRX_PURGE_SPLIT_MIN_RECS= 256;
+
+/** Number of tables in purge_sys_t::m_table_stats after which
+the statistics of tables that were not covered by a batch are discarded */
+static constexpr size_t TRX_PURGE_TABLE_STATS_MAX= 4096;
+
 /** Build a purge 'query' graph. The actual purge is performed by executing
 this query graph.
 @return own: the query graph */
@@ -109,6 +118,9 @@ void purge_sys_t::create()
   mysql_mutex_init(purge_sys_pq_mutex_key, &pq_mutex, nullptr);
   truncate_undo_space.current= nullptr;
   truncate_undo_space.last= 0;
+  table_stats_latch.init();
+  m_n_batches= 0;
+  m_last_batch_recs= 0;
   m_initialized= true;
 }
 
@@ -129,6 +141,8 @@ void purge_sys_t::close()
   latch.destroy();
   end_latch.destroy();
   mysql_mutex_destroy(&pq_mutex);
+  m_table_stats.clear();
+  table_stats_latch.destroy();
   m_initialized= false;
 }
 
@@ -1054,12 +1068,30 @@ static void trx_purge_close_tables(purge_node_t *node, THD *thd)
     else if (t.second.first == reinterpret_cast<dict_table_t*>(-1));
     else
     {
-      dict_table_close(t.second.first, false, thd, t.second.second);
+      dict_table_close(t.second.first, false, thd,
+                       node->shared_tables.count(t.first)
+                       ? nullptr : t.second.second);
       t.second.first= reinterpret_cast<dict_table_t*>(-1);
     }
   }
 }
 
+/** Let a purge task share a table handle with the task that owns
+the table handle and the meta-data lock.
+@param node   purge task context
+@param id     table identifier
+@param owner  table handle and meta-data lock of the owner */
+static void trx_purge_share_table(purge_node_t *node, table_id_t id,
+                                  const std::pair<dict_table_t*,MDL_ticket*>
+                                  &owner)
+{
+  ut_ad(owner.first);
+  ut_ad(owner.first != reinterpret_cast<dict_table_t*>(-1));
+  owner.first->acquire();
+  node->tables[id]= owner;
+  node->shared_tables.emplace(id);
+}
+
 void purge_sys_t::wait_FTS(bool also_sys)
 {
   bool paused;
@@ -1168,6 +1200,12 @@ dict_table_t *purge_sys_t::close_and_reopen(table_id_t id, THD *thd,
 {
   MDL_context *mdl_context= static_cast<MDL_context*>(thd_mdl_context(thd));
   ut_ad(mdl_context);
+#ifdef ENABLED_DEBUG_SYNC
+  DBUG_EXECUTE_IF("enable_purge_close_and_reopen_sync_point",
+                  debug_sync_set_action
+                  (thd, STRING_WITH_LEN("now SIGNAL purge_close_and_reopen"));
+                  );
+#endif
  retry:
   ut_ad(m_active);
 
@@ -1192,7 +1230,7 @@ dict_table_t *purge_sys_t::close_and_reopen(table_id_t id, THD *thd,
     purge_node_t *node= static_cast<purge_node_t*>(thr->child);
     for (auto &t : node->tables)
     {
-      if (t.second.first)
+      if (t.second.first && !node->shared_tables.count(t.first))
       {
         t.second.first= trx_purge_table_open(t.first, mdl_context,
                                              &t.second.second);
@@ -1206,9 +1244,108 @@ dict_table_t *purge_sys_t::close_and_reopen(table_id_t id, THD *thd,
     }
   }
 
+  /* Share the reopened table handles with the other tasks */
+  for (que_thr_t *thr= UT_LIST_GET_FIRST(purge_sys.query->thrs); thr;
+       thr= UT_LIST_GET_NEXT(thrs, thr))
+  {
+    purge_node_t *node= static_cast<purge_node_t*>(thr->child);
+    for (table_id_t shared : node->shared_tables)
+    {
+      auto &t= node->tables[shared];
+      t.first= nullptr;
+      for (que_thr_t *o= UT_LIST_GET_FIRST(purge_sys.query->thrs); o;
+           o= UT_LIST_GET_NEXT(thrs, o))
+      {
+        purge_node_t *owner= static_cast<purge_node_t*>(o->child);
+        if (owner->shared_tables.count(shared))
+          continue;
+        auto i= owner->tables.find(shared);
+        if (i == owner->tables.end())
+          continue;
+        if (i->second.first)
+        {
+          i->second.first->acquire();
+          t= i->second;
+        }
+        break;
+      }
+    }
+  }
+
   return table;
 }
 
+bool purge_sys_t::is_hot(table_id_t id, ulint n_tasks) const
+{
+  if (n_tasks < 2)
+    return false;
+  /* m_table_stats is only modified by the purge coordinator;
+  no table_stats_latch is needed for reading it here. */
+  auto i= m_table_stats.find(id);
+  return i != m_table_stats.end() && i->second.last_batch == m_n_batches &&
+    i->second.last_batch_recs >= TRX_PURGE_SPLIT_MIN_RECS &&
+    i->second.last_batch_recs * n_tasks > m_last_batch_recs;
+}
+
+void purge_sys_t::update_table_stats(const std::unordered_map
+                                     <table_id_t, batch_table> &tables)
+{
+  if (tables.empty())
+    return;
+
+  const time_t now= time(nullptr);
+  ulint n_recs= 0;
+
+  table_stats_latch.wr_lock();
+  const ulonglong batch= ++m_n_batches;
+
+  for (const auto &t : tables)
+  {
+    if (!t.second.found)
+    {
+      m_table_stats.erase(t.first);
+      continue;
+    }
+
+    n_recs+= t.second.n_recs;
+    table_stats &stats= m_table_stats[t.first];
+    stats.n_recs+= t.second.n_recs;
+    stats.n_batches++;
+    stats.last_batch= batch;
+    stats.last_batch_recs= t.second.n_recs;
+    stats.last_trx_no= t.second.last_trx_no;
+    stats.last_batch_time= now;
+    stats.split= t.second.split;
+  }
+
+  m_last_batch_recs= n_recs;
+
+  /* Forget about tables that were not covered by this batch,
+  so that the statistics of dropped tables will not accumulate. */
+  if (m_table_stats.size() > TRX_PURGE_TABLE_STATS_MAX)
+  {
+    for (auto i= m_table_stats.begin(); i != m_table_stats.end(); )
+    {
+      if (i->second.last_batch == batch)
+        i++;
+      else
+        i= m_table_stats.erase(i);
+    }
+  }
+
+  table_stats_latch.wr_unlock();
+}
+
+std::vector<std::pair<table_id_t, purge_sys_t::table_stats>>
+purge_sys_t::get_table_stats()
+{
+  table_stats_latch.wr_lock();
+  std::vector<std::pair<table_id_t, table_stats>>
+    stats(m_table_stats.begin(), m_table_stats.end());
+  table_stats_latch.wr_unlock();
+  return stats;
+}
+
 /** Run a purge batch.
 @param n_purge_threads	number of purge threads
 @return new purge_sys.head */
@@ -1246,6 +1383,17 @@ trx_purge_attach_undo_recs(ulint n_purge_threads, THD *thd)
 	ut_ad(i == n_purge_threads);
 #endif
 
+	/* The purge nodes, for distributing the records of tables that
+	dominated the previous batch by the PRIMARY KEY. The records of
+	each row will be processed by a single node, in order. */
+	purge_node_t*	nodes[innodb_purge_threads_MAX];
+
+	i = 0;
+	for (thr = UT_LIST_GET_FIRST(purge_sys.query->thrs);
+	     i < n_purge_threads; thr = UT_LIST_GET_NEXT(thrs, thr)) {
+		nodes[i++] = static_cast<purge_node_t*>(thr->child);
+	}
+
 	/* Fetch and parse the UNDO records. The UNDO records are added
 	to a per purge node vector. */
 	thr = UT_LIST_GET_FIRST(purge_sys.query->thrs);
@@ -1254,7 +1402,7 @@ trx_purge_attach_undo_recs(ulint n_purge_threads, THD *thd)
 
 	i = 0;
 
-	std::unordered_map<table_id_t, purge_node_t*>
+	std::unordered_map<table_id_t, purge_sys_t::batch_table>
 		table_id_map(TRX_PURGE_TABLE_BUCKETS);
 	purge_sys.m_active = true;
 
@@ -1287,7 +1435,8 @@ trx_purge_attach_undo_recs(ulint n_purge_threads, THD *thd)
 		table_id_t table_id = trx_undo_rec_get_table_id(
 			purge_rec.undo_rec);
 
-		purge_node_t*& table_node = table_id_map[table_id];
+		purge_sys_t::batch_table& t = table_id_map[table_id];
+		purge_node_t* table_node = t.owner;
 
 		if (!table_node) {
 			std::pair<dict_table_t*,MDL_ticket*> p;
@@ -1305,16 +1454,45 @@ trx_purge_attach_undo_recs(ulint n_purge_threads, THD *thd)
 					purge_sys.query->thrs);
 			}
 
-			table_node = static_cast<purge_node_t*>(thr->child);
+			t.owner = table_node
+				= static_cast<purge_node_t*>(thr->child);
 			ut_a(que_node_get_type(table_node) == QUE_NODE_PURGE);
 			ut_d(auto i=)
 			table_node->tables.emplace(table_id, p);
 			ut_ad(i.second);
 			if (p.first) {
+				t.found = true;
+				t.split = purge_sys.is_hot(table_id,
+							   n_purge_threads);
 				goto enqueue;
 			}
 		} else if (table_node->tables[table_id].first) {
 enqueue:
+			t.n_recs++;
+			t.last_trx_no = purge_sys.tail.trx_no;
+
+			uint32_t fold;
+
+			if (t.split
+			    && trx_undo_rec_get_row_ref_fold(
+				    purge_rec.undo_rec,
+				    *dict_table_get_first_index(
+					    table_node->tables[table_id]
+					    .first),
+				    &fold)) {
+				purge_node_t* node
+					= nodes[fold % n_purge_threads];
+				if (node != table_node) {
+					if (!node->tables.count(table_id)) {
+						trx_purge_share_table(
+							node, table_id,
+							table_node->tables
+							[table_id]);
+					}
+					table_node = node;
+				}
+			}
+
 			table_node->undo_recs.push(purge_rec);
 		}
 
@@ -1325,6 +1503,8 @@ trx_purge_attach_undo_recs(ulint n_purge_threads, THD *thd)
 
 	purge_sys.m_active = false;
 
+	purge_sys.update_table_stats(table_id_map);
+
 	ut_ad(head <= purge_sys.tail);
 
 	return head;
@@ -1441,6 +1621,7 @@ TRANSACTIONAL_TARGET ulint trx_purge(ulint n_tasks, ulint history_size)
 		purge_node_t* node = static_cast<purge_node_t*>(thr->child);
 		trx_purge_close_tables(node, thd);
 		node->tables.clear();
+		node->shared_tables.clear();
 	}
 
 	purge_sys.batch_cleanup(head);
@@ -622,6 +622,44 @@ static const byte *trx_undo_rec_skip_row_ref(const byte *ptr,
 	return(ptr);
 }
 
+/** Compute a hash value of the row reference of an undo log record.
+@param undo_rec  undo log record
+@param index     clustered index of the table
+@param fold      hash value of the PRIMARY KEY or DB_ROW_ID
+@return whether the undo log record refers to a single row */
+bool trx_undo_rec_get_row_ref_fold(const trx_undo_rec_t *undo_rec,
+                                   const dict_index_t &index,
+                                   uint32_t *fold)
+{
+  byte type, cmpl_info;
+  bool updated_extern;
+  undo_no_t undo_no;
+  table_id_t table_id;
+
+  const byte *ptr= trx_undo_rec_get_pars(undo_rec, &type, &cmpl_info,
+                                         &updated_extern, &undo_no,
+                                         &table_id);
+  switch (type) {
+  case TRX_UNDO_INSERT_REC:
+    break;
+  case TRX_UNDO_UPD_EXIST_REC:
+  case TRX_UNDO_UPD_DEL_REC:
+  case TRX_UNDO_DEL_MARK_REC:
+    trx_id_t trx_id;
+    roll_ptr_t roll_ptr;
+    byte info_bits;
+    ptr= trx_undo_update_rec_get_sys_cols(ptr, &trx_id, &roll_ptr,
+                                          &info_bits);
+    break;
+  default:
+    return false;
+  }
+
+  const byte *end= trx_undo_rec_skip_row_ref(ptr, &index);
+  *fold= my_crc32c(0, ptr, size_t(end - ptr));
+  return true;
+}
+
 /** Fetch a prefix of an externally stored column, for writing to the undo
 log of an update or delete marking of a clustered index record.
 @param[out]	ext_buf		buffer to hold the prefix data and BLOB pointer
@@ -26,6 +26,7 @@ Created 2007-03-20 Sunny Bains
 
 #include "ut0rbt.h"
 #include "ut0new.h"
+#include "mem0mem.h"
 
 /**********************************************************************//**
 Definition of a red-black tree
@@ -742,7 +743,12 @@ rbt_free(
 /*=====*/
 	ib_rbt_t*	tree)			/*!< in: rb tree to free */
 {
-	rbt_free_node(tree->root, tree->nil);
+	if (tree->heap) {
+		/* The data nodes are freed with the heap. */
+		ut_free(tree->root);
+	} else {
+		rbt_free_node(tree->root, tree->nil);
+	}
 	ut_free(tree->nil);
 	ut_free(tree);
 }
@@ -757,7 +763,9 @@ rbt_create_arg_cmp(
 	size_t		sizeof_value,		/*!< in: sizeof data item */
 	ib_rbt_arg_compare
 			compare,		/*!< in: fn to compare items */
-	void*		cmp_arg)		/*!< in: compare fn arg */
+	void*		cmp_arg,		/*!< in: compare fn arg */
+	mem_heap_t*	heap)			/*!< in: heap for the data
+						nodes, or NULL */
 {
 	ib_rbt_t*       tree;
 
@@ -766,6 +774,7 @@ rbt_create_arg_cmp(
 	tree = rbt_create(sizeof_value, NULL);
 	tree->cmp_arg = cmp_arg;
 	tree->compare_with_arg = compare;
+	tree->heap = heap;
 
 	return(tree);
 }
@@ -804,6 +813,21 @@ rbt_create(
 	return(tree);
 }
 
+/**********************************************************************//**
+Allocate a data node for the tree.
+@return uninitialized node */
+static
+ib_rbt_node_t*
+rbt_alloc_node(
+/*===========*/
+	ib_rbt_t*	tree)			/*!< in: rb tree */
+{
+	return(static_cast<ib_rbt_node_t*>(
+		tree->heap
+		? mem_heap_alloc(tree->heap, SIZEOF_NODE(tree))
+		: ut_malloc_nokey(SIZEOF_NODE(tree))));
+}
+
 /**********************************************************************//**
 Generic insert of a value in the rb tree.
 @return inserted node */
@@ -818,7 +842,7 @@ rbt_insert(
 	ib_rbt_node_t*	node;
 
 	/* Create the node that will hold the value data. */
-	node = (ib_rbt_node_t*) ut_malloc_nokey(SIZEOF_NODE(tree));
+	node = rbt_alloc_node(tree);
 
 	memcpy(node->value, value, tree->sizeof_value);
 	node->parent = node->left = node->right = tree->nil;
@@ -846,7 +870,7 @@ rbt_add_node(
 	ib_rbt_node_t*	node;
 
 	/* Create the node that will hold the value data */
-	node = (ib_rbt_node_t*) ut_malloc_nokey(SIZEOF_NODE(tree));
+	node = rbt_alloc_node(tree);
 
 	memcpy(node->value, value, tree->sizeof_value);
 	node->parent = node->left = node->right = tree->nil;
@@ -919,7 +943,9 @@ rbt_delete(
 	if (node) {
 		rbt_remove_node_and_rebalance(tree, node);
 
-		ut_free(node);
+		if (!tree->heap) {
+			ut_free(node);
+		}
 		deleted = TRUE;
 	}
 
@@ -928,7 +954,7 @@ rbt_delete(
 
 /**********************************************************************//**
 Remove a node from the rb tree, the node is not free'd, that is the
-callers responsibility.
+callers responsibility, unless it was allocated from tree->heap.
 @return deleted node but without the const */
 ib_rbt_node_t*
 rbt_remove_node(
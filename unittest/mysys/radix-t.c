@@ -0,0 +1,91 @@
+/* Copyright (c) 2024, MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <my_rnd.h>
+#include "tap.h"
+
+#define MAX_ELEMENTS 20000
+
+static size_t key_length;
+
+static int cmp(const void *a, const void *b)
+{
+  return memcmp(*(uchar**) a, *(uchar**) b, key_length);
+}
+
+/*
+  Sort 'elements' random keys with radixsort_msd_for_str_ptr() and check
+  that the result is ordered and is a permutation of the input.
+  'alphabet' limits the byte values, 'prefix' is a number of leading bytes
+  that are the same in all keys.
+*/
+
+static my_bool test_msd_sort(struct my_rnd_struct *rnd, uint elements,
+                             size_t length, uint alphabet, size_t prefix)
+{
+  uchar *data= (uchar*) malloc(elements * length);
+  uchar **keys= (uchar**) malloc(elements * sizeof(uchar*));
+  uchar **sorted= (uchar**) malloc(elements * sizeof(uchar*));
+  uchar **buffer= (uchar**) malloc(elements * sizeof(uchar*));
+  my_bool res= 1;
+  uint i;
+
+  for (i= 0; i < elements * length; i++)
+    data[i]= (i % length) < prefix ? 'p' :
+             (uchar) (my_rnd(rnd) * alphabet);
+  for (i= 0; i < elements; i++)
+    keys[i]= sorted[i]= data + i * length;
+
+  key_length= length;
+  radixsort_msd_for_str_ptr(keys, elements, length, 0, buffer);
+  qsort(sorted, elements, sizeof(uchar*), cmp);
+
+  for (i= 0; i < elements && res; i++)
+    res= !memcmp(keys[i], sorted[i], length);
+
+  /* Every key must still be there exactly once */
+  qsort(keys, elements, sizeof(uchar*), cmp);
+  for (i= 0; i < elements && res; i++)
+    res= keys[i] >= data && keys[i] < data + elements * length &&
+         (i == 0 || keys[i] != keys[i-1]);
+
+  free(data);
+  free(keys);
+  free(sorted);
+  free(buffer);
+  return res;
+}
+
+
+int main(int argc __attribute__((unused)), char *argv[])
+{
+  struct my_rnd_struct rnd;
+  MY_INIT(argv[0]);
+  my_rnd_init(&rnd, 17, 42);
+  plan(7);
+
+  ok(test_msd_sort(&rnd, 1, 8, 256, 0), "single key");
+  ok(test_msd_sort(&rnd, 30, 8, 256, 0), "insertion sort only");
+  ok(test_msd_sort(&rnd, MAX_ELEMENTS, 4, 256, 0), "short keys");
+  ok(test_msd_sort(&rnd, MAX_ELEMENTS, 64, 256, 0), "long keys");
+  ok(test_msd_sort(&rnd, MAX_ELEMENTS, 16, 2, 0), "many duplicates");
+  ok(test_msd_sort(&rnd, MAX_ELEMENTS, 40, 256, 32), "common prefix");
+  ok(test_msd_sort(&rnd, MAX_ELEMENTS, 24, 256, 24), "all keys equal");
+
+  my_end(0);
+  return exit_status();
+}